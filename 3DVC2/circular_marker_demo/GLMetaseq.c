@@ -1,1953 +1,3898 @@
-#define __GLMETASEQ_C__
-#include "GLMetaseq.h"
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-#include <GL/glext.h>
-
-/*=========================================================================
-  ڤΥǤΤͭʥХѿ
-  =========================================================================*/
-
-static TEXTURE_POOL l_texPool[MAX_TEXTURE];		// ƥס
-static int			l_texPoolnum;				// ƥο
-static int			l_GLMetaseqInitialized = 0;	// ե饰
-
-
-/*=========================================================================
-  ڴؿ
-  =========================================================================*/
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-  void	endianConverter(void *addr,unsigned int size);
-  void	TGAHeaderEndianConverter(	STR_TGA_HEAD *tgah );
-  int		IsExtensionSupported( char* szTargetExtension );
-
-  GLuint		mqoSetTexturePool(char *texfile, char *alpfile, unsigned char alpha );
-  void		mqoClearTexturePool();
-  GLubyte*	mqoLoadTextureEx(char *texfile,char *alpfile,int *tex_size,unsigned char alpha);
-  int			mqoLoadFile(MQO_OBJECT *mqoobj,char *filename,double scale,unsigned char alpha);
-  MQO_OBJECT*	mqoCreateList(int num);
-  int			mqoCreateListObject( MQO_OBJECT *obj, int id, char *filename,double scale,unsigned char alpha);
-
-  void mqoCallListObject(MQO_OBJECT object[],int num);
-  void mqoClearObject(MQO_OBJECT object[],int from,int num);
-  void mqoDeleteObject(MQO_OBJECT * object,int num);
-  void mqoGetDirectory(const char *path_file, char *path_dir);
-  void mqoSnormal(glPOINT3f A, glPOINT3f B, glPOINT3f C, glPOINT3f *normal);
-  void mqoReadMaterial(FILE *fp, MQO_MATDATA M[]);
-  void mqoReadVertex(FILE *fp, glPOINT3f V[]);
-  int	 mqoReadBVertex(FILE *fp,glPOINT3f V[]);
-  void mqoReadFace(FILE *fp, MQO_FACE F[]);
-  void mqoReadObject(FILE *fp, MQO_OBJDATA *obj);
-
-  void mqoMakeArray(MQO_MATERIAL *mat, int matpos,MQO_FACE F[], int fnum,glPOINT3f V[],
-		    glPOINT3f N[], double facet, glCOLOR4f *mcol, double scale, unsigned char alpha );
-
-  glPOINT3f *mqoVertexNormal(MQO_OBJDATA *obj);
-
-  void mqoMakePolygon(MQO_OBJDATA *readObj, MQO_OBJECT *mqoobj,
-		      glPOINT3f N[], MQO_MATDATA M[], int n_mat, double scale, unsigned char alpha);
-
-  void mqoMakeObjectsEx(MQO_OBJECT *mqoobj, MQO_OBJDATA obj[], int n_obj, MQO_MATDATA M[],int n_mat,
-			double scale,unsigned char alpha);
-
-#ifdef __cplusplus
-}
-#endif
-
-
-/*=========================================================================
-  ڴؿendianConverter
-  ӡۥǥѴ
-  ڰ
-  addr	ɥ쥹
-  size	
-
-  ۤ͡ʤ
-  =========================================================================*/
-
-void endianConverter(void *addr,unsigned int size)
-{
-  unsigned int pos;
-  char c;
-  if ( size <= 1 ) return;
-  for ( pos = 0; pos < size/2; pos++ ) {
-    c = *(((char *)addr)+pos);
-    *(((char *)addr)+pos) = *(((char *)addr)+(size-1 - pos));
-    *(((char *)addr)+(size-1 - pos)) = c;
-  }
-}
-
-
-/*=========================================================================
-  ڴؿTGAHeaderEndianConverter
-  ӡTGAΥإåΥǥѴ
-  ڰ
-  tgah	TGAΥإå
-
-  ۤ͡ʤ
-  =========================================================================*/
-
-void TGAHeaderEndianConverter(	STR_TGA_HEAD *tgah )
-{
-  endianConverter(&tgah->color_map_entry,sizeof(tgah->color_map_entry));
-  endianConverter(&tgah->x,sizeof(tgah->x));
-  endianConverter(&tgah->y,sizeof(tgah->y));
-  endianConverter(&tgah->width,sizeof(tgah->width));
-  endianConverter(&tgah->height,sizeof(tgah->height));
-}
-
-
-/*=========================================================================
-  ڴؿIsExtensionSupported
-  ӡOpenGLγĥǽݡȤƤ뤫ɤĴ٤
-  ڰ
-  szTargetExtension	ĥǽ̾
-
-  ͡1ݡȤƤ롤0Ƥʤ
-  =========================================================================*/
-
-int IsExtensionSupported( char* szTargetExtension )
-{
-  const unsigned char *pszExtensions = NULL;
-  const unsigned char *pszStart;
-  unsigned char *pszWhere, *pszTerminator;
-
-  // Extension ̾Ĵ٤(NULLNG
-  pszWhere = (unsigned char *) strchr( szTargetExtension, ' ' );
-  if ( pszWhere || *szTargetExtension == (char)NULL )
-    return 0;
-
-  // Extension ʸ
-  pszExtensions = glGetString( GL_EXTENSIONS );
-
-  // ʸɬפ extension 뤫Ĵ٤
-  pszStart = pszExtensions;
-  for (;;)
-    {
-      pszWhere = (unsigned char *) strstr( (const char *) pszStart, szTargetExtension );
-      if ( !pszWhere )
-	break;
-      pszTerminator = pszWhere + strlen( szTargetExtension );
-      if ( pszWhere == pszStart || *( pszWhere - 1 ) == ' ' )
-	if ( *pszTerminator == ' ' || *pszTerminator == (char)NULL )
-	  return 1;
-      pszStart = pszTerminator;
-    }
-  return 0;
-}
-
-
-/*=========================================================================
-  ڴؿmqoInit
-  ӡۥ᥿ν
-  ڰۤʤ
-  ۤ͡ʤ
-  =========================================================================*/
-
-void mqoInit(void)
-{
-  // ƥס
-  memset(l_texPool,0,sizeof(l_texPool));
-  l_texPoolnum = 0;
-
-  // ĺХåեΥݡȤΥå
-#if 0
-  g_isVBOSupported = IsExtensionSupported("GL_ARB_vertex_buffer_object");
-#else
-  g_isVBOSupported = 0;
-#endif  
-
-#ifdef WIN32
-  glGenBuffersARB = NULL;
-  glBindBufferARB = NULL;
-  glBufferDataARB = NULL;
-  glDeleteBuffersARB = NULL;
-
-  if ( g_isVBOSupported ) {
-    // printf("OpenGL : ĺХåե򥵥ݡȤƤΤǻѤޤ\n");
-    // GL ؿΥݥ󥿤
-    glGenBuffersARB = (PFNGLGENBUFFERSARBPROC) wglGetProcAddress("glGenBuffersARB");
-    glBindBufferARB = (PFNGLBINDBUFFERARBPROC) wglGetProcAddress("glBindBufferARB");
-    glBufferDataARB = (PFNGLBUFFERDATAARBPROC) wglGetProcAddress("glBufferDataARB");
-    glDeleteBuffersARB = (PFNGLDELETEBUFFERSARBPROC) wglGetProcAddress("glDeleteBuffersARB");
-  }
-#endif
-
-  // ե饰
-  l_GLMetaseqInitialized = 1;
-}
-
-
-/*=========================================================================
-  ڴؿmqoCleanup
-  ӡۥ᥿νλ
-  ڰۤʤ
-  ۤ͡ʤ
-  =========================================================================*/
-
-void mqoCleanup(void)
-{
-  mqoClearTexturePool();	// ƥסΥꥢ
-}
-
-
-/*=========================================================================
-  ڴؿmqoSetTexturePool
-  ӡۥƥס˥ƥɤ߹
-  ڰ
-  texfile		ƥե̾
-  alpfile		եե̾
-  alpha		ե
-
-  ͡ۥƥID
-  ڻ͡ۥƥ㤬ޤɤ߹ޤƤʤɤ߹ߡƥϿ
-  Ǥɤ߹ޤƤϿΤ֤.
-  =========================================================================*/
-
-GLuint mqoSetTexturePool(char *texfile, char *alpfile, unsigned char alpha ) 
-{
-  int pos;
-  GLubyte *image;
-
-  for ( pos = 0; pos < l_texPoolnum; pos++ ) {
-    if ( alpha != l_texPool[pos].alpha ) {
-      continue;
-    }
-    if ( texfile != NULL ) {
-      if ( strcmp(texfile,l_texPool[pos].texfile) != 0 ) {
-	continue;
-      }
-    }
-    if ( alpfile != NULL ) {
-      if ( strcmp(alpfile,l_texPool[pos].alpfile) != 0 ) {
-	continue;
-      }
-    }
-    break;
-  }
-  if ( pos < l_texPoolnum ) { //Ǥɤ߹ߺѤ
-    return  l_texPool[pos].texture_id;
-  }
-  if ( MAX_TEXTURE <= pos ) {
-    printf("%s:mqoSetTexturePool ƥɤ߹ΰ­\n",__FILE__);
-    return -1;
-  }
-  image = mqoLoadTextureEx(texfile,alpfile,&l_texPool[pos].texsize,alpha);
-  if ( image == NULL ) {
-    return -1;
-  }
-
-  if ( texfile != NULL ) strncpy(l_texPool[pos].texfile,texfile,MAX_PATH);
-  if ( alpfile != NULL ) strncpy(l_texPool[pos].alpfile,alpfile,MAX_PATH);
-  l_texPool[pos].alpha = alpha;
-
-  glPixelStorei(GL_UNPACK_ALIGNMENT,4);
-  glPixelStorei(GL_PACK_ALIGNMENT,4);
-  glGenTextures(1,&l_texPool[pos].texture_id);			// ƥ
-  glBindTexture(GL_TEXTURE_2D,l_texPool[pos].texture_id);	// ƥγ
-
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, l_texPool[pos].texsize, l_texPool[pos].texsize,
-	       0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-  l_texPoolnum = pos+1;
-
-  //ϿСɤ߹Хåե
-  free(image);
-  glBindTexture(GL_TEXTURE_2D,0);	// ǥեȥƥγ
-
-  return l_texPool[pos].texture_id;
-}
-
-
-/*=========================================================================
-  ڴؿmqoClearTexturePool()
-  ӡۥƥסγ
-  ڰۤʤ
-  ۤ͡ʤ
-  =========================================================================*/
-
-void mqoClearTexturePool()
-{
-  int pos;
-  for ( pos = 0; pos < l_texPoolnum; pos++ ) {
-    glDeleteTextures(1, &l_texPool[pos].texture_id);	// ƥ
-  }
-
-  memset(l_texPool,0,sizeof(l_texPool));
-  l_texPoolnum = 0;
-}
-
-
-/*=========================================================================
-  ڴؿmqoLoadTextureEx
-  ӡۥե뤫ƥ
-  ڰ
-  texfile		ե̾
-  alpfile		եե̾
-  tex_size	ƥΥʰդĹˤ֤
-
-  ͡ۥƥؤΥݥ󥿡ʼԻNULL
-  ڻ͡24bitӥåȥޥåס8,24,32bitԣǣ
-  ϡְդ2nפ˸
-  libjpeg,libpngʳ饤֥ˤͭJPEG,PNGɤ߹߲ǽ
-  =========================================================================*/
-
-GLubyte* mqoLoadTextureEx(char *texfile,char *alpfile,int *tex_size,unsigned char alpha)
-{
-  FILE *fp;
-  size_t namelen;
-  char ext[4];
-  char wbuf[3];
-  int isTGA;
-  int isPNG;
-  int isJPEG;
-  int other;
-  int	y,x,size;
-  int fl;
-  char *filename[2];
-  int width[2];
-  int sts;
-  STR_TGA_HEAD tgah;
-  GLubyte	*pImage, *pRead;
-
-#if DEF_USE_LIBJPEG
-  struct jpeg_decompress_struct cinfo;
-  struct jpeg_error_mgr jerr;
-  JSAMPARRAY jpegimage;
-#endif
-#if DEF_USE_LIBPNG
-  unsigned char **pngimage;
-#if 0  
-  unsigned long   pngwidth, pngheight;
-#else
-  png_uint_32	pngwidth, pngheight;
-#endif
-  int				pngdepth;
-  int             color_type;
-#endif
-
-  filename[0] = texfile;
-  filename[1] = alpfile;
-  width[0] = -1;
-  width[1] = -1;
-  pImage = NULL;
-  fp = NULL;
-  sts = 0;
-#if DEF_USE_LIBJPEG
-  jpegimage = NULL;
-#endif
-#if DEF_USE_LIBPNG
-  pngimage = NULL;
-#endif
-  size = - 1;
-  for ( fl = 0; fl < 2; fl++ ) {//ƥfl=0    եfl=1
-    if ( filename[fl] == NULL ) continue;
-    namelen = strlen(filename[fl]);
-    ext[0] = tolower(filename[fl][namelen-3]);
-    ext[1] = tolower(filename[fl][namelen-2]);
-    ext[2] = tolower(filename[fl][namelen-1]);
-    ext[3] = 0x00;
-    isTGA = (strcmp(ext,"tga")==0)?1:0;
-    isPNG = (strcmp(ext,"png")==0)?1:0;
-    isJPEG = (strcmp(ext,"jpg")==0)?1:0;
-    /* */
-    if ( (! isTGA) && (! isPNG) &&(! isJPEG) ) {
-      filename[fl][namelen-3] = 'b';
-      filename[fl][namelen-2] = 'm';
-      filename[fl][namelen-1] = 'p';
-    }
-    /* */
-    if ( fl == 1 ) { //եɤ߹ߤϣԣǣorУΣ
-      if ( ! (isTGA || isPNG) ) {
-	printf("եΥեбǤʤ%s\n",filename[fl]);
-	break;
-      }
-    }
-    if ( fp != NULL ) fclose(fp);
-    if ( (fp=fopen(filename[fl],"rb"))==NULL ) {
-      printf("%s:ƥɤ߹ߥ顼[%s]\n",__FILE__,filename[fl]);
-      continue;
-    }
-    // إåΥ
-    if ( isTGA ) {
-      fread(&tgah,sizeof(STR_TGA_HEAD),1,fp);
-#if DEF_IS_LITTLE_ENDIAN
-#else
-      TGAHeaderEndianConverter(&tgah);
-#endif
-      size = width[fl] = tgah.width;
-    }
-    if ( isJPEG ) {
-#if DEF_USE_LIBJPEG
-      unsigned int i;
-      cinfo.err = jpeg_std_error( &jerr );
-      jpeg_create_decompress( &cinfo );	//Ѿ
-      jpeg_stdio_src( &cinfo, fp );		//ɤ߹ߥե
-      jpeg_read_header( &cinfo, TRUE );	//jpegإåɤ߹
-      jpeg_start_decompress( &cinfo );	//೫
-
-      if ( cinfo.out_color_components == 3 && cinfo.out_color_space == JCS_RGB ) {
-	if ( jpegimage != NULL ) {
-	  for (i = 0; i < cinfo.output_height; i++) free(jpegimage[i]);            // ʲԤϣޤ
-	  free(jpegimage);
-	}
-	//ɤ߹ߥǡκ
-	jpegimage = (JSAMPARRAY)malloc( sizeof( JSAMPROW ) * cinfo.output_height );
-	for ( i = 0; i < cinfo.output_height; i++ ) {
-	  jpegimage[i] = (JSAMPROW)malloc( sizeof( JSAMPLE ) * cinfo.out_color_components * cinfo.output_width );
-	}
-	//ǡɤ߹
-	while( cinfo.output_scanline < cinfo.output_height ) {
-	  jpeg_read_scanlines( &cinfo,
-			       jpegimage + cinfo.output_scanline,
-			       cinfo.output_height - cinfo.output_scanline
-			       );
-	}
-	size = width[fl] = cinfo.output_width;
-      }
-
-      jpeg_finish_decompress( &cinfo );	//ཪλ
-      jpeg_destroy_decompress( &cinfo );	//Ѿ
-      if ( !(cinfo.out_color_components == 3 && cinfo.out_color_space == JCS_RGB) ) {
-	printf("JPEG бǤʤեޥåȢ%s\n",filename[fl]);
-      }
-#else
-      printf("ΥƥбǤʤեޥåȢ%s\n",filename[fl]);
-      continue;
-#endif
-    }
-    if ( isPNG ) {
-#if DEF_USE_LIBPNG
-      png_structp     png_ptr;
-      png_infop       info_ptr;
-      int             bit_depth, interlace_type;
-      unsigned int             i;
-      int j,k;
-      png_ptr = png_create_read_struct(                       // png_ptr¤Τݡޤ
-				       PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-      info_ptr = png_create_info_struct(png_ptr);             // info_ptr¤Τݡޤ
-      png_init_io(png_ptr, fp);                               // libpngfpΤ餻ޤ
-      png_read_info(png_ptr, info_ptr);                       // PNGեΥإåɤ߹ߤޤ
-      png_get_IHDR(png_ptr, info_ptr, &pngwidth, &pngheight,        // IHDR󥯾ޤ
-		   &bit_depth, &color_type, &interlace_type,
-		   &j,&k);
-      if ( pngimage != NULL ) {
-	for (i = 0; i < pngheight; i++) free(pngimage[i]);            // ʲԤϣޤ
-	free(pngimage);
-      }
-      pngimage = (png_bytepp)malloc(pngheight * sizeof(png_bytep)); // ʲԤϣݤޤ
-      i = png_get_rowbytes(png_ptr, info_ptr);
-      pngdepth = i / pngwidth;
-      for (i = 0; i < pngheight; i++)
-	pngimage[i] = (png_bytep)malloc(png_get_rowbytes(png_ptr, info_ptr));
-      png_read_image(png_ptr, pngimage);                         // ǡɤ߹ߤޤ
-
-      png_destroy_read_struct(                                // Ĥι¤ΤΥޤ
-			      &png_ptr, &info_ptr, (png_infopp)NULL);
-      size = width[fl] = pngwidth;
-#else
-      printf("ΥƥбǤʤեޥåȢ%s\n",filename[fl]);
-      continue;
-#endif
-    }
-    if ( width[fl] == -1 ) {//ޤǤƥꤵƤʤᡡӥåȥޥå
-      fseek(fp,14+4,SEEK_SET);		// ǼƤ֤ޤǥ
-      fread(&size,sizeof(int),1,fp);	// BiWidthξ
-      fseek(fp,14+40,SEEK_SET);		// ǥǡǼƤ֤ޤǥ
-#if DEF_IS_LITTLE_ENDIAN
-#else
-      endianConverter(&size,sizeof(int));
-#endif
-      width[fl] = size;
-
-    }
-    if ( width[0] != -1 && width[1] != -1 ) {
-      if ( width[0] != width[1] ) {
-	sts = -1;
-	break;
-      }
-    }
-    if ( fl == 1 && isTGA ) { //եɤ߹ߤϣԣǣΣӥåȥΥ򣳣ӥåȥե
-      if ( !(
-	     (tgah.depth == 8 && tgah.type == DEF_TGA_TYPE_MONO) ||
-	     (tgah.depth == 32 && tgah.type == DEF_TGA_TYPE_FULL) 
-	     ) ) {
-	break;
-      }
-    }
-    if ( fl == 1 && isPNG ) { //եɤ߹ߤϣУΣǤΥȥ롼顼ܥե򥰥졼ܥե
-#if DEF_USE_LIBPNG
-      if ( !(
-	     (color_type== 6 ) ||
-	     (color_type== 4 ) 
-	     ) ) {
-	break;
-      }
-#endif
-    }
-
-    // γ
-    if ( pImage == NULL ) {
-      pImage = (GLubyte*)malloc(sizeof(unsigned char)*size*size*4);
-    }
-    if (pImage==NULL) return NULL;
-    for (y=0; y<size; y++){
-      pRead = pImage + (size-1-y)*4*size;
-      for (x=0; x<size; x++) {
-	other = 1;
-	if ( fl == 0 ) {
-	  if ( isJPEG ) {
-#if DEF_USE_LIBJPEG
-	    pRead[0]= jpegimage[size-1-y][x*3];
-	    pRead[1]= jpegimage[size-1-y][x*3+1];
-	    pRead[2]= jpegimage[size-1-y][x*3+2];
-	    pRead[3] = alpha;				// A
-	    other = 0;
-#endif
-	  }
-	  if ( isPNG ) {
-#if DEF_USE_LIBPNG
-	    if ( color_type == 2 || color_type==6 ) { 
-	      pRead[0]= pngimage[size-1-y][x*pngdepth];
-	      pRead[1]= pngimage[size-1-y][x*pngdepth+1];
-	      pRead[2]= pngimage[size-1-y][x*pngdepth+2];
-	      pRead[3] = alpha;				// A
-	      if ( color_type == 6 ) {
-		pRead[3]= pngimage[size-1-y][x*pngdepth+3];
-	      }
-	    }
-	    other = 0;
-#endif
-	  }
-	  if ( other )  {
-	    fread(&pRead[2],1,1,fp);	// B
-	    fread(&pRead[1],1,1,fp);	// G	
-	    fread(&pRead[0],1,1,fp);	// R
-	    pRead[3] = alpha;				// A
-	    if ( isTGA && tgah.depth == 32 ) {
-	      fread(&pRead[3],1,1,fp);	// A
-	      if ( alpha < pRead[3] ) pRead[3] = alpha;
-	    }
-	  }
-	}
-	else {
-	  if ( isPNG ) {
-#if DEF_USE_LIBPNG
-	    if ( color_type == 6 ) { //ȥ롼顼ܥե
-	      pRead[3]= pngimage[size-1-y][x*pngdepth+3];
-	    }
-	    if ( color_type == 4 ) { //졼ܥե
-	      pRead[3]= pngimage[size-1-y][x*pngdepth+1];
-	    }
-	    if ( alpha < pRead[3] ) pRead[3] = alpha;
-#endif
-	  }
-	  if ( isTGA ) {
-	    if ( tgah.depth == 32 ) { //ʤǡɤФ
-	      fread(wbuf,3,1,fp);	// BGR
-	    }
-	    fread(&pRead[3],1,1,fp);	// A
-	    if ( alpha < pRead[3] ) pRead[3] = alpha;
-	  }
-	}
-	pRead+=4;
-      }
-    }
-    fclose(fp);
-    fp = NULL;
-  }
-  if ( sts != 0 ) {
-    if ( pImage != NULL ) free(pImage);
-    if ( fp != NULL ) fclose(fp);
-  }
-#if DEF_USE_LIBPNG
-  if ( pngimage != NULL ) {
-    unsigned int uy;
-    for (uy = 0; uy < pngheight; uy++) free(pngimage[uy]);            // ʲԤϣޤ
-    free(pngimage);
-  }
-#endif
-#if DEF_USE_LIBJPEG
-  if ( jpegimage != NULL ) {
-    unsigned int uy;
-    for (uy = 0; uy < cinfo.output_height; uy++) free(jpegimage[uy]);            // ʲԤϣޤ
-    free(jpegimage);
-  }
-#endif
-  if ( size < 0 ) {
-    if ( pImage != NULL ) free(pImage);
-    pImage = NULL;
-  }
-  *tex_size = size;
-
-  return pImage;
-}
-
-
-/*=========================================================================
-  ڴؿmqoLoadFile
-  ӡۥ᥿ե(*.mqo)ǡɤ߹
-  ڰ
-  mqoobj		MQO֥
-  filename	եΥѥ
-  scale		Ψ
-  alpha		ե
-
-  ͡1  ԡ0
-  =========================================================================*/
-
-int mqoLoadFile( MQO_OBJECT *mqoobj, char *filename, double scale, unsigned char alpha)
-{
-  FILE			*fp;
-  MQO_OBJDATA		obj[MAX_OBJECT];
-  MQO_MATDATA		*M = NULL;
-
-  char	buf[SIZE_STR];		// ʸɤ߹ߥХåե
-  char	path_dir[SIZE_STR];	// ǥ쥯ȥΥѥ
-  char	path_tex[SIZE_STR];	// ƥեΥѥ
-  char	path_alp[SIZE_STR];	// եƥեΥѥ
-  int		n_mat = 0;			// ޥƥꥢ
-  int		n_obj = 0;			// ֥ȿ
-  int		i;
-
-  // MaterialObjectɤ߹
-  fp = fopen(filename,"rb");
-  if (fp==NULL) return 0;
-
-  mqoobj->alpha = alpha;
-  memset(obj,0,sizeof(obj));
-
-  i = 0;
-  while ( !feof(fp) ) {
-    fgets(buf,SIZE_STR,fp);
-
-    // Material
-    if (strstr(buf,"Material")) {
-      sscanf(buf,"Material %d", &n_mat);
-      M = (MQO_MATDATA*) calloc( n_mat, sizeof(MQO_MATDATA) );
-      mqoReadMaterial(fp,M);
-    }
-
-    // Object
-    if (strstr(buf,"Object")) {
-      sscanf(buf,"Object %s", obj[i].objname);
-      mqoReadObject(fp, &obj[i]);
-      i++;
-    }
-  }
-  n_obj = i;
-  fclose(fp);
-
-  // ѥμ
-  mqoGetDirectory(filename, path_dir);
-
-  // ƥϿ
-  for (i=0; i<n_mat; i++) {
-    if (M[i].useTex) {
-
-      if (strstr(M[i].texFile,":")) {
-	strcpy(path_tex, M[i].texFile);	// Хѥξ
-      } else {
-	sprintf(path_tex,"%s%s",path_dir,M[i].texFile);	// Хѥξ
-      }
-
-      if ( M[i].alpFile[0] != (char)0 ) {
-	if (strstr(M[i].texFile,":")) {
-	  strcpy(path_alp, M[i].alpFile);	// Хѥξ
-	} else {
-	  sprintf(path_alp,"%s%s",path_dir,M[i].alpFile);	// Хѥξ
-	}
-	M[i].texName = mqoSetTexturePool(path_tex,path_alp,alpha);
-      }
-      else {
-	M[i].texName = mqoSetTexturePool(path_tex,NULL,alpha);
-      }
-    }
-  }
-
-  mqoMakeObjectsEx( mqoobj, obj, n_obj, M, n_mat, scale, alpha );
-
-  // ֥ȤΥǡγ
-  for (i=0; i<n_obj; i++) {
-    free(obj[i].V);
-    free(obj[i].F);
-  }
-
-  // ޥƥꥢγ
-  free(M);
-
-  return 1;
-}
-
-
-/*=========================================================================
-  ڴؿmqoCreateList
-  ӡMQO֥Ȥݤ
-  ڰnum		MQO֥Ȥο
-
-  ͡MQO֥
-  =========================================================================*/
-
-MQO_OBJECT* mqoCreateList(int num)
-{
-  MQO_OBJECT *obj;
-
-  // Ƥʤä
-  if ( ! l_GLMetaseqInitialized ) mqoInit();
-
-  // ΰݤȽ
-  obj = (MQO_OBJECT *)malloc(sizeof(MQO_OBJECT)*num);
-  memset(obj, 0, sizeof(MQO_OBJECT)*num);
-
-  return obj;
-}
-
-
-/*=========================================================================
-  ڴؿmqoCreateListObject
-  ӡۥ᥿ե(*.mqo)MQO֥
-
-  ڰmqoobj		MQO֥
-  i			ɤ߹ֹiܤMQOեɤ߹
-  filename	եΥѥ
-  scale		Ψ
-  alpha		եΤΥեͤ0255ˡ
-
-  ͡ۥơ顧۾
-  =========================================================================*/
-
-int mqoCreateListObject(MQO_OBJECT *mqoobj, int i, char *filename, double scale, unsigned char alpha )
-{
-  int ret;
-  ret = 0;
-  if ( mqoobj == (MQO_OBJECT *)NULL ) return -1;
-  if (! mqoLoadFile(&mqoobj[i], filename, scale, alpha)) ret = -1; 
-  return ret;
-}
-
-
-/*=========================================================================
-  ڴؿmqoCallListObject
-  ӡMQO֥ȤOpenGLβ̾˸ƤӽФ
-  ڰ
-  mqoobj		MQO֥
-  num			ֹ (0
-
-  ۤ͡ʤ
-  =========================================================================*/
-
-void mqoCallListObject(MQO_OBJECT mqoobj[],int num)
-{
-
-  MQO_INNER_OBJECT	*obj;
-  MQO_MATERIAL		*mat;
-  GLfloat				matenv[4];
-  GLint				bindGL_TEXTURE_2D	= 0;
-  GLboolean			isGL_TEXTURE_2D		= GL_FALSE;
-  GLboolean			isGL_BLEND			= GL_FALSE;
-  GLint				blendGL_SRC_ALPHA	= 0;
-  GLint				intFrontFace;
-
-  int		o, m, offset;
-  double	dalpha;
-  char	*base;
-
-  if ( mqoobj == NULL) return;
-
-  glPushMatrix();
-  //᥿ĺ¤Ӥɽ̤ߤƱ
-  glGetIntegerv(GL_FRONT_FACE,&intFrontFace);
-  glFrontFace(GL_CW);
-  dalpha = (double)mqoobj[num].alpha/(double)255;
-
-  for ( o=0; o<mqoobj[num].objnum; o++ ) {	// ֥ȥ롼
-
-    obj = &mqoobj[num].obj[o];
-    if ( ! obj->isVisible ) continue;
-    glShadeModel(((obj->isShadingFlat))?GL_FLAT:GL_SMOOTH);
-
-    for ( m = 0; m < obj->matnum; m++ ) {	//ޥƥꥢ롼
-
-      mat = &obj->mat[m];
-      if ( mat->datanum == 0 ) continue;
-
-      if ( mat->isValidMaterialInfo ) {	// ޥƥꥢξ
-	memcpy(matenv,mat->dif,sizeof(matenv));
-	matenv[3] *= dalpha;
-	glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, matenv);
-	memcpy(matenv,mat->amb,sizeof(matenv));
-	matenv[3] *= dalpha;
-	glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, matenv);
-	memcpy(matenv,mat->spc,sizeof(matenv));
-	matenv[3] *= dalpha;
-	glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, matenv);
-	memcpy(matenv,mat->emi,sizeof(matenv));
-	matenv[3] *= dalpha;
-	glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, matenv);
-	glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, mat->power);
-      }
-
-      if ( mat->isUseTexture) {	// ƥ㤬
-	glEnableClientState( GL_VERTEX_ARRAY );
-	glEnableClientState( GL_NORMAL_ARRAY );
-	glEnableClientState( GL_TEXTURE_COORD_ARRAY );
-
-	isGL_TEXTURE_2D = glIsEnabled(GL_TEXTURE_2D);
-	isGL_BLEND = glIsEnabled(GL_BLEND);
-	glGetIntegerv(GL_TEXTURE_BINDING_2D,&bindGL_TEXTURE_2D);
-	//					glGetIntegerv(GL_BLEND_SRC_ALPHA,&blendGL_SRC_ALPHA);
-
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-
-	glBindTexture(GL_TEXTURE_2D,mat->texture_id);
-
-	if ( g_isVBOSupported ) {	// ĺХåե
-	  base = (char *)NULL;	// ɥ쥹NULLƬ
-#if 0
-	  glBindBufferARB( GL_ARRAY_BUFFER_ARB, mat->VBO_id ); // ĺХåեӤĤ
-#endif	  
-	}
-	else {
-	  // ĺλϡɥ쥹򤽤Τޤ
-	  base = (char *)mat->vertex_t[0].point;
-	}
-
-	// ĺ
-	offset = (int)( (char *)mat->vertex_t[0].point - (char *)mat->vertex_t[0].point );
-	glVertexPointer( 3, GL_FLOAT, sizeof(VERTEX_TEXUSE) , base + offset );
-
-	// ƥɸ
-	offset = (int)((char *)mat->vertex_t[0].uv-(char *)mat->vertex_t[0].point);
-	glTexCoordPointer( 2, GL_FLOAT, sizeof(VERTEX_TEXUSE) , base + offset );
-
-	// ˡ
-	offset = (int)((char *)mat->vertex_t[0].normal-(char *)mat->vertex_t[0].point);
-	glNormalPointer( GL_FLOAT, sizeof(VERTEX_TEXUSE) , base+offset );
-
-	// 
-	glColor4f(mat->color[0],mat->color[1],mat->color[2],mat->color[3]);
-
-	// ¹
-	glDrawArrays( GL_TRIANGLES, 0, mat->datanum );
-
-	glBindTexture(GL_TEXTURE_2D,bindGL_TEXTURE_2D);
-	if( isGL_BLEND == GL_FALSE ) glDisable(GL_BLEND);
-	if( isGL_TEXTURE_2D == GL_FALSE ) glDisable(GL_TEXTURE_2D);
-
-	if ( g_isVBOSupported ) {						// ĺХåե
-#if 0	  
-	  glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );	// ĺХåեǥեȤ
-#endif	  
-	}
-
-	glDisableClientState( GL_VERTEX_ARRAY );
-	glDisableClientState( GL_NORMAL_ARRAY );
-	glDisableClientState( GL_TEXTURE_COORD_ARRAY );
-      }
-      else {	// ƥ㤬ʤ
-
-	glEnableClientState( GL_VERTEX_ARRAY );
-	glEnableClientState( GL_NORMAL_ARRAY );
-	//	glEnableClientState( GL_COLOR_ARRAY );
-
-	isGL_BLEND = glIsEnabled(GL_BLEND);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-
-	if ( g_isVBOSupported ) {	// ĺХåե
-	  base = (char *)NULL;
-#if 0	  
-	  glBindBufferARB( GL_ARRAY_BUFFER_ARB, mat->VBO_id );
-#endif	  
-	}
-	else {
-	  base = (char *)mat->vertex_p[0].point;
-	}
-
-	// ĺ
-	offset = (int)((char *)mat->vertex_p[0].point-(char *)mat->vertex_p[0].point);
-	glVertexPointer( 3, GL_FLOAT, sizeof(VERTEX_NOTEX) , base+offset );
-
-	// ˡ
-	offset = (int)((char *)mat->vertex_p[0].normal-(char *)mat->vertex_p[0].point);
-	glNormalPointer( GL_FLOAT, sizeof(VERTEX_NOTEX) , base+offset );
-
-	// 
-	glColor4f(mat->color[0],mat->color[1],mat->color[2],mat->color[3]);
-	//	offset = (int)((char *)mat->vertex_p[0].color-(char *)mat->vertex_p[0].point);
-	//	glColorPointer(4,GL_FLOAT,sizeof(VERTEX_NOTEX),base+offset);
-
-	// ¹
-	glDrawArrays( GL_TRIANGLES, 0, mat->datanum );
-
-	if( isGL_BLEND == GL_FALSE ) glDisable(GL_BLEND);
-	if ( g_isVBOSupported ) {						// ĺХåե
-#if 0	  
-	  glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );	// ĺХåեǥեȤ
-#endif
-	}
-
-	//	glDisableClientState( GL_COLOR_ARRAY );
-	glDisableClientState( GL_VERTEX_ARRAY );
-	glDisableClientState( GL_NORMAL_ARRAY );
-
-      }
-    }
-  }
-
-  //᥿ĺ¤Ӥɽ̤ߤƱʸˤɤ
-  glFrontFace(intFrontFace);
-  glPopMatrix();
-}
-
-
-/*=========================================================================
-  ڴؿmqoGetDirectory
-  ӡۥե̾ޤѥʸ󤫤ǥ쥯ȥΥѥΤߤФ
-  ڰ
-  *path_file	ե̾ޤѥʸϡ
-  *path_dir	ե̾ѥʸʽϡ
-
-  ۤ͡ʤ
-  ڻ͡㡧
-  "C:/data/file.bmp"  "C:/data/"
-  "data/file.mqo"     "data/"
-  =========================================================================*/
-
-void mqoGetDirectory(const char *path_file, char *path_dir)
-{
-  char *pStr;
-  int len;
-
-  pStr = (char*) MY_MAX( strrchr(path_file,'\\'), strrchr(path_file,'/') );
-  len = MY_MAX((int)(pStr-path_file)+1,0);
-  strncpy(path_dir,path_file,len);
-  path_dir[len] = (char)0;
-}
-
-
-/*=========================================================================
-  ڴؿmqoSnormal
-  ӡˡ٥ȥ
-  ڰ
-  A		3ɸA
-  B		3ɸB
-  C		3ɸC
-  *normal	٥ȥBAȥ٥ȥBCˡ٥ȥʱͤ
-
-  ۤ͡ʤ
-  ڻ͡ۥ᥿ˤ̤ĺֹϡɽ̤鸫
-  ײ˵ҤƤ롥ĤޤꡤĺA,B,C äȤ
-  ٤ˡBABCγѤˤäƵ
-  =========================================================================*/
-
-void mqoSnormal(glPOINT3f A, glPOINT3f B, glPOINT3f C, glPOINT3f *normal)
-{
-  double norm;
-  glPOINT3f vec0,vec1;
-
-  // ٥ȥBA
-  vec0.x = A.x - B.x; 
-  vec0.y = A.y - B.y;
-  vec0.z = A.z - B.z;
-
-  // ٥ȥBC
-  vec1.x = C.x - B.x;
-  vec1.y = C.y - B.y;
-  vec1.z = C.z - B.z;
-
-  // ˡ٥ȥ
-  normal->x = vec0.y * vec1.z - vec0.z * vec1.y;
-  normal->y = vec0.z * vec1.x - vec0.x * vec1.z;
-  normal->z = vec0.x * vec1.y - vec0.y * vec1.x;
-
-  // 
-  norm = normal->x * normal->x + normal->y * normal->y + normal->z * normal->z;
-  norm = sqrt ( norm );
-
-  normal->x /= norm;
-  normal->y /= norm;
-  normal->z /= norm;
-}
-
-
-/*=========================================================================
-  ڴؿmqoReadMaterial
-  ӡۥޥƥꥢɤ߹
-  ڰ
-  fp		եݥ
-  M		ޥƥꥢ
-
-  ۤ͡ʤ
-  ڻ͡mqoCreateModel(), mqoCreateSequence()Υִؿ
-  =========================================================================*/
-
-void mqoReadMaterial(FILE *fp, MQO_MATDATA M[])
-{
-  GLfloat		dif, amb, emi, spc;
-  glCOLOR4f	c;
-  char		buf[SIZE_STR];
-  char		*pStrEnd, *pStr;
-  int			len;
-  int			i = 0;
-
-  while (1) {
-    fgets(buf,SIZE_STR,fp);	// ɤ߹
-    if (strstr(buf,"}")) break;
-
-    pStr = strstr(buf,"col(");	// ̾ɤФ
-    sscanf( pStr,
-	    "col(%f %f %f %f) dif (%f) amb(%f) emi(%f) spc(%f) power(%f)",
-	    &c.r, &c.g, &c.b, &c.a, &dif, &amb, &emi, &spc, &M[i].power );
-
-    // ĺ顼
-    M[i].col = c;
-
-    // Ȼ
-    M[i].dif[0] = dif * c.r;
-    M[i].dif[1] = dif * c.g;
-    M[i].dif[2] = dif * c.b;
-    M[i].dif[3] = c.a;
-
-    // ϸ
-    M[i].amb[0] = amb * c.r;
-    M[i].amb[1] = amb * c.g;
-    M[i].amb[2] = amb * c.b;
-    M[i].amb[3] = c.a;
-
-    // ʾ
-    M[i].emi[0] = emi * c.r;
-    M[i].emi[1] = emi * c.g;
-    M[i].emi[2] = emi * c.b;
-    M[i].emi[3] = c.a;
-
-    // ȿ͸
-    M[i].spc[0] = spc * c.r;
-    M[i].spc[1] = spc * c.g;
-    M[i].spc[2] = spc * c.b;
-    M[i].spc[3] = c.a;
-		
-    // texͥޥåԥ̾
-    if ( (pStr = strstr(buf,"tex(")) != NULL ) {
-      M[i].useTex = TRUE;
-
-      pStrEnd = strstr(pStr,")")-1;
-      len = pStrEnd - (pStr+5);
-      strncpy(M[i].texFile,pStr+5,len);
-      M[i].texFile[len] = (char)0;
-      if ( (pStr = strstr(buf,"aplane(")) != NULL ) {
-	pStrEnd = strstr(pStr,")")-1;
-	len = pStrEnd - (pStr+8);
-	strncpy(M[i].alpFile,pStr+8,len);
-	M[i].alpFile[len] = (char)0;
-      }
-      else {
-	M[i].alpFile[0] = (char)0;
-      }
-
-    } else {
-      M[i].useTex = FALSE;
-      M[i].texFile[0] = (char)0;
-      M[i].alpFile[0] = (char)0;
-    }
-
-    i++;
-  }
-
-}
-
-
-/*=========================================================================
-  ڴؿmqoReadVertex
-  ӡĺɤ߹
-  ڰ
-  fp		ߥץ󤷤Ƥ᥿եΥեݥ
-  V		ĺǼ
-		
-  ۤ͡ʤ
-  ڻ͡mqoReadObject()Υִؿ
-  =========================================================================*/
-
-void mqoReadVertex(FILE *fp, glPOINT3f V[])
-{
-  char buf[SIZE_STR];
-  int  i=0;
-
-  while (1) {
-    fgets(buf,SIZE_STR,fp);
-    if (strstr(buf,"}")) break;
-    sscanf(buf,"%f %f %f",&V[i].x,&V[i].y,&V[i].z);
-    i++;
-  }
-}
-
-
-/*=========================================================================
-  ڴؿmqoReadBVertex
-  ӡۥХʥĺɤ߹
-  ڰ
-  fp		ߥץ󤷤Ƥ᥿եΥեݥ
-  V		ĺǼ
-
-  ͡ĺ
-  ڻ͡mqoReadObject()Υִؿ
-  =========================================================================*/
-
-int mqoReadBVertex(FILE *fp, glPOINT3f V[])
-{
-  int n_vertex,i;
-  float *wf;
-  int size;
-  char cw[256];
-  char *pStr;
-
-  fgets(cw,sizeof(cw),fp);
-  if ( (pStr = strstr(cw,"Vector")) != NULL ) {
-    sscanf(pStr,"Vector %d [%d]",&n_vertex,&size);	// ĺǡɤ߹
-  }
-  else {
-    return -1;
-  }
-  //MQOեΥХʥĺǡintelʥȥ륨ǥ
-  wf = (float *)malloc(size);
-  fread(wf,size,1,fp);
-  for ( i = 0; i < n_vertex; i++ ) {
-    V[i].x = wf[i*3+0];
-    V[i].y = wf[i*3+1];
-    V[i].z = wf[i*3+2];
-#if DEF_IS_LITTLE_ENDIAN
-#else
-    endianConverter((void *)&V[i].x,sizeof(V[i].x));
-    endianConverter(&V[i].y,sizeof(V[i].y));
-    endianConverter(&V[i].z,sizeof(V[i].z));
-#endif
-  }
-  free(wf);
-
-  // "}"ޤɤФ
-  {
-    char buf[SIZE_STR];
-    while (1) {
-      fgets(buf,SIZE_STR,fp);
-      if (strstr(buf,"}")) break;
-    }
-  }
-
-  return n_vertex;
-}
-
-
-/*=========================================================================
-  ڴؿmqoReadFace
-  ӡ̾ɤ߹
-  ڰ
-  fp		եݥ
-  F		
-		
-  ۤ͡ʤ
-  ڻ͡mqoReadObject()Υִؿ
-  =========================================================================*/
-
-void mqoReadFace(FILE *fp, MQO_FACE F[])
-{
-  char buf[SIZE_STR];
-  char *pStr;
-  int  i=0;
-
-  while (1) {
-    fgets(buf,SIZE_STR,fp);
-    if (strstr(buf,"}")) break;
-
-    // ̤ĺ
-    sscanf(buf,"%d",&F[i].n);
-
-    // ĺ(V)ɤ߹
-    if ( (pStr = strstr(buf,"V(")) != NULL ) {
-      switch (F[i].n) {
-      case 3:
-	//᥿ĺ¤Ӥɽ̤ߤƱ
-	//ɤ߹߻¤ؤˡ⤢롣ɡɽ̤
-	//glFrontFaceѤۤޡȡ
-	sscanf(pStr,"V(%d %d %d)",&F[i].v[0],&F[i].v[1],&F[i].v[2]);
-	//					sscanf(pStr,"V(%d %d %d)",&F[i].v[2],&F[i].v[1],&F[i].v[0]);
-	break;
-      case 4:
-	sscanf(pStr,"V(%d %d %d %d)",&F[i].v[0],&F[i].v[1],&F[i].v[2],&F[i].v[3]);
-	//					sscanf(pStr,"V(%d %d %d %d)",&F[i].v[3],&F[i].v[2],&F[i].v[1],&F[i].v[0]);
-	break;
-      default:
-	break;
-      }		
-    }
-
-    // ޥƥꥢ(M)ɤ߹
-    F[i].m = 0;
-    if ( (pStr = strstr(buf,"M(")) != NULL ) {
-      sscanf(pStr,"M(%d)",&F[i].m);
-    }
-    else { // ޥƥꥢ뤬ꤵƤʤ
-      F[i].m = -1;
-    }
-
-    // UVޥå(UV)ɤ߹
-    if ( (pStr = strstr(buf,"UV(")) != NULL ) {
-      switch (F[i].n) {
-      case 3:	// ĺ3
-	sscanf(pStr,"UV(%f %f %f %f %f %f)",
-	       &F[i].uv[0].x, &F[i].uv[0].y,
-	       &F[i].uv[1].x, &F[i].uv[1].y,
-	       &F[i].uv[2].x, &F[i].uv[2].y
-	       );
-	break;
-
-      case 4:	// ĺ4
-	sscanf(pStr,"UV(%f %f %f %f %f %f %f %f)",
-	       &F[i].uv[0].x, &F[i].uv[0].y,
-	       &F[i].uv[1].x, &F[i].uv[1].y,
-	       &F[i].uv[2].x, &F[i].uv[2].y,
-	       &F[i].uv[3].x, &F[i].uv[3].y
-	       );
-	break;
-      default:
-	break;
-      }		
-    }
-
-    i++;
-  }
-
-}
-
-
-/*=========================================================================
-  ڴؿmqoReadObject
-  ӡۥ֥Ⱦɤ߹
-  ڰ
-  fp		եݥ
-  obj		֥Ⱦ
-
-  ۤ͡ʤ
-  ڻۤ͡δؿǣĤΥ֥Ⱦɤ߹ޤ롥
-  =========================================================================*/
-
-void mqoReadObject(FILE *fp, MQO_OBJDATA *obj)
-{
-  char buf[SIZE_STR];
-
-  while (1) {
-    fgets(buf,SIZE_STR,fp);
-    if (strstr(buf,"}")) break;
-
-    // visible
-    if (strstr(buf,"visible ")) {
-      sscanf(buf," visible %d", &obj->visible);
-    }
-
-    // shading
-    if (strstr(buf,"shading ")) {
-      sscanf(buf," shading %d", &obj->shading);
-    }
-
-    // facet
-    if (strstr(buf,"facet ")) {
-      sscanf(buf," facet %f", &obj->facet);
-    }
-
-    // vertex
-    if (strstr(buf,"vertex ")) {
-      sscanf(buf," vertex %d", &obj->n_vertex);
-      obj->V = (glPOINT3f*) calloc( obj->n_vertex, sizeof(glPOINT3f) );
-      mqoReadVertex(fp, obj->V);
-    }
-    // BVertex
-    if (strstr(buf,"BVertex"))	{
-      sscanf(buf," BVertex %d", &obj->n_vertex);
-      obj->V = (glPOINT3f*) calloc( obj->n_vertex, sizeof(glPOINT3f) );
-      mqoReadBVertex(fp,obj->V);
-    }
-
-    // face
-    if (strstr(buf,"face ")) {
-      sscanf(buf," face %d", &obj->n_face);
-      obj->F = (MQO_FACE*) calloc( obj->n_face, sizeof(MQO_FACE) );
-      mqoReadFace(fp, obj->F);
-    }
-
-  }
-
-}
-
-
-/*=========================================================================
-  ڴؿmqoMakeArray
-  ӡĺκ
-  ڰ
-  mat		ޥƥꥢʤĺǡޤ
-  matpos	ֹ
-  F		
-  fnum	̿
-  V		ĺ
-  N		ˡ
-  facet	ࡼ󥰳
-  mcol	
-  scale	
-  alpha	ե
-
-  ۤ͡ʤ
-  ڻ͡ĺϤ٤ƻѤˤΤǡͳѤϻѣʬ
-  0  3      0    0  3
-     
-  1  2     1  2   2  
-  =========================================================================*/
-
-void mqoMakeArray( MQO_MATERIAL *mat, int matpos, MQO_FACE F[], int fnum,glPOINT3f V[],
-		   glPOINT3f N[], double facet, glCOLOR4f *mcol, double scale, unsigned char alpha )
-{
-  int f;
-  int i;
-  int dpos;
-  double s;
-  glPOINT3f normal;	// ˡ٥ȥ
-	
-  dpos = 0;
-  mat->color[0] = mcol->r;
-  mat->color[1] = mcol->g;
-  mat->color[2] = mcol->b;
-  mat->color[3] = mcol->a;
-  if ( mat->isUseTexture ) {
-    for ( f = 0; f < fnum; f++ ){
-      if ( F[f].m != matpos ) continue;
-      if ( F[f].n == 3 ) {
-	mqoSnormal(V[F[f].v[0]],V[F[f].v[1]],V[F[f].v[2]],&normal);	// ˡ٥ȥ׻
-	for ( i = 0; i < 3; i++ ) {
-	  mat->vertex_t[dpos].point[0] = V[F[f].v[i]].x*scale;
-	  mat->vertex_t[dpos].point[1] = V[F[f].v[i]].y*scale;
-	  mat->vertex_t[dpos].point[2] = V[F[f].v[i]].z*scale;
-	  mat->vertex_t[dpos].uv[0] = F[f].uv[i].x;
-	  mat->vertex_t[dpos].uv[1] = F[f].uv[i].y;
-	  s = acos(normal.x*N[F[f].v[i]].x + normal.y*N[F[f].v[i]].y + normal.z*N[F[f].v[i]].z);
-	  if ( facet < s ) {
-	    // ࡼ󥰳ѡĺˡˡγ١ˤΤȤˡĺˡȤ
-	    mat->vertex_t[dpos].normal[0] = normal.x;
-	    mat->vertex_t[dpos].normal[1] = normal.y;
-	    mat->vertex_t[dpos].normal[2] = normal.z;
-	  }
-	  else {
-	    mat->vertex_t[dpos].normal[0] = N[F[f].v[i]].x;
-	    mat->vertex_t[dpos].normal[1] = N[F[f].v[i]].y;
-	    mat->vertex_t[dpos].normal[2] = N[F[f].v[i]].z;
-	  }
-	  dpos++;
-	}
-      }
-      //ĺʻͳѡˤϣĺʻѡˣʬ
-      if ( F[f].n == 4 ) {
-	mqoSnormal(V[F[f].v[0]],V[F[f].v[1]],V[F[f].v[2]],&normal);	// ˡ٥ȥ׻
-	for ( i = 0; i < 4; i++ ) {
-	  if ( i == 3 ) continue;
-	  mat->vertex_t[dpos].point[0] = V[F[f].v[i]].x*scale;
-	  mat->vertex_t[dpos].point[1] = V[F[f].v[i]].y*scale;
-	  mat->vertex_t[dpos].point[2] = V[F[f].v[i]].z*scale;
-	  mat->vertex_t[dpos].uv[0] = F[f].uv[i].x;
-	  mat->vertex_t[dpos].uv[1] = F[f].uv[i].y;
-	  s = acos(normal.x*N[F[f].v[i]].x + normal.y*N[F[f].v[i]].y + normal.z*N[F[f].v[i]].z);
-	  if ( facet < s ) {
-	    mat->vertex_t[dpos].normal[0] = normal.x;
-	    mat->vertex_t[dpos].normal[1] = normal.y;
-	    mat->vertex_t[dpos].normal[2] = normal.z;
-	  }
-	  else {
-	    mat->vertex_t[dpos].normal[0] = N[F[f].v[i]].x;
-	    mat->vertex_t[dpos].normal[1] = N[F[f].v[i]].y;
-	    mat->vertex_t[dpos].normal[2] = N[F[f].v[i]].z;
-	  }
-	  dpos++;
-	}
-	mqoSnormal(V[F[f].v[0]],V[F[f].v[2]],V[F[f].v[3]],&normal);	// ˡ٥ȥ׻
-	for ( i = 0; i < 4; i++ ) {
-	  if ( i == 1 ) continue;
-	  mat->vertex_t[dpos].point[0] = V[F[f].v[i]].x*scale;
-	  mat->vertex_t[dpos].point[1] = V[F[f].v[i]].y*scale;
-	  mat->vertex_t[dpos].point[2] = V[F[f].v[i]].z*scale;
-	  mat->vertex_t[dpos].uv[0] = F[f].uv[i].x;
-	  mat->vertex_t[dpos].uv[1] = F[f].uv[i].y;
-	  s = acos(normal.x*N[F[f].v[i]].x + normal.y*N[F[f].v[i]].y + normal.z*N[F[f].v[i]].z);
-	  if ( facet < s ) {
-	    mat->vertex_t[dpos].normal[0] = normal.x;
-	    mat->vertex_t[dpos].normal[1] = normal.y;
-	    mat->vertex_t[dpos].normal[2] = normal.z;
-	  }
-	  else {
-	    mat->vertex_t[dpos].normal[0] = N[F[f].v[i]].x;
-	    mat->vertex_t[dpos].normal[1] = N[F[f].v[i]].y;
-	    mat->vertex_t[dpos].normal[2] = N[F[f].v[i]].z;
-	  }
-	  dpos++;
-	}
-      }
-    }
-  }
-  else {
-    if ( alpha != 255 ) {
-      mat->color[3] = (double)alpha/(double)255;
-    }
-    for ( f = 0; f < fnum; f++ ){
-      if ( F[f].m != matpos ) continue;
-      if ( F[f].n == 3 ) {
-	mqoSnormal(V[F[f].v[0]],V[F[f].v[1]],V[F[f].v[2]],&normal);		// ˡ٥ȥ׻
-	for ( i = 0; i < 3; i++ ) {
-	  mat->vertex_p[dpos].point[0] = V[F[f].v[i]].x*scale;
-	  mat->vertex_p[dpos].point[1] = V[F[f].v[i]].y*scale;
-	  mat->vertex_p[dpos].point[2] = V[F[f].v[i]].z*scale;
-	  mat->vertex_p[dpos].normal[0] = normal.x;
-	  mat->vertex_p[dpos].normal[1] = normal.y;
-	  mat->vertex_p[dpos].normal[2] = normal.z;
-	  s = acos(normal.x*N[F[f].v[i]].x + normal.y*N[F[f].v[i]].y + normal.z*N[F[f].v[i]].z);
-	  if ( facet < s ) {
-	    mat->vertex_p[dpos].normal[0] = normal.x;
-	    mat->vertex_p[dpos].normal[1] = normal.y;
-	    mat->vertex_p[dpos].normal[2] = normal.z;
-	  }
-	  else {
-	    mat->vertex_p[dpos].normal[0] = N[F[f].v[i]].x;
-	    mat->vertex_p[dpos].normal[1] = N[F[f].v[i]].y;
-	    mat->vertex_p[dpos].normal[2] = N[F[f].v[i]].z;
-	  }
-	  dpos++;
-	}
-      }
-      //ĺʻͳѡˤϣĺʻѡˣʬ
-      if ( F[f].n == 4 ) {
-	mqoSnormal(V[F[f].v[0]],V[F[f].v[1]],V[F[f].v[2]],&normal);		// ˡ٥ȥ׻
-	for ( i = 0; i < 4; i++ ) {
-	  if ( i == 3 ) continue;
-	  mat->vertex_p[dpos].point[0] = V[F[f].v[i]].x*scale;
-	  mat->vertex_p[dpos].point[1] = V[F[f].v[i]].y*scale;
-	  mat->vertex_p[dpos].point[2] = V[F[f].v[i]].z*scale;
-	  mat->vertex_p[dpos].normal[0] = normal.x;
-	  mat->vertex_p[dpos].normal[1] = normal.y;
-	  mat->vertex_p[dpos].normal[2] = normal.z;
-	  s = acos(normal.x*N[F[f].v[i]].x + normal.y*N[F[f].v[i]].y + normal.z*N[F[f].v[i]].z);
-	  if ( facet < s ) {
-	    mat->vertex_p[dpos].normal[0] = normal.x;
-	    mat->vertex_p[dpos].normal[1] = normal.y;
-	    mat->vertex_p[dpos].normal[2] = normal.z;
-	  }
-	  else {
-	    mat->vertex_p[dpos].normal[0] = N[F[f].v[i]].x;
-	    mat->vertex_p[dpos].normal[1] = N[F[f].v[i]].y;
-	    mat->vertex_p[dpos].normal[2] = N[F[f].v[i]].z;
-	  }
-	  dpos++;
-	}
-	mqoSnormal(V[F[f].v[0]],V[F[f].v[2]],V[F[f].v[3]],&normal);		// ˡ٥ȥ׻
-	for ( i = 0; i < 4; i++ ) {
-	  if ( i == 1 ) continue;
-	  mat->vertex_p[dpos].point[0] = V[F[f].v[i]].x*scale;
-	  mat->vertex_p[dpos].point[1] = V[F[f].v[i]].y*scale;
-	  mat->vertex_p[dpos].point[2] = V[F[f].v[i]].z*scale;
-	  mat->vertex_p[dpos].normal[0] = normal.x;
-	  mat->vertex_p[dpos].normal[1] = normal.y;
-	  mat->vertex_p[dpos].normal[2] = normal.z;
-	  s = acos(normal.x*N[F[f].v[i]].x + normal.y*N[F[f].v[i]].y + normal.z*N[F[f].v[i]].z);
-	  if ( facet < s ) {
-	    mat->vertex_p[dpos].normal[0] = normal.x;
-	    mat->vertex_p[dpos].normal[1] = normal.y;
-	    mat->vertex_p[dpos].normal[2] = normal.z;
-	  }
-	  else {
-	    mat->vertex_p[dpos].normal[0] = N[F[f].v[i]].x;
-	    mat->vertex_p[dpos].normal[1] = N[F[f].v[i]].y;
-	    mat->vertex_p[dpos].normal[2] = N[F[f].v[i]].z;
-	  }
-	  dpos++;
-	}
-      }
-    }
-  }
-}
-
-
-/*=========================================================================
-  ڴؿmqoVertexNormal
-  ӡĺˡη׻
-  ڰ
-  obj			֥Ⱦ
-
-  ͡ˡ
-  ڻۣ͡ĺ̤ϻѷʬ䤷Ʒ׻
-  ͤɬƤӽФǲfreeˤ뤳ȡ
-  =========================================================================*/
-
-glPOINT3f * mqoVertexNormal(MQO_OBJDATA *obj)
-{
-  int f;
-  int v;
-  int i;
-  double len;
-  glPOINT3f fnormal;	// ˡ٥ȥ
-  MQO_FACE *F;
-  glPOINT3f *V;
-  glPOINT3f *ret;
-  F = obj->F;
-  V = obj->V;
-  ret = (glPOINT3f *)calloc(obj->n_vertex,sizeof(glPOINT3f));
-  //̤ˡĺ­
-  for ( f = 0; f < obj->n_face; f++ ) {
-    if ( obj->F[f].n == 3 ) {
-      mqoSnormal(V[F[f].v[0]],V[F[f].v[1]],V[F[f].v[2]],&fnormal);
-      for ( i = 0; i < 3; i++ ) {
-	ret[F[f].v[i]].x += fnormal.x;
-	ret[F[f].v[i]].y += fnormal.y;
-	ret[F[f].v[i]].z += fnormal.z;
-      }
-    }
-    if ( obj->F[f].n == 4 ) {
-      mqoSnormal(V[F[f].v[0]],V[F[f].v[1]],V[F[f].v[2]],&fnormal);
-      for ( i = 0; i < 4; i++ ) {
-	if ( i == 3 ) continue;
-	ret[F[f].v[i]].x += fnormal.x;
-	ret[F[f].v[i]].y += fnormal.y;
-	ret[F[f].v[i]].z += fnormal.z;
-      }
-      mqoSnormal(V[F[f].v[0]],V[F[f].v[2]],V[F[f].v[3]],&fnormal);
-      for ( i = 0; i < 4; i++ ) {
-	if ( i == 1 ) continue;
-	ret[F[f].v[i]].x += fnormal.x;
-	ret[F[f].v[i]].y += fnormal.y;
-	ret[F[f].v[i]].z += fnormal.z;
-      }
-    }
-  }
-  //
-  for ( v = 0; v < obj->n_vertex; v++ ) {
-    if ( ret[v].x == 0 && ret[v].y == 0 && ret[v].z == 0 ) {
-      //̤˻ȤƤʤ
-      continue;
-    }
-    len = sqrt(ret[v].x*ret[v].x + ret[v].y*ret[v].y + ret[v].z*ret[v].z);
-    if ( len != 0 ) {
-      ret[v].x = ret[v].x/len;
-      ret[v].y = ret[v].y/len;
-      ret[v].z = ret[v].z/len;
-    }
-  }
-
-  return ret;
-}
-
-/*=========================================================================
-  ڴؿmqoMakePolygon
-  ӡۥݥꥴ
-  ڰ
-  readObj		ɤ߹֥Ⱦ
-  mqoobj		MQO֥ 
-  N[]			ˡ
-  M[]			ޥƥꥢ
-  n_mat		ޥƥꥢ
-  scale		
-  alpha		ե
-
-  ۤ͡ʤ
-  =========================================================================*/
-
-void mqoMakePolygon(MQO_OBJDATA *readObj, MQO_OBJECT *mqoobj,
-		    glPOINT3f N[], MQO_MATDATA M[], int n_mat, double scale, unsigned char alpha)
-{
-
-  MQO_INNER_OBJECT		*setObj;
-  MQO_MATERIAL			*material;
-  glCOLOR4f				defcol;
-  glCOLOR4f				*pcol;
-  int						f, m, *mat_vnum;
-  int						fnum;
-  MQO_FACE				*F;
-  glPOINT3f				*V;
-  double					facet;
-
-
-  setObj = &mqoobj->obj[mqoobj->objnum];
-  strcpy(setObj->objname,readObj->objname);
-  setObj->isVisible = readObj->visible;
-  setObj->isShadingFlat = (readObj->shading == 0);
-  F = readObj->F;
-  fnum = readObj->n_face;
-  V = readObj->V;
-  facet = readObj->facet;
-
-  // faceǤΥޥƥꥢĺο
-  // M=NULLΤȤF[].m = 0 äƤ
-  if ( M == NULL ) n_mat = 1;
-
-  mat_vnum = (int *)malloc(sizeof(int)*n_mat);
-  memset(mat_vnum,0,sizeof(int)*n_mat);
-
-  for ( f = 0; f < fnum; f++ ){
-    if( F[f].m < 0 ) continue; // ޥƥꥢ뤬ꤵƤʤ
-    if ( F[f].n == 3 ) {
-      mat_vnum[F[f].m] += 3;
-    }
-    if ( F[f].n == 4 ) {
-      //ĺʻͳѡˤϣĺʻѡˣʬ
-      //  0  3      0    0  3
-      //      
-      //  1  2     1  2   2
-      // ĺʿ̥ǡ
-      // ĺʿ̥ǡ
-      mat_vnum[F[f].m] += 3*2;
-    }
-    if ( setObj->matnum < F[f].m+1 ) setObj->matnum = F[f].m+1;
-  }
-
-  // ޥƥꥢ̤ĺ
-  setObj->mat = (MQO_MATERIAL *)malloc(sizeof(MQO_MATERIAL)*setObj->matnum);
-  memset(setObj->mat,0,sizeof(MQO_MATERIAL)*setObj->matnum);
-
-  for ( m = 0; m < setObj->matnum; m++ ) {
-    material = &setObj->mat[m];
-    material->datanum = mat_vnum[m];
-    material->isValidMaterialInfo = (M != NULL);
-
-    if ( mat_vnum[m] <= 0 ) continue;
-    if ( material->isValidMaterialInfo ) {
-      memcpy(material->dif,M[m].dif,sizeof(material->dif));
-      memcpy(material->amb,M[m].amb,sizeof(material->amb));
-      memcpy(material->spc,M[m].spc,sizeof(material->spc));
-      memcpy(material->emi,M[m].emi,sizeof(material->emi));
-      material->power = M[m].power;
-      material->isUseTexture = M[m].useTex;
-      pcol = &M[m].col;
-    }
-    else {
-      defcol.r = 1.0;
-      defcol.g = 1.0;
-      defcol.b = 1.0;
-      defcol.a = 1.0;
-      material->isUseTexture = 0;
-      pcol = &defcol;
-    }
-    if ( material->isUseTexture ) {
-      material->vertex_t = (VERTEX_TEXUSE *)calloc(material->datanum,sizeof(VERTEX_TEXUSE));
-      material->texture_id = M[m].texName;
-    }
-    else {
-      material->vertex_p = (VERTEX_NOTEX *)calloc(material->datanum,sizeof(VERTEX_NOTEX));
-    }
-    mqoMakeArray(material,m,F,fnum,V,N,facet,pcol,scale,alpha);
-    if (g_isVBOSupported) {
-      if ( material->isUseTexture ) {
-#if 0	
-	glGenBuffersARB( 1, &material->VBO_id );
-	glBindBufferARB( GL_ARRAY_BUFFER_ARB, material->VBO_id  );
-	glBufferDataARB( GL_ARRAY_BUFFER_ARB, material->datanum*sizeof(VERTEX_TEXUSE), material->vertex_t, GL_STATIC_DRAW_ARB );
-#endif	
-      }
-      else {
-#if 0	
-	glGenBuffersARB( 1, &material->VBO_id );
-	glBindBufferARB( GL_ARRAY_BUFFER_ARB, material->VBO_id  );
-	glBufferDataARB( GL_ARRAY_BUFFER_ARB, material->datanum*sizeof(VERTEX_NOTEX), material->vertex_p, GL_STATIC_DRAW_ARB );
-#endif	
-      }
-    }
-  }
-  mqoobj->objnum++;
-  if ( MAX_OBJECT <= mqoobj->objnum ) {
-    printf("MQOեɤ߹ߡ祪֥ȿĶޤ[%d]\n",mqoobj->objnum);
-    mqoobj->objnum = MAX_OBJECT-1;
-  }
-
-  free(mat_vnum);
-
-}
-
-
-/*=========================================================================
-  ڴؿmqoMakeObjectsEx
-  ӡۥ֥ȤΥǡݥꥴǥ
-  ڰ
-  mqoobj	MQO֥
-  obj		֥
-  n_obj	֥ȤθĿ
-  M		ޥƥꥢ
-  n_mat	ޥƥꥢθĿ
-  scale	Ψ
-  alpha	ե
-
-  ۤ͡ʤ
-  =========================================================================*/
-
-void mqoMakeObjectsEx( MQO_OBJECT *mqoobj, MQO_OBJDATA obj[], int n_obj, MQO_MATDATA M[],int n_mat,
-		       double scale,unsigned char alpha)
-{
-  int i;
-  glPOINT3f *N;
-  for (i=0; i<n_obj; i++) {
-    N = mqoVertexNormal(&obj[i]);
-    mqoMakePolygon(
-		   &obj[i],
-		   mqoobj,
-		   N,
-		   M,n_mat,
-		   scale,
-		   alpha);
-    free(N);
-  }
-}
-
-
-/*=========================================================================
-  ڴؿmqoCreateModel
-  ӡMQOե뤫MQOǥ
-  ڰ
-  filename	MQOե
-  scale		Ψ1.0ǤΤޤޡ
-
-  ͡MQO_MODELMQOǥ
-  =========================================================================*/
-
-MQO_MODEL mqoCreateModel(char *filename, double scale)
-{
-  MQO_MODEL ret;
-  ret = mqoCreateList(1);
-  if ( mqoCreateListObject(ret,1-1,filename,scale,(unsigned char)255) < 0 ) {
-    mqoDeleteObject(ret,1);
-    ret = NULL;
-  }
-  return ret;
-}
-
-
-/*=========================================================================
-  ڴؿmqoCreateSequenceEx
-  ӡϢ֤MQOե뤫MQO󥹤
-  ڰ
-  format		ե̾ν
-  n_file		ե
-  scale		Ψ1.0ǤΤޤޡ
-  fade_inout	0:Τޤޡեɥ顧եɥ
-  ͤϸ̤򤫤ե졼
-  alpha		ե
-
-  ͡MQO_SEQUENCEMQO󥹡
-  ͡Ϣ֤0鳫
-  =========================================================================*/
-
-MQO_SEQUENCE mqoCreateSequenceEx(const char *format, int n_file, double scale,
-				 int fade_inout, unsigned char alpha)
-{
-  MQO_SEQUENCE retSeq;
-  int iret;
-  int seq;
-  char filename[SIZE_STR];
-  short setAlpha;
-  short calAlpha;
-  int frames;
-
-  retSeq.n_frame = 0;
-  if ( format == NULL ) {
-    return retSeq;
-  }
-  calAlpha = alpha;
-  frames = abs(fade_inout);
-  frames = MY_MAX(frames,n_file);
-  setAlpha = (fade_inout<=0)?alpha:0;
-
-  retSeq.model = mqoCreateList(n_file);
-  for ( seq = 0; seq < frames; seq++ ) {
-    if ( seq < n_file ) {
-      sprintf(filename,format,seq);
-    }
-    if ( (fade_inout !=  0) && ((frames-1) == seq) ) {
-      setAlpha = (fade_inout<0)?0:calAlpha;
-    }
-    iret = mqoCreateListObject(retSeq.model,seq,filename,scale,(unsigned char)setAlpha);
-    if ( iret == - 1 ) {
-      seq--;
-      mqoClearObject(retSeq.model,seq,n_file-seq);
-      break;
-    }
-    if ( fade_inout !=  0 ) {
-      if ( fade_inout<0 ) {
-	if ( (n_file-seq) <= (-1*fade_inout) ) {
-	  setAlpha -= (calAlpha/(-1*fade_inout));
-	  if ( setAlpha < 0 ) setAlpha = 0;
-	}
-      }
-      else {
-	setAlpha += (calAlpha/fade_inout);
-	if ( calAlpha < setAlpha ) setAlpha = calAlpha;
-      }
-    }
-  }
-  retSeq.n_frame = seq;
-  return retSeq;
-}
-
-
-/*=========================================================================
-  ڴؿmqoCreateSequence
-  ӡϢ֤MQOե뤫MQO󥹤
-  ڰ
-  format		ե̾Υեޥå
-  n_file		ե
-  scale		Ψ1.0ǤΤޤޡ
-
-  ͡MQO_SEQUENCEMQO󥹡
-  ͡Ϣ֤0鳫
-  =========================================================================*/
-
-MQO_SEQUENCE mqoCreateSequence(const char *format, int n_file, double scale)
-{
-  return mqoCreateSequenceEx(format, n_file, scale, 0, (unsigned char)255);
-}
-
-
-/*=========================================================================
-  ڴؿmqoCallModel
-  ӡMQOǥOpenGLβ̾˸ƤӽФ
-  ڰ
-  model		MQOǥ
-
-  ۤ͡ʤ
-  =========================================================================*/
-
-void mqoCallModel(MQO_MODEL model)
-{
-  mqoCallListObject(model, 0);
-}
-
-
-/*=========================================================================
-  ڴؿmqoCallSequence
-  ӡMQO󥹤OpenGLβ̤˸ƤӽФ
-  ڰ
-  seq		MQO
-  i		ե졼ֹ
-
-  ۤ͡ʤ
-  ڻ͡MQO󥹤椫ꤷե졼ֹΥǥƤӽФ
-  =========================================================================*/
-
-void mqoCallSequence(MQO_SEQUENCE seq, int i)
-{
-  if ( i>=0 && i<seq.n_frame ) {
-    mqoCallListObject(seq.model,i);
-  }
-}
-
-
-/*=========================================================================
-  ڴؿmqoClearObject
-  ӡMQO֥ȤΥꥢ
-  ڰ
-  object	MQO֥
-  from	ֹ0
-  num		Ŀ
-
-  ۤ͡ʤ
-  =========================================================================*/
-
-void mqoClearObject( MQO_OBJECT object[], int from, int num ) 
-{
-  int					loop, o, m;
-  MQO_INNER_OBJECT	*obj;
-  MQO_MATERIAL		*mat;
-
-  if ( object == NULL ) return;
-
-  for ( loop = from; loop < from + num; loop++ ) {
-    for ( o = 0; o < (object+from)->objnum; o++ ) {
-
-      obj = &(object+loop)->obj[o];
-      for ( m = 0; m < obj->matnum; m++ ) {
-	mat = &obj->mat[m];
-	if ( mat->datanum <= 0 ) continue;
-	if ( g_isVBOSupported ) {
-	  // ĺХåեκ
-#if 0	  
-	  glDeleteBuffersARB( 1, &mat->VBO_id );
-#endif	  
-	}
-
-	// ĺκ
-	if ( mat->isUseTexture ) {
-	  if ( mat->vertex_t != NULL ) {
-	    free(mat->vertex_t);
-	    mat->vertex_t = NULL;
-	  }
-	}
-	else {
-	  if ( mat->vertex_p != NULL ) {
-	    free(mat->vertex_p);
-	    mat->vertex_p = NULL;
-	  }
-	}
-      }
-      if ( obj->mat != NULL ) {
-	free(obj->mat);
-	obj->mat = NULL;
-      }
-      obj->matnum = 0;
-    }
-  }
-
-}
-
-
-/*=========================================================================
-  ڴؿmqoDeleteObject
-  ӡMQO֥Ȥ
-  ڰ
-  object	MQO֥
-  num		Ŀ
-
-  ۤ͡ʤ
-  =========================================================================*/
-
-void mqoDeleteObject(MQO_OBJECT object[], int num)
-{
-  mqoClearObject(object,0,num);
-  free(object);
-}
-
-
-/*=========================================================================
-  ڴؿmqoDeleteModel
-  ӡMQOǥ
-  ڰ
-  model	MQOǥ
-
-  ۤ͡ʤ
-  ͡ۺԤäѿѤǽ
-  δؿμ¹ԸNULLƤ
-  =========================================================================*/
-
-void mqoDeleteModel(MQO_MODEL model)
-{
-  mqoDeleteObject(model,1);
-}
-
-
-/*=========================================================================
-  ڴؿmqoDeleteSequence
-  ӡMQO󥹤
-  ڰ
-  seq		MQO
-
-  ͡ۺԤäѿѤǽ
-  δؿμ¹ԸNULLƤ
-  =========================================================================*/
-
-void mqoDeleteSequence(MQO_SEQUENCE seq)
-{
-  mqoDeleteObject( seq.model, seq.n_frame );
-}
+#define __GLMETASEQ_C__
+#include "GLMetaseq.h"
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <ctype.h>
+#include <GL/glext.h>
+
+/*=========================================================================
+  【このソース内でのみ有効なグローバル変数】
+  =========================================================================*/
+
+static TEXTURE_POOL l_texPool[MAX_TEXTURE];		// テクスチャプール
+static int			l_texPoolnum;				// テクスチャの数
+static int			l_GLMetaseqInitialized = 0;	// 初期化フラグ
+static int			l_isHeadless = 0;			// GLのコンテキストなしで初期化したかどうか
+static int			l_optimizeVertexCache = 1;	// 頂点キャッシュ向けの並べ替えの有無
+static int			l_vertexLayout = MQO_LAYOUT_FLOAT;	// 読み込み中のモデルの頂点データの形式
+static int			l_reportLoad = 0;			// 読み込み時にメモリ量などを表示するかどうか
+static int			l_lodLevels = MQO_MAX_LOD;	// 作成する詳細度の段階の数（元のメッシュを含む）
+static long			l_cacheMissBefore;			// 並べ替え前のキャッシュミス数（モデル単位）
+static long			l_cacheMissAfter;			// 並べ替え後のキャッシュミス数（モデル単位）
+static long			l_cacheTriangles;			// 並べ替えた三角形の数（モデル単位）
+
+#define MQO_CACHE_SIZE	32	// 並べ替えの評価に使う頂点キャッシュの大きさ（LRU）
+#define MQO_FIFO_SIZE	16	// ACMR の計算に使う頂点キャッシュの大きさ（FIFO）
+
+#define MQO_INSTANCE_ATTRIB	4	// インスタンスごとの行列の頂点属性の番号（4〜7 を使う）
+#define MQO_LOD_SIZE		0.25f	// 詳細度を1段階下げる投影した球の半径（画面の中心から端を1とする）
+
+static GLuint		l_instanceProgram = 0;		// インスタンス描画用のシェーダプログラム
+static GLuint		l_instanceVBO = 0;			// インスタンスごとの行列のバッファ
+static GLint		l_uniformUseTexture;		// シェーダの uniform の位置
+static GLint		l_uniformQCenter;
+static GLint		l_uniformQScale;
+
+static int			l_isFrustumCulling = 0;		// 視錐台カリングの有無
+static GLfloat		l_frustum[6][4];			// 視錐台の6つの平面（視点座標系，内側が正）
+static GLfloat		l_projScale;				// 距離1の長さ1が画面の中心から端までの何倍になるか
+static GLfloat		*l_visibleMatrices = NULL;	// 視錐台に入った行列（mqoCallModelInstanced 用）
+static int			*l_visibleLevels = NULL;	// 行列ごとの詳細度の段階（-1 は視錐台の外）
+static int			l_visibleCapacity = 0;		// l_visibleMatrices に入る行列の数
+
+// インスタンス描画用の頂点シェーダ（行列は頂点属性としてインスタンスごとに進める）
+static const char	*l_instanceVertexShader =
+  "#version 120\n"
+  "attribute mat4 instanceMatrix;\n"
+  "uniform vec3 qcenter;\n"
+  "uniform vec3 qscale;\n"
+  "varying vec2 uv;\n"
+  "void main(void)\n"
+  "{\n"
+  "  vec4 p = vec4(qcenter + gl_Vertex.xyz*qscale, 1.0);\n"
+  "  gl_Position = gl_ModelViewProjectionMatrix*(instanceMatrix*p);\n"
+  "  gl_FrontColor = gl_Color;\n"
+  "  uv = gl_MultiTexCoord0.xy;\n"
+  "}\n";
+
+// インスタンス描画用のフラグメントシェーダ（固定機能の GL_MODULATE と同じ）
+static const char	*l_instanceFragmentShader =
+  "#version 120\n"
+  "uniform sampler2D tex;\n"
+  "uniform bool useTexture;\n"
+  "varying vec2 uv;\n"
+  "void main(void)\n"
+  "{\n"
+  "  vec4 c = gl_Color;\n"
+  "  if (useTexture) c *= texture2D(tex, uv);\n"
+  "  gl_FragColor = c;\n"
+  "}\n";
+
+
+/*=========================================================================
+  【型定義】描画時のGLの状態（GLに問い合わせずにCPU側で覚えておく）
+  =========================================================================*/
+
+typedef struct {
+  int		texture2D;		// GL_TEXTURE_2D の有効/無効
+  GLuint	texture;		// 結びつけているテクスチャ
+  int		blend;			// GL_BLEND の有効/無効
+  int		normalize;		// GL_NORMALIZE の有効/無効
+  int		blendFunc;		// glBlendFunc を設定済みかどうか
+  GLenum	shadeModel;		// シェーディングモデル
+  GLenum	frontFace;		// 表面の頂点の並び
+  GLuint	vao;			// 結びつけている頂点配列オブジェクト
+  GLuint	vbo;			// 結びつけている頂点バッファ
+  GLuint	ibo;			// 結びつけているインデックスバッファ（VAO 0 のもの）
+  int		vertexArray;	// クライアント側の配列の有効/無効（VAO 0 のもの）
+  int		normalArray;
+  int		texCoordArray;
+} MQO_GL_STATE;
+
+// モデルの描画の前後のGLの状態（OpenGLの初期値．描画後はこの状態に戻す）
+static const MQO_GL_STATE l_defaultGLState = {
+  0, 0, 0, 0, 0, GL_SMOOTH, GL_CCW, 0, 0, 0, 0, 0, 0
+};
+
+
+/*=========================================================================
+  【関数宣言】
+  =========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  void	endianConverter(void *addr,unsigned int size);
+  void	TGAHeaderEndianConverter(	STR_TGA_HEAD *tgah );
+  int		IsExtensionSupported( char* szTargetExtension );
+  int		IsVersionSupported( int major, int minor );
+
+  GLuint		mqoSetTexturePool(char *texfile, char *alpfile, unsigned char alpha );
+  void		mqoClearTexturePool();
+  GLubyte*	mqoLoadTextureEx(char *texfile,char *alpfile,int *tex_size,unsigned char alpha);
+  int			mqoLoadFile(MQO_OBJECT *mqoobj,char *filename,double scale,unsigned char alpha);
+  MQO_OBJECT*	mqoCreateList(int num);
+  int			mqoCreateListObject( MQO_OBJECT *obj, int id, char *filename,double scale,unsigned char alpha);
+
+  void mqoCallListObject(MQO_OBJECT object[],int num);
+  void mqoMakeInstanceProgram(void);
+  void mqoClearObject(MQO_OBJECT object[],int from,int num);
+  void mqoDeleteObject(MQO_OBJECT * object,int num);
+  void mqoGetDirectory(const char *path_file, char *path_dir);
+  void mqoSnormal(glPOINT3f A, glPOINT3f B, glPOINT3f C, glPOINT3f *normal);
+  void mqoReadMaterial(FILE *fp, MQO_MATDATA M[]);
+  void mqoReadVertex(FILE *fp, glPOINT3f V[]);
+  int	 mqoReadBVertex(FILE *fp,glPOINT3f V[]);
+  void mqoReadFace(FILE *fp, MQO_FACE F[]);
+  void mqoReadObject(FILE *fp, MQO_OBJDATA *obj);
+
+  void mqoMakeArray(MQO_MATERIAL *mat, int matpos,MQO_FACE F[], int fnum,glPOINT3f V[],
+		    glPOINT3f N[], double facet, glCOLOR4f *mcol, double scale, unsigned char alpha );
+
+  glPOINT3f *mqoVertexNormal(MQO_OBJDATA *obj);
+
+  void mqoMakePolygon(MQO_OBJDATA *readObj, MQO_OBJECT *mqoobj,
+		      glPOINT3f N[], MQO_MATDATA M[], int n_mat, double scale, unsigned char alpha);
+
+  void mqoMakeObjectsEx(MQO_OBJECT *mqoobj, MQO_OBJDATA obj[], int n_obj, MQO_MATDATA M[],int n_mat,
+			double scale,unsigned char alpha);
+
+  void mqoSetVertexPointer(MQO_MATERIAL *mat, char *base);
+  void mqoMakeVertexBuffer(MQO_MATERIAL *mat);
+  void mqoMakeIndex(MQO_MATERIAL *mat);
+  void mqoPackVertices(MQO_MATERIAL *mat);
+  void mqoOptimizeVertexCache(unsigned int *index, int ntri, unsigned char *data,
+			      int nvert, int vsize);
+  void mqoMakeLOD(MQO_MATERIAL *mat, unsigned int **pindex, const unsigned char *data,
+		  int nvert, int vsize);
+  void mqoMakeDrawList(MQO_OBJECT *mqoobj);
+  void mqoMakeModelBounds(MQO_OBJECT *mqoobj);
+  void mqoReportMemory(MQO_OBJECT *mqoobj, const char *filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+/*=========================================================================
+  【関数】endianConverter
+  【用途】エンディアン変換
+  【引数】
+  addr	アドレス
+  size	サイズ
+
+  【戻値】なし
+  =========================================================================*/
+
+void endianConverter(void *addr,unsigned int size)
+{
+  unsigned int pos;
+  char c;
+  if ( size <= 1 ) return;
+  for ( pos = 0; pos < size/2; pos++ ) {
+    c = *(((char *)addr)+pos);
+    *(((char *)addr)+pos) = *(((char *)addr)+(size-1 - pos));
+    *(((char *)addr)+(size-1 - pos)) = c;
+  }
+}
+
+
+/*=========================================================================
+  【関数】TGAHeaderEndianConverter
+  【用途】TGAのヘッダのエンディアン変換
+  【引数】
+  tgah	TGAのヘッダ
+
+  【戻値】なし
+  =========================================================================*/
+
+void TGAHeaderEndianConverter(	STR_TGA_HEAD *tgah )
+{
+  endianConverter(&tgah->color_map_entry,sizeof(tgah->color_map_entry));
+  endianConverter(&tgah->x,sizeof(tgah->x));
+  endianConverter(&tgah->y,sizeof(tgah->y));
+  endianConverter(&tgah->width,sizeof(tgah->width));
+  endianConverter(&tgah->height,sizeof(tgah->height));
+}
+
+
+/*=========================================================================
+  【関数】IsExtensionSupported
+  【用途】OpenGLの拡張機能がサポートされているかどうか調べる
+  【引数】
+  szTargetExtension	拡張機能の名前
+
+  【戻値】1：サポートされている，0：されていない
+  =========================================================================*/
+
+int IsExtensionSupported( char* szTargetExtension )
+{
+  const unsigned char *pszExtensions = NULL;
+  const unsigned char *pszStart;
+  unsigned char *pszWhere, *pszTerminator;
+
+  // Extension の名前が正しいか調べる(NULLや空白はNG）
+  pszWhere = (unsigned char *) strchr( szTargetExtension, ' ' );
+  if ( pszWhere || *szTargetExtension == (char)NULL )
+    return 0;
+
+  // Extension の文字列を所得する（コンテキストがない時は NULL）
+  pszExtensions = glGetString( GL_EXTENSIONS );
+  if ( pszExtensions == NULL )
+    return 0;
+
+  // 文字列の中に必要な extension があるか調べる
+  pszStart = pszExtensions;
+  for (;;)
+    {
+      pszWhere = (unsigned char *) strstr( (const char *) pszStart, szTargetExtension );
+      if ( !pszWhere )
+	break;
+      pszTerminator = pszWhere + strlen( szTargetExtension );
+      if ( pszWhere == pszStart || *( pszWhere - 1 ) == ' ' )
+	if ( *pszTerminator == ' ' || *pszTerminator == (char)NULL )
+	  return 1;
+      pszStart = pszTerminator;
+    }
+  return 0;
+}
+
+
+/*=========================================================================
+  【関数】IsVersionSupported
+  【用途】OpenGLのバージョンが指定以上かどうかをチェックする
+  【引数】
+  major	メジャーバージョン
+  minor	マイナーバージョン
+
+  【戻値】1：指定以上，0：指定未満
+  =========================================================================*/
+
+int IsVersionSupported( int major, int minor )
+{
+  const char *version;
+  int glMajor = 0, glMinor = 0;
+
+  version = (const char *) glGetString( GL_VERSION );
+  if ( version == NULL || sscanf( version, "%d.%d", &glMajor, &glMinor ) != 2 )
+    return 0;
+  return ( glMajor > major || ( glMajor == major && glMinor >= minor ) );
+}
+
+
+/*=========================================================================
+  【関数】mqoInit
+  【用途】メタセコイアローダの初期化
+  【引数】なし
+  【戻値】なし
+  =========================================================================*/
+
+void mqoInit(void)
+{
+  // テクスチャプール初期化
+  memset(l_texPool,0,sizeof(l_texPool));
+  l_texPoolnum = 0;
+
+  // GLのコンテキストがない時はGLを呼ばずに頂点配列とテクスチャの画像だけを作る
+  // （ソフトウェア描画用）
+  l_isHeadless = ( glGetString( GL_VERSION ) == NULL );
+
+  // 頂点バッファと頂点配列オブジェクトのサポートのチェック
+  // （OpenGLのコンテキストが作られていること）
+  g_isVBOSupported = IsVersionSupported(1, 5) ||
+    IsExtensionSupported((char *) "GL_ARB_vertex_buffer_object");
+  g_isVAOSupported = g_isVBOSupported &&
+    ( IsVersionSupported(3, 0) ||
+      IsExtensionSupported((char *) "GL_ARB_vertex_array_object") );
+  // 頂点配列の半精度浮動小数点数（量子化した頂点データのUVに使う）
+  g_isHalfFloatSupported = IsVersionSupported(3, 0) ||
+    IsExtensionSupported((char *) "GL_ARB_half_float_vertex");
+  // インスタンス描画（シェーダと頂点属性のインスタンスごとの更新が必要）
+  g_isInstancingSupported = g_isVBOSupported && IsVersionSupported(2, 0) &&
+    ( IsVersionSupported(3, 3) ||
+      ( IsExtensionSupported((char *) "GL_ARB_instanced_arrays") &&
+	IsExtensionSupported((char *) "GL_ARB_draw_instanced") ) );
+
+#ifdef WIN32
+  glGenBuffersARB = NULL;
+  glBindBufferARB = NULL;
+  glBufferDataARB = NULL;
+  glDeleteBuffersARB = NULL;
+
+  if ( g_isVBOSupported ) {
+    // printf("OpenGL : 頂点バッファをサポートしているので使用します\n");
+    // GL 関数のポインタを所得する
+    glGenBuffersARB = (PFNGLGENBUFFERSARBPROC) wglGetProcAddress("glGenBuffersARB");
+    glBindBufferARB = (PFNGLBINDBUFFERARBPROC) wglGetProcAddress("glBindBufferARB");
+    glBufferDataARB = (PFNGLBUFFERDATAARBPROC) wglGetProcAddress("glBufferDataARB");
+    glDeleteBuffersARB = (PFNGLDELETEBUFFERSARBPROC) wglGetProcAddress("glDeleteBuffersARB");
+  }
+  glGenVertexArrays = NULL;
+  glBindVertexArray = NULL;
+  glDeleteVertexArrays = NULL;
+
+  if ( g_isVAOSupported ) {
+    glGenVertexArrays = (PFNGLGENVERTEXARRAYSPROC) wglGetProcAddress("glGenVertexArrays");
+    glBindVertexArray = (PFNGLBINDVERTEXARRAYPROC) wglGetProcAddress("glBindVertexArray");
+    glDeleteVertexArrays = (PFNGLDELETEVERTEXARRAYSPROC) wglGetProcAddress("glDeleteVertexArrays");
+    if ( !glGenVertexArrays || !glBindVertexArray || !glDeleteVertexArrays )
+      g_isVAOSupported = 0;
+  }
+  // シェーダ関係の関数のポインタは取得していないのでインスタンス描画は使わない
+  g_isInstancingSupported = 0;
+#endif
+
+  // インスタンス描画用のシェーダプログラムとバッファ
+  if ( g_isInstancingSupported ) mqoMakeInstanceProgram();
+
+  // 初期化フラグ
+  l_GLMetaseqInitialized = 1;
+}
+
+
+/*=========================================================================
+  【関数】mqoSetVertexCacheOptimization
+  【用途】読み込み時に頂点キャッシュ向けの並べ替えを行うかどうかを設定する
+  【引数】
+  enable	0：行わない，その他：行う（初期値）
+
+  【戻値】なし
+  =========================================================================*/
+
+void mqoSetVertexCacheOptimization(int enable)
+{
+  l_optimizeVertexCache = ( enable != 0 );
+}
+
+
+/*=========================================================================
+  【関数】mqoSetLODLevels
+  【用途】読み込み時に作る詳細度の段階の数を設定する
+  【引数】
+  levels	元のメッシュを含む段階の数（1〜MQO_MAX_LOD，初期値は MQO_MAX_LOD）
+  1の時は作らない
+
+  【戻値】なし
+  =========================================================================*/
+
+void mqoSetLODLevels(int levels)
+{
+  if ( levels < 1 ) levels = 1;
+  if ( levels > MQO_MAX_LOD ) levels = MQO_MAX_LOD;
+  l_lodLevels = levels;
+}
+
+
+/*=========================================================================
+  【関数】mqoSetLoadReport
+  【用途】読み込み時に頂点データのメモリ量，ACMR，詳細度の段階ごとの
+  三角形の数を表示するかどうかを設定する
+  【引数】
+  enable	0：表示しない（初期値），その他：表示する
+
+  【戻値】なし
+  =========================================================================*/
+
+void mqoSetLoadReport(int enable)
+{
+  l_reportLoad = ( enable != 0 );
+}
+
+
+/*=========================================================================
+  【関数】mqoCompileShader
+  【用途】シェーダをコンパイルする
+  【引数】
+  type	シェーダの種類（GL_VERTEX_SHADER / GL_FRAGMENT_SHADER）
+  source	ソース
+
+  【戻値】シェーダ（失敗した時は0）
+  =========================================================================*/
+
+static GLuint mqoCompileShader(GLenum type, const char *source)
+{
+  GLuint	shader;
+  GLint	status;
+  char	log[1024];
+
+  shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, NULL);
+  glCompileShader(shader);
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if ( status == GL_FALSE ) {
+    glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+    printf("OpenGL : シェーダのコンパイルに失敗しました\n%s\n", log);
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+
+
+/*=========================================================================
+  【関数】mqoMakeInstanceProgram
+  【用途】インスタンス描画用のシェーダプログラムと行列のバッファを作る
+  【引数】なし
+  【戻値】なし
+  【仕様】失敗した時は g_isInstancingSupported を0にする（1つずつ描画する）
+  =========================================================================*/
+
+void mqoMakeInstanceProgram(void)
+{
+  GLuint	vs, fs;
+  GLint	status;
+
+  vs = mqoCompileShader(GL_VERTEX_SHADER, l_instanceVertexShader);
+  fs = mqoCompileShader(GL_FRAGMENT_SHADER, l_instanceFragmentShader);
+  if ( vs == 0 || fs == 0 ) {
+    if ( vs != 0 ) glDeleteShader(vs);
+    if ( fs != 0 ) glDeleteShader(fs);
+    g_isInstancingSupported = 0;
+    return;
+  }
+
+  l_instanceProgram = glCreateProgram();
+  glAttachShader(l_instanceProgram, vs);
+  glAttachShader(l_instanceProgram, fs);
+  // 行列は4つの連続した頂点属性を使う（固定機能の属性と重ならない番号）
+  glBindAttribLocation(l_instanceProgram, MQO_INSTANCE_ATTRIB, "instanceMatrix");
+  glLinkProgram(l_instanceProgram);
+  glDeleteShader(vs);
+  glDeleteShader(fs);
+  glGetProgramiv(l_instanceProgram, GL_LINK_STATUS, &status);
+  if ( status == GL_FALSE ) {
+    printf("OpenGL : シェーダのリンクに失敗しました\n");
+    glDeleteProgram(l_instanceProgram);
+    l_instanceProgram = 0;
+    g_isInstancingSupported = 0;
+    return;
+  }
+
+  l_uniformUseTexture = glGetUniformLocation(l_instanceProgram, "useTexture");
+  l_uniformQCenter    = glGetUniformLocation(l_instanceProgram, "qcenter");
+  l_uniformQScale     = glGetUniformLocation(l_instanceProgram, "qscale");
+  glUseProgram(l_instanceProgram);
+  glUniform1i(glGetUniformLocation(l_instanceProgram, "tex"), 0);
+  glUseProgram(0);
+
+  glGenBuffersARB(1, &l_instanceVBO);
+}
+
+
+/*=========================================================================
+  【関数】mqoCleanup
+  【用途】メタセコイアローダの終了処理
+  【引数】なし
+  【戻値】なし
+  =========================================================================*/
+
+void mqoCleanup(void)
+{
+  mqoClearTexturePool();	// テクスチャプールのクリア
+
+  // インスタンス描画用のシェーダプログラムとバッファの削除
+  if ( l_instanceProgram != 0 ) {
+    glDeleteProgram(l_instanceProgram);
+    l_instanceProgram = 0;
+  }
+  if ( l_instanceVBO != 0 ) {
+    glDeleteBuffersARB(1, &l_instanceVBO);
+    l_instanceVBO = 0;
+  }
+  free(l_visibleMatrices);
+  free(l_visibleLevels);
+  l_visibleMatrices = NULL;
+  l_visibleLevels = NULL;
+  l_visibleCapacity = 0;
+}
+
+
+/*=========================================================================
+  【関数】mqoSetTexturePool
+  【用途】テクスチャプールにテクスチャを読み込む
+  【引数】
+  texfile		テクスチャファイル名
+  alpfile		アルファファイル名
+  alpha		アルファ
+
+  【戻値】テクスチャID
+  【仕様】テクスチャがまだ読み込まれていなければ読み込み，テクスチャ登録
+  すでに読み込まれていれば登録したものを返す.
+  =========================================================================*/
+
+GLuint mqoSetTexturePool(char *texfile, char *alpfile, unsigned char alpha ) 
+{
+  int pos;
+  GLubyte *image;
+
+  for ( pos = 0; pos < l_texPoolnum; pos++ ) {
+    if ( alpha != l_texPool[pos].alpha ) {
+      continue;
+    }
+    if ( texfile != NULL ) {
+      if ( strcmp(texfile,l_texPool[pos].texfile) != 0 ) {
+	continue;
+      }
+    }
+    if ( alpfile != NULL ) {
+      if ( strcmp(alpfile,l_texPool[pos].alpfile) != 0 ) {
+	continue;
+      }
+    }
+    break;
+  }
+  if ( pos < l_texPoolnum ) { //すでに読み込み済み
+    return  l_texPool[pos].texture_id;
+  }
+  if ( MAX_TEXTURE <= pos ) {
+    printf("%s:mqoSetTexturePool テクスチャ読み込み領域不足\n",__FILE__);
+    return -1;
+  }
+  image = mqoLoadTextureEx(texfile,alpfile,&l_texPool[pos].texsize,alpha);
+  if ( image == NULL ) {
+    return -1;
+  }
+
+  if ( texfile != NULL ) strncpy(l_texPool[pos].texfile,texfile,MAX_PATH);
+  if ( alpfile != NULL ) strncpy(l_texPool[pos].alpfile,alpfile,MAX_PATH);
+  l_texPool[pos].alpha = alpha;
+
+  if ( l_isHeadless ) {
+    // 画像を残し，テクスチャIDの代わりにプールの番号+1を使う
+    l_texPool[pos].image = image;
+    l_texPool[pos].texture_id = pos+1;
+    l_texPoolnum = pos+1;
+    return l_texPool[pos].texture_id;
+  }
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT,4);
+  glPixelStorei(GL_PACK_ALIGNMENT,4);
+  glGenTextures(1,&l_texPool[pos].texture_id);			// テクスチャを生成
+  glBindTexture(GL_TEXTURE_2D,l_texPool[pos].texture_id);	// テクスチャの割り当て
+
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, l_texPool[pos].texsize, l_texPool[pos].texsize,
+	       0, GL_RGBA, GL_UNSIGNED_BYTE, image);
+  l_texPoolnum = pos+1;
+
+  //登録すれば、読み込んだバッファは不要
+  free(image);
+  glBindTexture(GL_TEXTURE_2D,0);	// デフォルトテクスチャの割り当て
+
+  return l_texPool[pos].texture_id;
+}
+
+
+/*=========================================================================
+  【関数】mqoClearTexturePool()
+  【用途】テクスチャプールの開放
+  【引数】なし
+  【戻値】なし
+  =========================================================================*/
+
+void mqoClearTexturePool()
+{
+  int pos;
+  for ( pos = 0; pos < l_texPoolnum; pos++ ) {
+    if ( l_texPool[pos].image != NULL ) {
+      free(l_texPool[pos].image);
+    }
+    else {
+      glDeleteTextures(1, &l_texPool[pos].texture_id);	// テクスチャ情報を削除
+    }
+  }
+
+  memset(l_texPool,0,sizeof(l_texPool));
+  l_texPoolnum = 0;
+}
+
+
+/*=========================================================================
+  【関数】mqoGetTextureImage
+  【用途】テクスチャプールの画像を取得する（ソフトウェア描画用）
+  【引数】
+  texture_id	マテリアルのテクスチャID
+  size		テクスチャのサイズ（一辺の長さ）を返す
+
+  【戻値】画像（RGBA，texsize×texsize）へのポインタ．ない時はNULL
+  【仕様】GLのコンテキストなしで mqoInit を呼んだ時だけ画像を残している
+  =========================================================================*/
+
+const GLubyte *mqoGetTextureImage(GLuint texture_id, int *size)
+{
+  int pos;
+  for ( pos = 0; pos < l_texPoolnum; pos++ ) {
+    if ( l_texPool[pos].texture_id == texture_id && l_texPool[pos].image != NULL ) {
+      if ( size != NULL ) *size = l_texPool[pos].texsize;
+      return l_texPool[pos].image;
+    }
+  }
+  return NULL;
+}
+
+
+/*=========================================================================
+  【関数】mqoLoadTextureEx
+  【用途】ファイルからテクスチャ画像を作成する
+  【引数】
+  texfile		ファイル名
+  alpfile		アルファファイル名
+  tex_size	テクスチャのサイズ（一辺の長さ）を返す
+
+  【戻値】テクスチャ画像へのポインタ（失敗時はNULL）
+  【仕様】24bitビットマップ，および8,24,32bitＴＧＡ
+  サイズは「一辺が2のn乗の正方形」に限定
+  libjpeg,libpng（外部ライブラリ）が有ればJPEG,PNGの読み込み可能
+  =========================================================================*/
+
+GLubyte* mqoLoadTextureEx(char *texfile,char *alpfile,int *tex_size,unsigned char alpha)
+{
+  FILE *fp;
+  size_t namelen;
+  char ext[4];
+  char wbuf[3];
+  int isTGA;
+  int isPNG;
+  int isJPEG;
+  int other;
+  int	y,x,size;
+  int fl;
+  char *filename[2];
+  int width[2];
+  int sts;
+  STR_TGA_HEAD tgah;
+  GLubyte	*pImage, *pRead;
+
+#if DEF_USE_LIBJPEG
+  struct jpeg_decompress_struct cinfo;
+  struct jpeg_error_mgr jerr;
+  JSAMPARRAY jpegimage;
+#endif
+#if DEF_USE_LIBPNG
+  unsigned char **pngimage;
+#if 0  
+  unsigned long   pngwidth, pngheight;
+#else
+  png_uint_32	pngwidth, pngheight;
+#endif
+  int				pngdepth;
+  int             color_type;
+#endif
+
+  filename[0] = texfile;
+  filename[1] = alpfile;
+  width[0] = -1;
+  width[1] = -1;
+  pImage = NULL;
+  fp = NULL;
+  sts = 0;
+#if DEF_USE_LIBJPEG
+  jpegimage = NULL;
+#endif
+#if DEF_USE_LIBPNG
+  pngimage = NULL;
+#endif
+  size = - 1;
+  for ( fl = 0; fl < 2; fl++ ) {//テクスチャ＝fl=0    アルファ＝fl=1
+    if ( filename[fl] == NULL ) continue;
+    namelen = strlen(filename[fl]);
+    ext[0] = tolower(filename[fl][namelen-3]);
+    ext[1] = tolower(filename[fl][namelen-2]);
+    ext[2] = tolower(filename[fl][namelen-1]);
+    ext[3] = 0x00;
+    isTGA = (strcmp(ext,"tga")==0)?1:0;
+    isPNG = (strcmp(ext,"png")==0)?1:0;
+    isJPEG = (strcmp(ext,"jpg")==0)?1:0;
+    /* */
+    if ( (! isTGA) && (! isPNG) &&(! isJPEG) ) {
+      filename[fl][namelen-3] = 'b';
+      filename[fl][namelen-2] = 'm';
+      filename[fl][namelen-1] = 'p';
+    }
+    /* */
+    if ( fl == 1 ) { //アルファの読み込みはＴＧＡorＰＮＧ
+      if ( ! (isTGA || isPNG) ) {
+	printf("アルファのファイルに対応できない→%s\n",filename[fl]);
+	break;
+      }
+    }
+    if ( fp != NULL ) fclose(fp);
+    if ( (fp=fopen(filename[fl],"rb"))==NULL ) {
+      printf("%s:テクスチャ読み込みエラー[%s]\n",__FILE__,filename[fl]);
+      continue;
+    }
+    // ヘッダのロード
+    if ( isTGA ) {
+      fread(&tgah,sizeof(STR_TGA_HEAD),1,fp);
+#if DEF_IS_LITTLE_ENDIAN
+#else
+      TGAHeaderEndianConverter(&tgah);
+#endif
+      size = width[fl] = tgah.width;
+    }
+    if ( isJPEG ) {
+#if DEF_USE_LIBJPEG
+      unsigned int i;
+      cinfo.err = jpeg_std_error( &jerr );
+      jpeg_create_decompress( &cinfo );	//解凍用情報作成
+      jpeg_stdio_src( &cinfo, fp );		//読み込みファイル指定
+      jpeg_read_header( &cinfo, TRUE );	//jpegヘッダ読み込み
+      jpeg_start_decompress( &cinfo );	//解凍開始
+
+      if ( cinfo.out_color_components == 3 && cinfo.out_color_space == JCS_RGB ) {
+	if ( jpegimage != NULL ) {
+	  for (i = 0; i < cinfo.output_height; i++) free(jpegimage[i]);            // 以下２行は２次元配列を解放します
+	  free(jpegimage);
+	}
+	//読み込みデータ配列の作成
+	jpegimage = (JSAMPARRAY)malloc( sizeof( JSAMPROW ) * cinfo.output_height );
+	for ( i = 0; i < cinfo.output_height; i++ ) {
+	  jpegimage[i] = (JSAMPROW)malloc( sizeof( JSAMPLE ) * cinfo.out_color_components * cinfo.output_width );
+	}
+	//解凍データ読み込み
+	while( cinfo.output_scanline < cinfo.output_height ) {
+	  jpeg_read_scanlines( &cinfo,
+			       jpegimage + cinfo.output_scanline,
+			       cinfo.output_height - cinfo.output_scanline
+			       );
+	}
+	size = width[fl] = cinfo.output_width;
+      }
+
+      jpeg_finish_decompress( &cinfo );	//解凍終了
+      jpeg_destroy_decompress( &cinfo );	//解凍用情報解放
+      if ( !(cinfo.out_color_components == 3 && cinfo.out_color_space == JCS_RGB) ) {
+	printf("JPEG 対応できないフォーマット→%s\n",filename[fl]);
+      }
+#else
+      printf("このテクスチャは対応できないフォーマット→%s\n",filename[fl]);
+      continue;
+#endif
+    }
+    if ( isPNG ) {
+#if DEF_USE_LIBPNG
+      png_structp     png_ptr;
+      png_infop       info_ptr;
+      int             bit_depth, interlace_type;
+      unsigned int             i;
+      int j,k;
+      png_ptr = png_create_read_struct(                       // png_ptr構造体を確保・初期化します
+				       PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+      info_ptr = png_create_info_struct(png_ptr);             // info_ptr構造体を確保・初期化します
+      png_init_io(png_ptr, fp);                               // libpngにfpを知らせます
+      png_read_info(png_ptr, info_ptr);                       // PNGファイルのヘッダを読み込みます
+      png_get_IHDR(png_ptr, info_ptr, &pngwidth, &pngheight,        // IHDRチャンク情報を取得します
+		   &bit_depth, &color_type, &interlace_type,
+		   &j,&k);
+      if ( pngimage != NULL ) {
+	for (i = 0; i < pngheight; i++) free(pngimage[i]);            // 以下２行は２次元配列を解放します
+	free(pngimage);
+      }
+      pngimage = (png_bytepp)malloc(pngheight * sizeof(png_bytep)); // 以下３行は２次元配列を確保します
+      i = png_get_rowbytes(png_ptr, info_ptr);
+      pngdepth = i / pngwidth;
+      for (i = 0; i < pngheight; i++)
+	pngimage[i] = (png_bytep)malloc(png_get_rowbytes(png_ptr, info_ptr));
+      png_read_image(png_ptr, pngimage);                         // 画像データを読み込みます
+
+      png_destroy_read_struct(                                // ２つの構造体のメモリを解放します
+			      &png_ptr, &info_ptr, (png_infopp)NULL);
+      size = width[fl] = pngwidth;
+#else
+      printf("このテクスチャは対応できないフォーマット→%s\n",filename[fl]);
+      continue;
+#endif
+    }
+    if ( width[fl] == -1 ) {//ココまできてサイズが指定されていない　＝　ビットマップ
+      fseek(fp,14+4,SEEK_SET);		// 画像幅が格納されている位置までシーク
+      fread(&size,sizeof(int),1,fp);	// BiWidthの情報だけ取得
+      fseek(fp,14+40,SEEK_SET);		// 画素データが格納されている位置までシーク
+#if DEF_IS_LITTLE_ENDIAN
+#else
+      endianConverter(&size,sizeof(int));
+#endif
+      width[fl] = size;
+
+    }
+    if ( width[0] != -1 && width[1] != -1 ) {
+      if ( width[0] != width[1] ) {
+	sts = -1;
+	break;
+      }
+    }
+    if ( fl == 1 && isTGA ) { //アルファの読み込みはＴＧＡの８ビットモノクロｏｒ３２ビットフル
+      if ( !(
+	     (tgah.depth == 8 && tgah.type == DEF_TGA_TYPE_MONO) ||
+	     (tgah.depth == 32 && tgah.type == DEF_TGA_TYPE_FULL) 
+	     ) ) {
+	break;
+      }
+    }
+    if ( fl == 1 && isPNG ) { //アルファの読み込みはＰＮＧのトゥルーカラー＋アルファｏｒグレースケール＋アルファ
+#if DEF_USE_LIBPNG
+      if ( !(
+	     (color_type== 6 ) ||
+	     (color_type== 4 ) 
+	     ) ) {
+	break;
+      }
+#endif
+    }
+
+    // メモリの確保
+    if ( pImage == NULL ) {
+      pImage = (GLubyte*)malloc(sizeof(unsigned char)*size*size*4);
+    }
+    if (pImage==NULL) return NULL;
+    for (y=0; y<size; y++){
+      pRead = pImage + (size-1-y)*4*size;
+      for (x=0; x<size; x++) {
+	other = 1;
+	if ( fl == 0 ) {
+	  if ( isJPEG ) {
+#if DEF_USE_LIBJPEG
+	    pRead[0]= jpegimage[size-1-y][x*3];
+	    pRead[1]= jpegimage[size-1-y][x*3+1];
+	    pRead[2]= jpegimage[size-1-y][x*3+2];
+	    pRead[3] = alpha;				// A
+	    other = 0;
+#endif
+	  }
+	  if ( isPNG ) {
+#if DEF_USE_LIBPNG
+	    if ( color_type == 2 || color_type==6 ) { 
+	      pRead[0]= pngimage[size-1-y][x*pngdepth];
+	      pRead[1]= pngimage[size-1-y][x*pngdepth+1];
+	      pRead[2]= pngimage[size-1-y][x*pngdepth+2];
+	      pRead[3] = alpha;				// A
+	      if ( color_type == 6 ) {
+		pRead[3]= pngimage[size-1-y][x*pngdepth+3];
+	      }
+	    }
+	    other = 0;
+#endif
+	  }
+	  if ( other )  {
+	    fread(&pRead[2],1,1,fp);	// B
+	    fread(&pRead[1],1,1,fp);	// G	
+	    fread(&pRead[0],1,1,fp);	// R
+	    pRead[3] = alpha;				// A
+	    if ( isTGA && tgah.depth == 32 ) {
+	      fread(&pRead[3],1,1,fp);	// A
+	      if ( alpha < pRead[3] ) pRead[3] = alpha;
+	    }
+	  }
+	}
+	else {
+	  if ( isPNG ) {
+#if DEF_USE_LIBPNG
+	    if ( color_type == 6 ) { //トゥルーカラー＋アルファ
+	      pRead[3]= pngimage[size-1-y][x*pngdepth+3];
+	    }
+	    if ( color_type == 4 ) { //グレースケール＋アルファ
+	      pRead[3]= pngimage[size-1-y][x*pngdepth+1];
+	    }
+	    if ( alpha < pRead[3] ) pRead[3] = alpha;
+#endif
+	  }
+	  if ( isTGA ) {
+	    if ( tgah.depth == 32 ) { //いらないデータを読み飛ばす
+	      fread(wbuf,3,1,fp);	// BGR
+	    }
+	    fread(&pRead[3],1,1,fp);	// A
+	    if ( alpha < pRead[3] ) pRead[3] = alpha;
+	  }
+	}
+	pRead+=4;
+      }
+    }
+    fclose(fp);
+    fp = NULL;
+  }
+  if ( sts != 0 ) {
+    if ( pImage != NULL ) free(pImage);
+    if ( fp != NULL ) fclose(fp);
+  }
+#if DEF_USE_LIBPNG
+  if ( pngimage != NULL ) {
+    unsigned int uy;
+    for (uy = 0; uy < pngheight; uy++) free(pngimage[uy]);            // 以下２行は２次元配列を解放します
+    free(pngimage);
+  }
+#endif
+#if DEF_USE_LIBJPEG
+  if ( jpegimage != NULL ) {
+    unsigned int uy;
+    for (uy = 0; uy < cinfo.output_height; uy++) free(jpegimage[uy]);            // 以下２行は２次元配列を解放します
+    free(jpegimage);
+  }
+#endif
+  if ( size < 0 ) {
+    if ( pImage != NULL ) free(pImage);
+    pImage = NULL;
+  }
+  *tex_size = size;
+
+  return pImage;
+}
+
+
+/*=========================================================================
+  【関数】mqoLoadFile
+  【用途】メタセコイアファイル(*.mqo)からデータを読み込む
+  【引数】
+  mqoobj		MQOオブジェクト
+  filename	ファイルのパス
+  scale		拡大率
+  alpha		アルファ
+
+  【戻値】成功：1 ／ 失敗：0
+  =========================================================================*/
+
+int mqoLoadFile( MQO_OBJECT *mqoobj, char *filename, double scale, unsigned char alpha)
+{
+  FILE			*fp;
+  MQO_OBJDATA		obj[MAX_OBJECT];
+  MQO_MATDATA		*M = NULL;
+
+  char	buf[SIZE_STR];		// 文字列読み込みバッファ
+  char	path_dir[SIZE_STR];	// ディレクトリのパス
+  char	path_tex[SIZE_STR];	// テクスチャファイルのパス
+  char	path_alp[SIZE_STR];	// アルファテクスチャファイルのパス
+  int		n_mat = 0;			// マテリアル数
+  int		n_obj = 0;			// オブジェクト数
+  int		i;
+
+  // MaterialとObjectの読み込み
+  fp = fopen(filename,"rb");
+  if (fp==NULL) return 0;
+
+  mqoobj->alpha = alpha;
+  memset(obj,0,sizeof(obj));
+  l_cacheMissBefore = l_cacheMissAfter = l_cacheTriangles = 0;
+
+  i = 0;
+  while ( !feof(fp) ) {
+    fgets(buf,SIZE_STR,fp);
+
+    // Material
+    if (strstr(buf,"Material")) {
+      sscanf(buf,"Material %d", &n_mat);
+      M = (MQO_MATDATA*) calloc( n_mat, sizeof(MQO_MATDATA) );
+      mqoReadMaterial(fp,M);
+    }
+
+    // Object
+    if (strstr(buf,"Object")) {
+      sscanf(buf,"Object %s", obj[i].objname);
+      mqoReadObject(fp, &obj[i]);
+      i++;
+    }
+  }
+  n_obj = i;
+  fclose(fp);
+
+  // パスの取得
+  mqoGetDirectory(filename, path_dir);
+
+  // テクスチャの登録
+  for (i=0; i<n_mat; i++) {
+    if (M[i].useTex) {
+
+      if (strstr(M[i].texFile,":")) {
+	strcpy(path_tex, M[i].texFile);	// 絶対パスの場合
+      } else {
+	sprintf(path_tex,"%s%s",path_dir,M[i].texFile);	// 相対パスの場合
+      }
+
+      if ( M[i].alpFile[0] != (char)0 ) {
+	if (strstr(M[i].texFile,":")) {
+	  strcpy(path_alp, M[i].alpFile);	// 絶対パスの場合
+	} else {
+	  sprintf(path_alp,"%s%s",path_dir,M[i].alpFile);	// 相対パスの場合
+	}
+	M[i].texName = mqoSetTexturePool(path_tex,path_alp,alpha);
+      }
+      else {
+	M[i].texName = mqoSetTexturePool(path_tex,NULL,alpha);
+      }
+    }
+  }
+
+  mqoMakeObjectsEx( mqoobj, obj, n_obj, M, n_mat, scale, alpha );
+
+  // 描画リストの作成（描画のたびにマテリアルを並べ替えない）
+  mqoMakeDrawList( mqoobj );
+
+  // モデル全体の境界（視錐台カリング用）
+  mqoMakeModelBounds( mqoobj );
+
+  // 頂点の重複を除いて減ったメモリ量の表示
+  if ( l_reportLoad ) mqoReportMemory( mqoobj, filename );
+
+  // オブジェクトのデータの開放
+  for (i=0; i<n_obj; i++) {
+    free(obj[i].V);
+    free(obj[i].F);
+  }
+
+  // マテリアルの開放
+  free(M);
+
+  return 1;
+}
+
+
+/*=========================================================================
+  【関数】mqoCreateList
+  【用途】MQOオブジェクトを指定数確保する
+  【引数】num		MQOオブジェクトの数
+
+  【戻値】MQOオブジェクト
+  =========================================================================*/
+
+MQO_OBJECT* mqoCreateList(int num)
+{
+  MQO_OBJECT *obj;
+
+  // 初期化されてなかったら初期化
+  if ( ! l_GLMetaseqInitialized ) mqoInit();
+
+  // 領域確保と初期化
+  obj = (MQO_OBJECT *)malloc(sizeof(MQO_OBJECT)*num);
+  memset(obj, 0, sizeof(MQO_OBJECT)*num);
+
+  return obj;
+}
+
+
+/*=========================================================================
+  【関数】mqoCreateListObject
+  【用途】メタセコイアファイル(*.mqo)からMQOオブジェクト配列を作成する
+
+  【引数】mqoobj		MQOオブジェクト
+  i			読み込み先番号（i番目にMQOファイルを読み込む）
+  filename	ファイルのパス
+  scale		拡大率
+  alpha		アルファ指定（全体のアルファ値を指定（0〜255））
+
+  【戻値】ステータス　負：異常　０：正常
+  =========================================================================*/
+
+int mqoCreateListObject(MQO_OBJECT *mqoobj, int i, char *filename, double scale, unsigned char alpha )
+{
+  int ret;
+  ret = 0;
+  if ( mqoobj == (MQO_OBJECT *)NULL ) return -1;
+  if (! mqoLoadFile(&mqoobj[i], filename, scale, alpha)) ret = -1; 
+  return ret;
+}
+
+
+/*=========================================================================
+  【関数】mqoSetCapability
+  【用途】GLの機能の有効/無効を，覚えている状態と違う場合だけ切り替える
+  【引数】
+  cap		機能（GL_BLEND など）
+  current	覚えている状態（更新される）
+  enable	0：無効，その他：有効
+
+  【戻値】なし
+  =========================================================================*/
+
+static void mqoSetCapability(GLenum cap, int *current, int enable)
+{
+  enable = ( enable != 0 );
+  if ( *current == enable ) return;
+  if ( enable ) glEnable(cap);
+  else          glDisable(cap);
+  *current = enable;
+}
+
+
+/*=========================================================================
+  【関数】mqoSetClientState
+  【用途】クライアント側の配列の有効/無効を，覚えている状態と違う場合だけ切り替える
+  【引数】
+  array	配列（GL_VERTEX_ARRAY など）
+  current	覚えている状態（更新される）
+  enable	0：無効，その他：有効
+
+  【戻値】なし
+  =========================================================================*/
+
+static void mqoSetClientState(GLenum array, int *current, int enable)
+{
+  enable = ( enable != 0 );
+  if ( *current == enable ) return;
+  if ( enable ) glEnableClientState(array);
+  else          glDisableClientState(array);
+  *current = enable;
+}
+
+
+/*=========================================================================
+  【関数】mqoRestoreState
+  【用途】モデルの描画で変更したGLの状態をOpenGLの初期値に戻す
+  【引数】
+  state	描画中に覚えておいた状態
+
+  【戻値】なし
+  =========================================================================*/
+
+static void mqoRestoreState(MQO_GL_STATE *state)
+{
+  const MQO_GL_STATE *def = &l_defaultGLState;
+
+  if ( state->vao != def->vao ) {
+    glBindVertexArray( def->vao );
+    state->vao = def->vao;
+  }
+  if ( state->vbo != def->vbo ) {
+    glBindBufferARB( GL_ARRAY_BUFFER_ARB, def->vbo );
+    state->vbo = def->vbo;
+  }
+  if ( state->ibo != def->ibo ) {
+    glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, def->ibo );
+    state->ibo = def->ibo;
+  }
+  mqoSetClientState(GL_VERTEX_ARRAY, &state->vertexArray, def->vertexArray);
+  mqoSetClientState(GL_NORMAL_ARRAY, &state->normalArray, def->normalArray);
+  mqoSetClientState(GL_TEXTURE_COORD_ARRAY, &state->texCoordArray, def->texCoordArray);
+  if ( state->texture != def->texture ) {
+    glBindTexture(GL_TEXTURE_2D, def->texture);
+    state->texture = def->texture;
+  }
+  mqoSetCapability(GL_TEXTURE_2D, &state->texture2D, def->texture2D);
+  mqoSetCapability(GL_BLEND, &state->blend, def->blend);
+  mqoSetCapability(GL_NORMALIZE, &state->normalize, def->normalize);
+  if ( state->shadeModel != def->shadeModel ) {
+    glShadeModel(def->shadeModel);
+    state->shadeModel = def->shadeModel;
+  }
+  if ( state->frontFace != def->frontFace ) {
+    glFrontFace(def->frontFace);
+    state->frontFace = def->frontFace;
+  }
+}
+
+
+/*=========================================================================
+  【関数】mqoVertexSize
+  【用途】マテリアルの頂点配列の1頂点あたりのバイト数を返す
+  【引数】
+  mat		マテリアル
+
+  【戻値】バイト数
+  =========================================================================*/
+
+static size_t mqoVertexSize(const MQO_MATERIAL *mat)
+{
+  if ( mat->isPacked ) {
+    return mat->isUseTexture ? sizeof(VERTEX_TEXUSE_PACKED) : sizeof(VERTEX_NOTEX_PACKED);
+  }
+  return mat->isUseTexture ? sizeof(VERTEX_TEXUSE) : sizeof(VERTEX_NOTEX);
+}
+
+
+/*=========================================================================
+  【関数】mqoVertexData
+  【用途】マテリアルの描画に使う頂点配列の先頭アドレスを返す
+  【引数】
+  mat		マテリアル
+
+  【戻値】頂点配列の先頭アドレス
+  =========================================================================*/
+
+static void *mqoVertexData(const MQO_MATERIAL *mat)
+{
+  if ( mat->isPacked ) return mat->vertex_q;
+  return mat->isUseTexture ? (void *)mat->vertex_t : (void *)mat->vertex_p;
+}
+
+
+/*=========================================================================
+  【関数】mqoCompareDrawItem
+  【用途】描画リストの並べ替えの比較関数
+  【仕様】半透明のマテリアルを後に，その中ではテクスチャ（なしが先），
+  シェーディング，読み込み時の順番の順に並べる
+  =========================================================================*/
+
+static int mqoCompareDrawItem(const void *a, const void *b)
+{
+  const MQO_DRAW_ITEM *p = (const MQO_DRAW_ITEM *)a;
+  const MQO_DRAW_ITEM *q = (const MQO_DRAW_ITEM *)b;
+  int pt, qt;
+  GLuint ptex, qtex;
+
+  pt = ( p->mat->color[3] < 1.0f || ( p->mat->isValidMaterialInfo && p->mat->dif[3] < 1.0f ) );
+  qt = ( q->mat->color[3] < 1.0f || ( q->mat->isValidMaterialInfo && q->mat->dif[3] < 1.0f ) );
+  if ( pt != qt ) return pt - qt;
+
+  ptex = p->mat->isUseTexture ? p->mat->texture_id : 0;
+  qtex = q->mat->isUseTexture ? q->mat->texture_id : 0;
+  if ( ptex != qtex ) return ( ptex < qtex ) ? -1 : 1;
+
+  if ( p->obj->isShadingFlat != q->obj->isShadingFlat )
+    return p->obj->isShadingFlat - q->obj->isShadingFlat;
+
+  return p->order - q->order;
+}
+
+
+/*=========================================================================
+  【関数】mqoMakeDrawList
+  【用途】MQOオブジェクトの描画リストを作成する
+  【引数】
+  mqoobj	MQOオブジェクト（内部オブジェクトは作成済みであること）
+
+  【戻値】なし
+  【仕様】頂点のあるマテリアルをすべて集め，テクスチャの切り替えが
+  少なくなるように並べておく（半透明のマテリアルは最後にまとめる）．
+  詳細度の段階の数（マテリアルの最大）もここで求める
+  =========================================================================*/
+
+void mqoMakeDrawList(MQO_OBJECT *mqoobj)
+{
+  int o, m, n;
+
+  if ( mqoobj->drawlist != NULL ) {
+    free(mqoobj->drawlist);
+    mqoobj->drawlist = NULL;
+  }
+  mqoobj->drawnum = 0;
+  mqoobj->lodnum = 1;
+
+  n = 0;
+  for ( o = 0; o < mqoobj->objnum; o++ ) {
+    for ( m = 0; m < mqoobj->obj[o].matnum; m++ ) {
+      if ( mqoobj->obj[o].mat[m].datanum <= 0 ) continue;
+      if ( mqoobj->obj[o].mat[m].lodnum > mqoobj->lodnum ) mqoobj->lodnum = mqoobj->obj[o].mat[m].lodnum;
+      n++;
+    }
+  }
+  if ( n == 0 ) return;
+
+  mqoobj->drawlist = (MQO_DRAW_ITEM *)malloc(sizeof(MQO_DRAW_ITEM)*n);
+  n = 0;
+  for ( o = 0; o < mqoobj->objnum; o++ ) {
+    for ( m = 0; m < mqoobj->obj[o].matnum; m++ ) {
+      if ( mqoobj->obj[o].mat[m].datanum <= 0 ) continue;
+      mqoobj->drawlist[n].obj   = &mqoobj->obj[o];
+      mqoobj->drawlist[n].mat   = &mqoobj->obj[o].mat[m];
+      mqoobj->drawlist[n].order = n;
+      n++;
+    }
+  }
+  qsort(mqoobj->drawlist, n, sizeof(MQO_DRAW_ITEM), mqoCompareDrawItem);
+  mqoobj->drawnum = n;
+}
+
+
+/*=========================================================================
+  【関数】mqoMakeObjectBounds
+  【用途】内部オブジェクトの面の頂点から境界を求める
+  【引数】
+  b		境界（出力）
+  F		面配列
+  fnum	面数
+  V		頂点配列
+  scale	拡大率
+
+  【戻値】なし
+  【仕様】描画する面（マテリアルが設定された三角形と四角形）の頂点だけを使う．
+  球の中心は直方体の中心とし，半径は中心から最も遠い頂点までの距離にする
+  =========================================================================*/
+
+static void mqoMakeObjectBounds(MQO_BOUNDS *b, MQO_FACE F[], int fnum, glPOINT3f V[], double scale)
+{
+  GLfloat	p[3], r2, d;
+  int		f, i, k, pass;
+
+  b->radius = -1.0f;
+  r2 = 0.0f;
+  for ( pass = 0; pass < 2; pass++ ) {	// 1回目は直方体，2回目は球の半径
+    for ( f = 0; f < fnum; f++ ) {
+      if ( F[f].m < 0 || ( F[f].n != 3 && F[f].n != 4 ) ) continue;
+      for ( i = 0; i < F[f].n; i++ ) {
+	p[0] = (GLfloat)(V[F[f].v[i]].x*scale);
+	p[1] = (GLfloat)(V[F[f].v[i]].y*scale);
+	p[2] = (GLfloat)(V[F[f].v[i]].z*scale);
+	if ( pass == 0 ) {
+	  for ( k = 0; k < 3; k++ ) {
+	    if ( b->radius < 0.0f || p[k] < b->min[k] ) b->min[k] = p[k];
+	    if ( b->radius < 0.0f || p[k] > b->max[k] ) b->max[k] = p[k];
+	  }
+	  b->radius = 0.0f;
+	}
+	else {
+	  d = 0.0f;
+	  for ( k = 0; k < 3; k++ ) d += (p[k] - b->center[k])*(p[k] - b->center[k]);
+	  if ( d > r2 ) r2 = d;
+	}
+      }
+    }
+    if ( b->radius < 0.0f ) return;	// 描画する面がない
+    if ( pass == 0 ) {
+      for ( k = 0; k < 3; k++ ) b->center[k] = (b->min[k] + b->max[k])*0.5f;
+    }
+  }
+  b->radius = (GLfloat)sqrt(r2);
+}
+
+
+/*=========================================================================
+  【関数】mqoMakeModelBounds
+  【用途】内部オブジェクトの境界を合わせてモデル全体の境界を求める
+  【引数】
+  mqoobj	MQOオブジェクト
+
+  【戻値】なし
+  =========================================================================*/
+
+void mqoMakeModelBounds(MQO_OBJECT *mqoobj)
+{
+  MQO_BOUNDS	*b = &mqoobj->bounds;
+  const MQO_BOUNDS	*ob;
+  GLfloat		d, r;
+  int			o, k;
+
+  b->radius = -1.0f;
+  for ( o = 0; o < mqoobj->objnum; o++ ) {
+    ob = &mqoobj->obj[o].bounds;
+    if ( ob->radius < 0.0f ) continue;
+    for ( k = 0; k < 3; k++ ) {
+      if ( b->radius < 0.0f || ob->min[k] < b->min[k] ) b->min[k] = ob->min[k];
+      if ( b->radius < 0.0f || ob->max[k] > b->max[k] ) b->max[k] = ob->max[k];
+    }
+    b->radius = 0.0f;
+  }
+  if ( b->radius < 0.0f ) return;
+
+  for ( k = 0; k < 3; k++ ) b->center[k] = (b->min[k] + b->max[k])*0.5f;
+  // 各オブジェクトの球を含む球
+  for ( o = 0; o < mqoobj->objnum; o++ ) {
+    ob = &mqoobj->obj[o].bounds;
+    if ( ob->radius < 0.0f ) continue;
+    d = 0.0f;
+    for ( k = 0; k < 3; k++ ) d += (ob->center[k] - b->center[k])*(ob->center[k] - b->center[k]);
+    r = (GLfloat)sqrt(d) + ob->radius;
+    if ( r > b->radius ) b->radius = r;
+  }
+}
+
+
+/*=========================================================================
+  【関数】mqoIsBoundsVisible
+  【用途】境界が視錐台に入るかどうかを調べる
+  【引数】
+  b		境界
+  matrix	モデルビュー行列（列優先）
+
+  【戻値】1：入る（一部でも），0：入らない
+  【仕様】視錐台の平面をモデルの座標系に移して調べる．球が平面の外側に
+  あれば入らない，内側にあれば次の平面へ進み，交わる時だけ直方体で調べる
+  =========================================================================*/
+
+static int mqoIsBoundsVisible(const MQO_BOUNDS *b, const GLfloat *matrix)
+{
+  const GLfloat	*p;
+  GLfloat			q[4], len, d, e;
+  int				i, j;
+
+  if ( b->radius < 0.0f ) return 0;
+  for ( i = 0; i < 6; i++ ) {
+    p = l_frustum[i];
+    for ( j = 0; j < 4; j++ ) {	// 平面に行列を右から掛ける
+      q[j] = p[0]*matrix[4*j] + p[1]*matrix[4*j+1] + p[2]*matrix[4*j+2] + p[3]*matrix[4*j+3];
+    }
+    len = (GLfloat)sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2]);
+    d = q[0]*b->center[0] + q[1]*b->center[1] + q[2]*b->center[2] + q[3];
+    if ( d < -b->radius*len ) return 0;
+    if ( d >= b->radius*len ) continue;
+    e = (GLfloat)( fabs(q[0])*(b->max[0] - b->min[0]) +
+		   fabs(q[1])*(b->max[1] - b->min[1]) +
+		   fabs(q[2])*(b->max[2] - b->min[2]) )*0.5f;
+    if ( d + e < 0.0f ) return 0;
+  }
+  return 1;
+}
+
+
+/*=========================================================================
+  【関数】mqoIsBoundsVisibleAny
+  【用途】境界がいずれかの行列で視錐台に入るかどうかを調べる
+  【引数】
+  b			境界
+  matrices	モデルビュー行列（16個ずつ）
+  count		行列の数
+
+  【戻値】1：入る，0：どの行列でも入らない
+  =========================================================================*/
+
+static int mqoIsBoundsVisibleAny(const MQO_BOUNDS *b, const GLfloat *matrices, int count)
+{
+  int i;
+
+  for ( i = 0; i < count; i++ ) {
+    if ( mqoIsBoundsVisible(b, matrices + 16*i) ) return 1;
+  }
+  return 0;
+}
+
+
+/*=========================================================================
+  【関数】mqoReportMemory
+  【用途】インデックス化（と量子化）で減った頂点データのメモリ量と，
+  頂点キャッシュ向けの並べ替えの前後の ACMR と，詳細度の段階ごとの三角形の数を表示する
+  【引数】
+  mqoobj	MQOオブジェクト
+  filename	ファイル名（表示用）
+
+  【戻値】なし
+  【仕様】面ごとに頂点を展開した場合（インデックスなし）と比べる．
+  段階ごとの三角形の数は，その段階で描画する数（段階の少ないマテリアルは最後の段階）
+  =========================================================================*/
+
+void mqoReportMemory(MQO_OBJECT *mqoobj, const char *filename)
+{
+  MQO_MATERIAL	*mat;
+  size_t		before = 0, after = 0, vsize, isize;
+  long			tris[MQO_MAX_LOD];
+  int			o, m, l;
+
+  memset(tris, 0, sizeof(tris));
+  for ( o = 0; o < mqoobj->objnum; o++ ) {
+    for ( m = 0; m < mqoobj->obj[o].matnum; m++ ) {
+      mat = &mqoobj->obj[o].mat[m];
+      if ( mat->datanum <= 0 ) continue;
+      vsize = mat->isUseTexture ? sizeof(VERTEX_TEXUSE) : sizeof(VERTEX_NOTEX);
+      isize = (mat->indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+      before += (size_t)mat->datanum*vsize;
+      after  += (size_t)mat->vertnum*mqoVertexSize(mat) + (size_t)mat->indexnum*isize;
+      for ( l = 0; l < mqoobj->lodnum; l++ ) {
+	tris[l] += mat->lodcount[(l < mat->lodnum) ? l : mat->lodnum-1]/3;
+      }
+    }
+  }
+  if ( before == 0 ) return;
+  printf("MQOファイル読み込み：%s 頂点データ %.1f KB -> %.1f KB (%.1f KB 削減)\n",
+	 filename, before/1024.0, after/1024.0, ((double)before - (double)after)/1024.0);
+  if ( l_cacheTriangles > 0 ) {
+    printf("MQOファイル読み込み：%s ACMR %.3f -> %.3f (FIFO %d)\n", filename,
+	   (double)l_cacheMissBefore/l_cacheTriangles,
+	   (double)l_cacheMissAfter/l_cacheTriangles, MQO_FIFO_SIZE);
+  }
+  if ( mqoobj->lodnum > 1 ) {
+    printf("MQOファイル読み込み：%s 詳細度 %d 段階 三角形", filename, mqoobj->lodnum);
+    for ( l = 0; l < mqoobj->lodnum; l++ ) printf(" %ld", tris[l]);
+    printf("\n");
+  }
+}
+
+
+/*=========================================================================
+  【関数】mqoSetInstanceAttrib
+  【用途】インスタンスごとの行列の頂点属性を有効/無効にする
+  【引数】
+  state	GLの状態
+  enable	1：行列のバッファを結びつけて有効にする，0：無効にする
+
+  【戻値】なし
+  【備考】頂点配列オブジェクトを結びつけている時はその中に記録されるので，
+  描画が終わったら無効にして元の設定に戻す
+  =========================================================================*/
+
+static void mqoSetInstanceAttrib(MQO_GL_STATE *state, int enable)
+{
+  GLuint	c;
+
+  if ( enable ) {
+    if ( state->vbo != l_instanceVBO ) {
+      glBindBufferARB( GL_ARRAY_BUFFER_ARB, l_instanceVBO );
+      state->vbo = l_instanceVBO;
+    }
+  }
+  for ( c = 0; c < 4; c++ ) {	// 行列の列ごとに1つの属性
+    if ( enable ) {
+      glVertexAttribPointer( MQO_INSTANCE_ATTRIB+c, 4, GL_FLOAT, GL_FALSE,
+			     sizeof(GLfloat)*16, (const GLvoid *)(sizeof(GLfloat)*4*c) );
+      glVertexAttribDivisorARB( MQO_INSTANCE_ATTRIB+c, 1 );
+      glEnableVertexAttribArray( MQO_INSTANCE_ATTRIB+c );
+    }
+    else {
+      glDisableVertexAttribArray( MQO_INSTANCE_ATTRIB+c );
+    }
+  }
+}
+
+
+/*=========================================================================
+  【関数】mqoDrawObject
+  【用途】MQOオブジェクトを描画する
+  【引数】
+  mqoobj		MQOオブジェクト
+  matrices	描画する位置のモデルビュー行列（16個ずつ，カリング用．NULLの時は調べない）
+  count		行列の数
+  instanced	0：現在のモデルビュー行列で1つ描画する
+  1：count 個のインスタンス描画（行列は l_instanceVBO に転送済みであること）
+  lod			詳細度の段階（0が元のメッシュ．段階の少ないマテリアルは最後の段階）
+
+  【戻値】なし
+  【備考】描画リストの順に描画する．GLの状態はCPU側で覚えておき，
+  変わるときだけ設定する（glGet* による問い合わせは行わない）．
+  描画前の状態はOpenGLの初期値（テクスチャ・半透明合成は無効など）とみなし，
+  描画後はその状態に戻す．視錐台カリングが有効で行列がある時は，
+  どの行列でも視錐台に入らない内部オブジェクトを描画しない
+  =========================================================================*/
+
+static void mqoDrawObject(MQO_OBJECT *mqoobj, const GLfloat *matrices, int count, int instanced,
+			 int lod)
+{
+
+  MQO_INNER_OBJECT	*obj;
+  MQO_MATERIAL		*mat;
+  MQO_GL_STATE		state;
+  GLfloat				matenv[4];
+  GLenum				shadeModel;
+  GLuint				vbo;
+  const char			*first;
+
+  int		i, instances, level, isize;
+  double	dalpha;
+
+  instances = instanced ? count : 0;
+  if ( ! l_isFrustumCulling ) matrices = NULL;
+
+  // 描画前の状態はOpenGLの初期値とみなす（glGet* で問い合わせない）
+  state = l_defaultGLState;
+
+  //メタセコは頂点の並びが表面からみて右回り
+  glFrontFace(GL_CW);
+  state.frontFace = GL_CW;
+  dalpha = (double)mqoobj->alpha/(double)255;
+
+  // インスタンス描画は行列と量子化の復元をシェーダで行う
+  if ( instances > 0 ) glUseProgram( l_instanceProgram );
+
+  // すべてのマテリアルで半透明合成を使う
+  mqoSetCapability(GL_BLEND, &state.blend, 1);
+  glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+  state.blendFunc = 1;
+
+  for ( i = 0; i < mqoobj->drawnum; i++ ) {	// 描画リストのループ（テクスチャ順）
+
+    obj = mqoobj->drawlist[i].obj;
+    mat = mqoobj->drawlist[i].mat;
+    if ( ! obj->isVisible ) continue;
+    if ( matrices != NULL && ! mqoIsBoundsVisibleAny(&obj->bounds, matrices, count) ) continue;
+
+    shadeModel = (obj->isShadingFlat) ? GL_FLAT : GL_SMOOTH;
+    if ( state.shadeModel != shadeModel ) {
+      glShadeModel(shadeModel);
+      state.shadeModel = shadeModel;
+    }
+
+    if ( mat->isValidMaterialInfo ) {	// マテリアルの情報設定
+      memcpy(matenv,mat->dif,sizeof(matenv));
+      matenv[3] *= dalpha;
+      glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, matenv);
+      memcpy(matenv,mat->amb,sizeof(matenv));
+      matenv[3] *= dalpha;
+      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, matenv);
+      memcpy(matenv,mat->spc,sizeof(matenv));
+      matenv[3] *= dalpha;
+      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, matenv);
+      memcpy(matenv,mat->emi,sizeof(matenv));
+      matenv[3] *= dalpha;
+      glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, matenv);
+      glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, mat->power);
+    }
+
+    // テクスチャ（描画リストはテクスチャ順なので切り替えは少ない）
+    mqoSetCapability(GL_TEXTURE_2D, &state.texture2D, mat->isUseTexture);
+    if ( mat->isUseTexture && state.texture != mat->texture_id ) {
+      glBindTexture(GL_TEXTURE_2D,mat->texture_id);
+      state.texture = mat->texture_id;
+    }
+
+    if ( mat->VAO_id != 0 ) {	// 頂点配列オブジェクト使用（配列の設定は作成時に済んでいる）
+      if ( state.vao != mat->VAO_id ) {
+	glBindVertexArray( mat->VAO_id );
+	state.vao = mat->VAO_id;
+      }
+    }
+    else {
+      if ( state.vao != 0 ) {
+	glBindVertexArray( 0 );
+	state.vao = 0;
+      }
+      vbo = mat->VBO_id;
+      if ( state.vbo != vbo ) {
+	glBindBufferARB( GL_ARRAY_BUFFER_ARB, vbo );
+	state.vbo = vbo;
+      }
+      if ( state.ibo != mat->IBO_id ) {
+	glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, mat->IBO_id );
+	state.ibo = mat->IBO_id;
+      }
+      mqoSetClientState(GL_VERTEX_ARRAY, &state.vertexArray, 1);
+      mqoSetClientState(GL_NORMAL_ARRAY, &state.normalArray, 1);
+      mqoSetClientState(GL_TEXTURE_COORD_ARRAY, &state.texCoordArray, mat->isUseTexture);
+      if ( vbo != 0 ) {	// 頂点バッファ使用
+	mqoSetVertexPointer( mat, (char *)NULL );	// アドレスはNULLが先頭
+      }
+      else {
+	// 頂点配列の時は、アドレスをそのまま入れる
+	mqoSetVertexPointer( mat, (char *)mqoVertexData(mat) );
+      }
+    }
+
+    // 色設定
+    glColor4f(mat->color[0],mat->color[1],mat->color[2],mat->color[3]);
+
+    // 描画する詳細度の段階のインデックスの位置
+    // （インデックスバッファがない時はインデックス配列のアドレスを渡す）
+    level = (lod < mat->lodnum) ? lod : mat->lodnum-1;
+    isize = (mat->indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+    first = (mat->IBO_id != 0) ? (const char *)NULL : (const char *)mat->index;
+    first += (size_t)mat->lodoffset[level]*isize;
+
+    if ( instances > 0 ) {
+      // インスタンス描画（マテリアルごとに1回，インデックスバッファは必ずある）
+      glUniform1i( l_uniformUseTexture, mat->isUseTexture );
+      if ( mat->isPacked ) {
+	glUniform3fv( l_uniformQCenter, 1, mat->qcenter );
+	glUniform3fv( l_uniformQScale, 1, mat->qscale );
+      }
+      else {
+	glUniform3f( l_uniformQCenter, 0.0f, 0.0f, 0.0f );
+	glUniform3f( l_uniformQScale, 1.0f, 1.0f, 1.0f );
+      }
+      mqoSetInstanceAttrib( &state, 1 );
+      glDrawElementsInstancedARB( GL_TRIANGLES, mat->lodcount[level], mat->indexType,
+				  first, instances );
+      mqoSetInstanceAttrib( &state, 0 );
+      continue;
+    }
+
+    // 量子化した座標は拡大・平行移動で元に戻す（法線はGLに正規化させる）
+    mqoSetCapability(GL_NORMALIZE, &state.normalize, mat->isPacked);
+    if ( mat->isPacked ) {
+      glPushMatrix();
+      glTranslatef(mat->qcenter[0], mat->qcenter[1], mat->qcenter[2]);
+      glScalef(mat->qscale[0], mat->qscale[1], mat->qscale[2]);
+    }
+
+    // 描画実行
+    glDrawElements( GL_TRIANGLES, mat->lodcount[level], mat->indexType, first );
+
+    if ( mat->isPacked ) glPopMatrix();
+  }
+
+  if ( instances > 0 ) glUseProgram( 0 );
+
+  // 変更した状態だけを描画前（OpenGLの初期値）に戻す
+  mqoRestoreState(&state);
+}
+
+
+/*=========================================================================
+  【関数】mqoCallListObject
+  【用途】MQOオブジェクトをOpenGLの画面上に呼び出す
+  【引数】
+  mqoobj		MQOオブジェクト配列
+  num			配列番号 (0〜）
+
+  【戻値】なし
+  =========================================================================*/
+
+void mqoCallListObject(MQO_OBJECT mqoobj[],int num)
+{
+  if ( mqoobj == NULL) return;
+  mqoDrawObject(&mqoobj[num], NULL, 0, 0, 0);
+}
+
+
+/*=========================================================================
+  【関数】mqoSetVertexPointer
+  【用途】マテリアルの頂点配列（座標・法線・UV）のアドレスを設定する
+  【引数】
+  mat		マテリアル
+  base	頂点配列の先頭アドレス（頂点バッファの時はNULL）
+
+  【戻値】なし
+  【備考】配列の有効化は呼び出し側で行う．量子化した頂点配列の座標は
+  整数のまま渡すので，描画時にモデルビュー行列で元の大きさに戻す
+  =========================================================================*/
+
+void mqoSetVertexPointer(MQO_MATERIAL *mat, char *base)
+{
+  if ( mat->isPacked ) {
+    if ( mat->isUseTexture ) {
+      glVertexPointer( 3, GL_SHORT, sizeof(VERTEX_TEXUSE_PACKED),
+		       base + offsetof(VERTEX_TEXUSE_PACKED, point) );
+      glTexCoordPointer( 2, GL_HALF_FLOAT_ARB, sizeof(VERTEX_TEXUSE_PACKED),
+			 base + offsetof(VERTEX_TEXUSE_PACKED, uv) );
+      glNormalPointer( GL_BYTE, sizeof(VERTEX_TEXUSE_PACKED),
+		       base + offsetof(VERTEX_TEXUSE_PACKED, normal) );
+    }
+    else {
+      glVertexPointer( 3, GL_SHORT, sizeof(VERTEX_NOTEX_PACKED),
+		       base + offsetof(VERTEX_NOTEX_PACKED, point) );
+      glNormalPointer( GL_BYTE, sizeof(VERTEX_NOTEX_PACKED),
+		       base + offsetof(VERTEX_NOTEX_PACKED, normal) );
+    }
+  }
+  else if ( mat->isUseTexture ) {
+    // 頂点配列を設定
+    glVertexPointer( 3, GL_FLOAT, sizeof(VERTEX_TEXUSE),
+		     base + offsetof(VERTEX_TEXUSE, point) );
+    // テクスチャ座標配列を設定
+    glTexCoordPointer( 2, GL_FLOAT, sizeof(VERTEX_TEXUSE),
+		       base + offsetof(VERTEX_TEXUSE, uv) );
+    // 法線配列を設定
+    glNormalPointer( GL_FLOAT, sizeof(VERTEX_TEXUSE),
+		     base + offsetof(VERTEX_TEXUSE, normal) );
+  }
+  else {
+    glVertexPointer( 3, GL_FLOAT, sizeof(VERTEX_NOTEX),
+		     base + offsetof(VERTEX_NOTEX, point) );
+    glNormalPointer( GL_FLOAT, sizeof(VERTEX_NOTEX),
+		     base + offsetof(VERTEX_NOTEX, normal) );
+  }
+}
+
+
+/*=========================================================================
+  【関数】mqoMakeVertexBuffer
+  【用途】マテリアルの頂点配列を頂点バッファに転送し，頂点配列オブジェクトを作る
+  【引数】
+  mat		マテリアル（頂点配列は作成済みであること）
+
+  【戻値】なし
+  【仕様】頂点バッファに対応していない場合は何もしない（描画時は頂点配列を使う）．
+  頂点配列オブジェクトには頂点バッファ上の配列の設定を記録しておくので，
+  描画時は結びつけるだけでよい．
+  =========================================================================*/
+
+void mqoMakeVertexBuffer(MQO_MATERIAL *mat)
+{
+  GLsizeiptrARB	size;
+  const GLvoid	*data;
+
+  if ( ! g_isVBOSupported || mat->datanum <= 0 ) return;
+
+  size = mat->vertnum*mqoVertexSize(mat);
+  data = mqoVertexData(mat);
+
+  glGenBuffersARB( 1, &mat->VBO_id );
+  glBindBufferARB( GL_ARRAY_BUFFER_ARB, mat->VBO_id );
+  glBufferDataARB( GL_ARRAY_BUFFER_ARB, size, data, GL_STATIC_DRAW_ARB );
+
+  if ( g_isVAOSupported ) {
+    glGenVertexArrays( 1, &mat->VAO_id );
+    glBindVertexArray( mat->VAO_id );
+  }
+
+  // インデックスバッファ（VAO を結びつけている時は VAO に記録される）
+  glGenBuffersARB( 1, &mat->IBO_id );
+  glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, mat->IBO_id );
+  glBufferDataARB( GL_ELEMENT_ARRAY_BUFFER_ARB,
+		   mat->indexnum*((mat->indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint)),
+		   mat->index, GL_STATIC_DRAW_ARB );
+
+  if ( g_isVAOSupported ) {
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_NORMAL_ARRAY );
+    if ( mat->isUseTexture ) glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+    mqoSetVertexPointer( mat, (char *)NULL );
+    glBindVertexArray( 0 );
+  }
+
+  glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, 0 );
+  glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
+}
+
+
+/*=========================================================================
+  【関数】mqoHashVertex
+  【用途】頂点データのハッシュ値（FNV-1a）を計算する
+  【引数】
+  data	頂点データ
+  size	頂点データのバイト数
+
+  【戻値】ハッシュ値
+  =========================================================================*/
+
+static unsigned int mqoHashVertex(const unsigned char *data, int size)
+{
+  unsigned int h = 2166136261u;
+  int i;
+
+  for ( i = 0; i < size; i++ ) {
+    h ^= data[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+
+/*=========================================================================
+  【関数】mqoMakeIndex
+  【用途】マテリアルの頂点配列から重複する頂点を除き，インデックス配列を作る
+  【引数】
+  mat		マテリアル（mqoMakeArray で datanum 個の頂点を作成済みであること）
+
+  【戻値】なし
+  【仕様】座標・法線・UVがすべて同じ頂点を1つにまとめる（ハッシュ表で探す）．
+  頂点配列は前に詰めて縮め，頂点数が65536以下なら16ビット，それ以上なら
+  32ビットのインデックスを使う．datanum はインデックスの数のままになる．
+  詳細度の低い段階のインデックスは後ろに続ける（indexnum が全体の数）．
+  =========================================================================*/
+
+void mqoMakeIndex(MQO_MATERIAL *mat)
+{
+  unsigned char	*data;
+  int				*table;
+  unsigned int	*remap;
+  int				vsize, tsize, n, i, h, vnum;
+  GLushort		*index16;
+  GLuint			*index32;
+
+  n = mat->datanum;
+  if ( n <= 0 ) return;
+
+  if ( mat->isUseTexture ) {
+    vsize = sizeof(VERTEX_TEXUSE);
+    data = (unsigned char *)mat->vertex_t;
+  }
+  else {
+    vsize = sizeof(VERTEX_NOTEX);
+    data = (unsigned char *)mat->vertex_p;
+  }
+
+  // ハッシュ表（開番地法，大きさは頂点数の2倍以上の2のべき乗）
+  for ( tsize = 1; tsize < 2*n; tsize <<= 1 );
+  table = (int *)malloc(sizeof(int)*tsize);
+  memset(table, 0xff, sizeof(int)*tsize);	// すべて -1
+  remap = (unsigned int *)malloc(sizeof(unsigned int)*n);
+
+  vnum = 0;
+  for ( i = 0; i < n; i++ ) {
+    h = mqoHashVertex(data + (size_t)i*vsize, vsize) & (tsize-1);
+    while ( table[h] >= 0 &&
+	    memcmp(data + (size_t)table[h]*vsize, data + (size_t)i*vsize, vsize) != 0 ) {
+      h = (h+1) & (tsize-1);
+    }
+    if ( table[h] < 0 ) {
+      // 新しい頂点は前に詰める（vnum < i なので重ならない）
+      if ( vnum != i ) memcpy(data + (size_t)vnum*vsize, data + (size_t)i*vsize, vsize);
+      table[h] = vnum;
+      vnum++;
+    }
+    remap[i] = (unsigned int)table[h];
+  }
+  free(table);
+
+  // 頂点配列を縮める
+  data = (unsigned char *)realloc(data, (size_t)vnum*vsize);
+  if ( mat->isUseTexture ) mat->vertex_t = (VERTEX_TEXUSE *)data;
+  else                     mat->vertex_p = (VERTEX_NOTEX *)data;
+  mat->vertnum = vnum;
+
+  // 頂点キャッシュの効率がよくなるように三角形と頂点を並べ替える
+  if ( l_optimizeVertexCache ) {
+    mqoOptimizeVertexCache(remap, n/3, data, vnum, vsize);
+  }
+
+  // 詳細度の低い段階（同じ頂点配列を使うインデックスを後ろに追加する）
+  mqoMakeLOD(mat, &remap, data, vnum, vsize);
+  n = mat->indexnum;
+
+  // インデックス配列
+  if ( vnum <= 65536 ) {
+    index16 = (GLushort *)malloc(sizeof(GLushort)*n);
+    for ( i = 0; i < n; i++ ) index16[i] = (GLushort)remap[i];
+    mat->index = index16;
+    mat->indexType = GL_UNSIGNED_SHORT;
+  }
+  else {
+    index32 = (GLuint *)malloc(sizeof(GLuint)*n);
+    for ( i = 0; i < n; i++ ) index32[i] = (GLuint)remap[i];
+    mat->index = index32;
+    mat->indexType = GL_UNSIGNED_INT;
+  }
+  free(remap);
+}
+
+
+/*=========================================================================
+  【関数】mqoFloatToHalf
+  【用途】float を半精度浮動小数点数（IEEE 754 binary16）に変換する
+  【引数】
+  f		値
+
+  【戻値】半精度浮動小数点数のビット列
+  【仕様】最も近い値に丸める．表せない大きな値は無限大にする
+  =========================================================================*/
+
+static GLushort mqoFloatToHalf(float f)
+{
+  union { float f; unsigned int u; } v;
+  unsigned int	sign, mant, h;
+  int				exp, shift;
+
+  v.f = f;
+  sign = (v.u >> 16) & 0x8000;
+  exp  = (int)((v.u >> 23) & 0xff) - 127 + 15;
+  mant = v.u & 0x7fffff;
+
+  if ( exp >= 31 ) return (GLushort)(sign | 0x7c00);	// 無限大
+  if ( exp <= 0 ) {	// 非正規化数（小さすぎる値は0）
+    if ( exp < -10 ) return (GLushort)sign;
+    mant |= 0x800000;
+    shift = 14 - exp;
+    h = mant >> shift;
+    if ( (mant >> (shift-1)) & 1 ) h++;
+    return (GLushort)(sign | h);
+  }
+  h = ((unsigned int)exp << 10) | (mant >> 13);
+  if ( mant & 0x1000 ) h++;	// 繰り上がりは指数部に入る
+  return (GLushort)(sign | h);
+}
+
+
+/*=========================================================================
+  【関数】mqoQuantize
+  【用途】値を最も近い整数に丸めて [-limit, limit] に収める
+  =========================================================================*/
+
+static int mqoQuantize(float x, int limit)
+{
+  int q = (int)floor(x + 0.5f);
+  if ( q >  limit ) q =  limit;
+  if ( q < -limit ) q = -limit;
+  return q;
+}
+
+
+/*=========================================================================
+  【関数】mqoPackVertices
+  【用途】マテリアルの頂点配列を量子化した形式に詰めなおす
+  【引数】
+  mat		マテリアル（mqoMakeIndex でインデックス化済みであること）
+
+  【戻値】なし
+  【仕様】座標は頂点の範囲の中心からの相対値を軸ごとに16ビット整数に，
+  法線は8ビット整数に，UVは半精度浮動小数点数にする（16バイト / 12バイト）．
+  座標の原点と大きさは qcenter, qscale に残し，描画時に行列で戻す．
+  軸ごとに拡大率が違うので，法線はあらかじめ qscale を掛けて正規化しておく
+  （行列の逆転置で元の向きに戻る）．float の頂点配列は解放する．
+  UVを半精度で渡せない環境ではテクスチャを使うマテリアルは float のままにする
+  （GLのコンテキストがない時はGLに渡さないので常に量子化する）
+  =========================================================================*/
+
+void mqoPackVertices(MQO_MATERIAL *mat)
+{
+  GLfloat				vmin[3], vmax[3], inv[3], n[3], len, half;
+  const GLfloat		*point, *normal;
+  VERTEX_NOTEX_PACKED	*q;
+  unsigned char		*dst;
+  size_t				qsize;
+  int					v, k;
+
+  if ( mat->vertnum <= 0 || mat->isPacked ) return;
+  if ( mat->isUseTexture && ! g_isHalfFloatSupported && ! l_isHeadless ) return;
+
+  // 頂点の範囲
+  for ( v = 0; v < mat->vertnum; v++ ) {
+    point = mat->isUseTexture ? mat->vertex_t[v].point : mat->vertex_p[v].point;
+    for ( k = 0; k < 3; k++ ) {
+      if ( v == 0 || point[k] < vmin[k] ) vmin[k] = point[k];
+      if ( v == 0 || point[k] > vmax[k] ) vmax[k] = point[k];
+    }
+  }
+  for ( k = 0; k < 3; k++ ) {
+    half = (vmax[k] - vmin[k])*0.5f;
+    mat->qcenter[k] = (vmax[k] + vmin[k])*0.5f;
+    mat->qscale[k]  = (half > 0.0f) ? half/32767.0f : 1.0f;
+    inv[k] = 1.0f/mat->qscale[k];
+  }
+
+  mat->isPacked = 1;
+  qsize = mqoVertexSize(mat);
+  dst = (unsigned char *)calloc(mat->vertnum, qsize);
+  for ( v = 0; v < mat->vertnum; v++ ) {
+    if ( mat->isUseTexture ) {
+      point  = mat->vertex_t[v].point;
+      normal = mat->vertex_t[v].normal;
+    }
+    else {
+      point  = mat->vertex_p[v].point;
+      normal = mat->vertex_p[v].normal;
+    }
+    // 座標と法線は2つの形式で同じ位置にある
+    q = (VERTEX_NOTEX_PACKED *)(dst + (size_t)v*qsize);
+    len = 0.0f;
+    for ( k = 0; k < 3; k++ ) {
+      q->point[k] = (GLshort)mqoQuantize((point[k] - mat->qcenter[k])*inv[k], 32767);
+      n[k] = normal[k]*mat->qscale[k];
+      len += n[k]*n[k];
+    }
+    len = (len > 0.0f) ? 1.0f/(GLfloat)sqrt(len) : 0.0f;
+    for ( k = 0; k < 3; k++ ) {
+      q->normal[k] = (GLbyte)mqoQuantize(n[k]*len*127.0f, 127);
+    }
+    if ( mat->isUseTexture ) {
+      ((VERTEX_TEXUSE_PACKED *)q)->uv[0] = mqoFloatToHalf(mat->vertex_t[v].uv[0]);
+      ((VERTEX_TEXUSE_PACKED *)q)->uv[1] = mqoFloatToHalf(mat->vertex_t[v].uv[1]);
+    }
+  }
+
+  // float の頂点配列は使わないので解放する
+  if ( mat->isUseTexture ) {
+    free(mat->vertex_t);
+    mat->vertex_t = NULL;
+  }
+  else {
+    free(mat->vertex_p);
+    mat->vertex_p = NULL;
+  }
+  mat->vertex_q = dst;
+}
+
+
+/*=========================================================================
+  【関数】mqoCountCacheMiss
+  【用途】FIFO の頂点キャッシュを想定したときのキャッシュミス数を数える
+  【引数】
+  index	インデックス配列（3つで1つの三角形）
+  n		インデックスの数
+  nvert	頂点数
+
+  【戻値】キャッシュミス数（三角形の数で割ると ACMR）
+  =========================================================================*/
+
+static long mqoCountCacheMiss(const unsigned int *index, int n, int nvert)
+{
+  int		*stamp;
+  long	misses = 0;
+  int		i;
+
+  // 頂点がキャッシュに入ったときのミス数（その後 MQO_FIFO_SIZE 回ミスすると追い出される）
+  stamp = (int *)malloc(sizeof(int)*nvert);
+  for ( i = 0; i < nvert; i++ ) stamp[i] = -MQO_FIFO_SIZE-1;
+  for ( i = 0; i < n; i++ ) {
+    if ( misses - stamp[index[i]] > MQO_FIFO_SIZE-1 ) {
+      stamp[index[i]] = (int)misses;
+      misses++;
+    }
+  }
+  free(stamp);
+  return misses;
+}
+
+
+/*=========================================================================
+  【関数】mqoVertexScore
+  【用途】頂点キャッシュ向けの並べ替えで使う頂点の評価値
+  【引数】
+  cachePos	キャッシュ内の位置（-1：キャッシュにない）
+  remaining	まだ出力していない三角形のうち，この頂点を使うものの数
+
+  【戻値】評価値（大きいほど早く出力したい）
+  【仕様】T. Forsyth, "Linear-Speed Vertex Cache Optimisation" の評価関数
+  =========================================================================*/
+
+static float mqoVertexScore(int cachePos, int remaining)
+{
+  float score = 0.0f;
+
+  if ( remaining <= 0 ) return -1.0f;	// もう使われない頂点
+
+  if ( cachePos >= 0 ) {
+    if ( cachePos < 3 ) {
+      // 直前の三角形の頂点は，同じ三角形の並びを避けるために少し下げる
+      score = 0.75f;
+    }
+    else {
+      score = 1.0f - (float)(cachePos-3)/(float)(MQO_CACHE_SIZE-3);
+      score = powf(score, 1.5f);
+    }
+  }
+  // 残りの三角形が少ない頂点を優先して片付ける
+  score += 2.0f * powf((float)remaining, -0.5f);
+  return score;
+}
+
+
+/*=========================================================================
+  【関数】mqoOptimizeVertexCache
+  【用途】頂点キャッシュのミスが少なくなるように三角形と頂点を並べ替える
+  【引数】
+  index	インデックス配列（並べ替えた結果に置き換わる）
+  ntri	三角形の数
+  data	頂点配列（並べ替えた結果に置き換わる）
+  nvert	頂点数
+  vsize	頂点データのバイト数
+
+  【戻値】なし
+  【仕様】三角形は Forsyth の方法（LRU キャッシュを想定した貪欲法）で並べ，
+  頂点は三角形で初めて使われる順に並べなおす（頂点の読み出しを連続させる）．
+  並べ替え前後のキャッシュミス数を l_cacheMissBefore, l_cacheMissAfter に加える
+  =========================================================================*/
+
+void mqoOptimizeVertexCache(unsigned int *index, int ntri, unsigned char *data,
+			    int nvert, int vsize)
+{
+  int				*triOffset, *triList, *remaining, *cachePos, *vertMap;
+  float			*vertScore, *triScore;
+  char			*added;
+  unsigned int	*order;
+  unsigned char	*tmp;
+  int				cache[MQO_CACHE_SIZE+3], newCache[MQO_CACHE_SIZE+3];
+  int				cacheNum, newNum;
+  int				i, j, k, t, v, best, scan, next;
+  float			bestScore;
+
+  if ( ntri <= 0 || nvert <= 0 ) return;
+
+  l_cacheMissBefore += mqoCountCacheMiss(index, ntri*3, nvert);
+
+  // 頂点ごとに，その頂点を使う三角形のリストを作る
+  triOffset = (int *)calloc(nvert+1, sizeof(int));
+  for ( i = 0; i < ntri*3; i++ ) triOffset[index[i]+1]++;
+  for ( v = 0; v < nvert; v++ ) triOffset[v+1] += triOffset[v];
+  remaining = (int *)calloc(nvert, sizeof(int));
+  triList = (int *)malloc(sizeof(int)*ntri*3);
+  for ( i = 0; i < ntri*3; i++ ) {
+    v = index[i];
+    triList[triOffset[v] + remaining[v]++] = i/3;
+  }
+
+  // 評価値の初期値
+  cachePos  = (int *)malloc(sizeof(int)*nvert);
+  vertScore = (float *)malloc(sizeof(float)*nvert);
+  for ( v = 0; v < nvert; v++ ) {
+    cachePos[v]  = -1;
+    vertScore[v] = mqoVertexScore(-1, remaining[v]);
+  }
+  triScore = (float *)malloc(sizeof(float)*ntri);
+  added    = (char *)calloc(ntri, sizeof(char));
+  best = 0;
+  bestScore = -1.0f;
+  for ( t = 0; t < ntri; t++ ) {
+    triScore[t] = vertScore[index[3*t]] + vertScore[index[3*t+1]] + vertScore[index[3*t+2]];
+    if ( triScore[t] > bestScore ) {
+      bestScore = triScore[t];
+      best = t;
+    }
+  }
+
+  order = (unsigned int *)malloc(sizeof(unsigned int)*ntri*3);
+  cacheNum = 0;
+  scan = 0;
+  for ( k = 0; k < ntri; k++ ) {
+    if ( best < 0 ) {
+      // キャッシュ内の頂点を使う三角形がなくなったら，まだ出力していない先頭の三角形
+      while ( added[scan] ) scan++;
+      best = scan;
+    }
+    t = best;
+    added[t] = 1;
+
+    // 三角形を出力し，各頂点の残りの三角形のリストから外す
+    for ( j = 0; j < 3; j++ ) {
+      v = index[3*t+j];
+      order[3*k+j] = v;
+      for ( i = triOffset[v]; i < triOffset[v] + remaining[v]; i++ ) {
+	if ( triList[i] == t ) {
+	  triList[i] = triList[triOffset[v] + remaining[v] - 1];
+	  break;
+	}
+      }
+      remaining[v]--;
+    }
+
+    // LRU キャッシュの更新（出力した三角形の頂点を先頭に入れる）
+    newNum = 0;
+    for ( j = 0; j < 3; j++ ) newCache[newNum++] = index[3*t+j];
+    for ( i = 0; i < cacheNum; i++ ) {
+      v = cache[i];
+      if ( v != (int)index[3*t] && v != (int)index[3*t+1] && v != (int)index[3*t+2] ) {
+	newCache[newNum++] = v;
+      }
+    }
+
+    // キャッシュ内の頂点（と追い出された頂点）の評価値を更新する
+    for ( i = 0; i < newNum; i++ ) {
+      v = newCache[i];
+      cachePos[v]  = ( i < MQO_CACHE_SIZE ) ? i : -1;
+      vertScore[v] = mqoVertexScore(cachePos[v], remaining[v]);
+    }
+
+    // それらの頂点を使う三角形の評価値を更新し，次に出力する三角形を選ぶ
+    best = -1;
+    bestScore = -1.0f;
+    for ( i = 0; i < newNum; i++ ) {
+      v = newCache[i];
+      for ( j = triOffset[v]; j < triOffset[v] + remaining[v]; j++ ) {
+	next = triList[j];
+	triScore[next] = vertScore[index[3*next]] + vertScore[index[3*next+1]]
+	  + vertScore[index[3*next+2]];
+	if ( triScore[next] > bestScore ) {
+	  bestScore = triScore[next];
+	  best = next;
+	}
+      }
+    }
+
+    cacheNum = ( newNum < MQO_CACHE_SIZE ) ? newNum : MQO_CACHE_SIZE;
+    memcpy(cache, newCache, sizeof(int)*cacheNum);
+  }
+
+  // 頂点を初めて使われる順に並べなおす
+  vertMap = (int *)malloc(sizeof(int)*nvert);
+  for ( v = 0; v < nvert; v++ ) vertMap[v] = -1;
+  next = 0;
+  for ( i = 0; i < ntri*3; i++ ) {
+    v = order[i];
+    if ( vertMap[v] < 0 ) vertMap[v] = next++;
+    index[i] = (unsigned int)vertMap[v];
+  }
+  for ( v = 0; v < nvert; v++ ) {
+    if ( vertMap[v] < 0 ) vertMap[v] = next++;	// 使われていない頂点（通常はない）
+  }
+  tmp = (unsigned char *)malloc((size_t)nvert*vsize);
+  for ( v = 0; v < nvert; v++ ) {
+    memcpy(tmp + (size_t)vertMap[v]*vsize, data + (size_t)v*vsize, vsize);
+  }
+  memcpy(data, tmp, (size_t)nvert*vsize);
+
+  l_cacheMissAfter += mqoCountCacheMiss(index, ntri*3, nvert);
+  l_cacheTriangles += ntri;
+
+  free(tmp);
+  free(vertMap);
+  free(order);
+  free(added);
+  free(triScore);
+  free(vertScore);
+  free(cachePos);
+  free(triList);
+  free(remaining);
+  free(triOffset);
+}
+
+
+/*=========================================================================
+  【型定義】詳細度の作成の作業領域
+  =========================================================================*/
+
+typedef struct {
+  const unsigned char	*data;		// 頂点配列
+  int					vsize;		// 頂点データのバイト数
+  int					*tri;		// 三角形の頂点番号（3つずつ．tri[3t] < 0 は削除済み）
+  int					ntri;		// 三角形の数（削除済みを含む）
+  int					*group;		// 頂点ごとの代表頂点（座標とUVが同じ頂点の組）
+  unsigned char		*locked;	// 代表頂点ごとの移動禁止（継ぎ目と境界）
+  double				*quadric;	// 代表頂点ごとの誤差の二次形式（10個ずつ）
+  int					*start;		// 代表頂点ごとの三角形の一覧の先頭（nvert+1 個）
+  int					*list;		// 代表頂点ごとの三角形の一覧
+  unsigned char		*mark;		// 1回の縮約の処理で変更した代表頂点
+} MQO_LOD_WORK;
+
+typedef struct {
+  int		from;		// 移動する代表頂点
+  int		to;			// 移動先の代表頂点
+  double	cost;		// 誤差
+} MQO_COLLAPSE;
+
+#define MQO_LOD_MIN_TRIANGLES	64		// 詳細度を作る最小の三角形の数
+#define MQO_LOD_MIN_REDUCTION	0.9		// 前の段階からこの割合より減らなければ段階を作らない
+
+
+/*=========================================================================
+  【関数】mqoCompareCollapse
+  【用途】縮約の候補を誤差の小さい順に並べる比較関数
+  =========================================================================*/
+
+static int mqoCompareCollapse(const void *a, const void *b)
+{
+  double ca = ((const MQO_COLLAPSE *)a)->cost;
+  double cb = ((const MQO_COLLAPSE *)b)->cost;
+  return (ca < cb) ? -1 : (ca > cb) ? 1 : 0;
+}
+
+
+/*=========================================================================
+  【関数】mqoCompareEdge
+  【用途】辺（代表頂点の組）を並べる比較関数（境界の判定用）
+  =========================================================================*/
+
+static int mqoCompareEdge(const void *a, const void *b)
+{
+  const int *ea = (const int *)a;
+  const int *eb = (const int *)b;
+  if ( ea[0] != eb[0] ) return (ea[0] < eb[0]) ? -1 : 1;
+  if ( ea[1] != eb[1] ) return (ea[1] < eb[1]) ? -1 : 1;
+  return 0;
+}
+
+
+/*=========================================================================
+  【関数】mqoQuadricError
+  【用途】誤差の二次形式 q の点 p での値（面までの距離の二乗和）を求める
+  =========================================================================*/
+
+static double mqoQuadricError(const double *q, const GLfloat *p)
+{
+  double x = p[0], y = p[1], z = p[2];
+  return q[0]*x*x + 2*q[1]*x*y + 2*q[2]*x*z + 2*q[3]*x
+    + q[4]*y*y + 2*q[5]*y*z + 2*q[6]*y
+    + q[7]*z*z + 2*q[8]*z
+    + q[9];
+}
+
+
+/*=========================================================================
+  【関数】mqoLodPoint
+  【用途】頂点の座標のアドレスを返す（どちらの頂点形式も先頭にある）
+  =========================================================================*/
+
+static const GLfloat *mqoLodPoint(const MQO_LOD_WORK *w, int v)
+{
+  return (const GLfloat *)(w->data + (size_t)v*w->vsize);
+}
+
+
+/*=========================================================================
+  【関数】mqoTriangleNormal
+  【用途】三角形の法線（正規化しない）を求める
+  =========================================================================*/
+
+static void mqoTriangleNormal(const GLfloat *a, const GLfloat *b, const GLfloat *c, double n[3])
+{
+  double u[3], v[3];
+  int k;
+
+  for ( k = 0; k < 3; k++ ) {
+    u[k] = b[k] - a[k];
+    v[k] = c[k] - a[k];
+  }
+  n[0] = u[1]*v[2] - u[2]*v[1];
+  n[1] = u[2]*v[0] - u[0]*v[2];
+  n[2] = u[0]*v[1] - u[1]*v[0];
+}
+
+
+/*=========================================================================
+  【関数】mqoCollapsePass
+  【用途】互いに重ならない辺をまとめて縮約する（誤差の小さい順）
+  【引数】
+  w		作業領域
+  cand	縮約の候補の領域（3*ntri 個）
+  nvert	頂点数
+  live	残っている三角形の数
+  target	目標の三角形の数
+
+  【戻値】縮約後の三角形の数
+  【仕様】1回の処理で変更する三角形に含まれる代表頂点は印をつけて
+  それ以上動かさないので，裏返りの判定は処理の途中でも正しい
+  =========================================================================*/
+
+static int mqoCollapsePass(MQO_LOD_WORK *w, MQO_COLLAPSE *cand, int nvert, int live, int target)
+{
+  double		q[10], cost, n0[3], n1[3];
+  const GLfloat	*p[3], *pv;
+  int			*tri = w->tri;
+  int			t, i, k, a, b, ncand, has, ok;
+  int			u = -1, v = -1;
+
+  // 代表頂点ごとの三角形の一覧
+  memset(w->start, 0, sizeof(int)*(nvert+1));
+  for ( t = 0; t < w->ntri; t++ ) {
+    if ( tri[3*t] < 0 ) continue;
+    for ( k = 0; k < 3; k++ ) w->start[w->group[tri[3*t+k]]+1]++;
+  }
+  for ( i = 0; i < nvert; i++ ) w->start[i+1] += w->start[i];
+  for ( t = 0; t < w->ntri; t++ ) {
+    if ( tri[3*t] < 0 ) continue;
+    for ( k = 0; k < 3; k++ ) w->list[w->start[w->group[tri[3*t+k]]]++] = t;
+  }
+  for ( i = nvert; i > 0; i-- ) w->start[i] = w->start[i-1];
+  w->start[0] = 0;
+
+  // 縮約の候補（辺ごとに誤差の小さい向き）
+  ncand = 0;
+  for ( t = 0; t < w->ntri; t++ ) {
+    if ( tri[3*t] < 0 ) continue;
+    for ( k = 0; k < 3; k++ ) {
+      a = w->group[tri[3*t+k]];
+      b = w->group[tri[3*t+(k+1)%3]];
+      if ( w->locked[a] && w->locked[b] ) continue;
+      for ( i = 0; i < 10; i++ ) q[i] = w->quadric[10*a+i] + w->quadric[10*b+i];
+      u = -1;
+      cost = 0.0;
+      if ( ! w->locked[a] ) {
+	u = a; v = b; cost = mqoQuadricError(q, mqoLodPoint(w, b));
+      }
+      if ( ! w->locked[b] ) {
+	double c = mqoQuadricError(q, mqoLodPoint(w, a));
+	if ( u < 0 || c < cost ) { u = b; v = a; cost = c; }
+      }
+      cand[ncand].from = u;
+      cand[ncand].to   = v;
+      cand[ncand].cost = cost;
+      ncand++;
+    }
+  }
+  qsort(cand, ncand, sizeof(MQO_COLLAPSE), mqoCompareCollapse);
+
+  memset(w->mark, 0, nvert);
+  for ( i = 0; i < ncand && live > target; i++ ) {
+    u = cand[i].from;
+    v = cand[i].to;
+    if ( w->mark[u] || w->mark[v] ) continue;
+    pv = mqoLodPoint(w, v);
+
+    // 残る三角形が裏返らないか調べる
+    ok = 1;
+    for ( k = w->start[u]; k < w->start[u+1] && ok; k++ ) {
+      t = w->list[k];
+      if ( tri[3*t] < 0 ) continue;
+      has = 0;
+      for ( a = 0; a < 3; a++ ) {
+	p[a] = mqoLodPoint(w, tri[3*t+a]);
+	if ( w->group[tri[3*t+a]] == v ) has = 1;
+      }
+      if ( has ) continue;	// 縮約で消える三角形
+      mqoTriangleNormal(p[0], p[1], p[2], n0);
+      for ( a = 0; a < 3; a++ ) {
+	if ( w->group[tri[3*t+a]] == u ) p[a] = pv;
+      }
+      mqoTriangleNormal(p[0], p[1], p[2], n1);
+      if ( n0[0]*n1[0] + n0[1]*n1[1] + n0[2]*n1[2] <= 0.0 ) ok = 0;
+    }
+    if ( ! ok ) continue;
+
+    // 縮約（u を含む三角形の頂点を v の代表頂点に置き換える）
+    for ( k = w->start[u]; k < w->start[u+1]; k++ ) {
+      t = w->list[k];
+      if ( tri[3*t] < 0 ) continue;
+      has = 0;
+      for ( a = 0; a < 3; a++ ) {
+	w->mark[w->group[tri[3*t+a]]] = 1;
+	if ( w->group[tri[3*t+a]] == v ) has = 1;
+      }
+      if ( has ) {
+	tri[3*t] = -1;
+	live--;
+	continue;
+      }
+      for ( a = 0; a < 3; a++ ) {
+	if ( w->group[tri[3*t+a]] == u ) tri[3*t+a] = v;
+      }
+    }
+    w->mark[u] = w->mark[v] = 1;
+    for ( a = 0; a < 10; a++ ) w->quadric[10*v+a] += w->quadric[10*u+a];
+  }
+  return live;
+}
+
+
+/*=========================================================================
+  【関数】mqoMakeLOD
+  【用途】インデックス化したメッシュから詳細度の低い段階を作る
+  【引数】
+  mat		マテリアル（datanum 個のインデックスがあること）
+  pindex	インデックス配列（段階を後ろに追加して置き換える）
+  data	頂点配列
+  nvert	頂点数
+  vsize	頂点データのバイト数
+
+  【戻値】なし
+  【仕様】二次誤差による辺の縮約（Garland & Heckbert）で，段階ごとに三角形を
+  およそ半分にする．縮約は頂点を隣の頂点に移すだけにするので，すべての
+  段階が同じ頂点配列を使い，インデックス配列だけが段階ごとに並ぶ．
+  座標とUVが同じ頂点は1つとして扱い（法線は移動先のものになる），
+  UVの継ぎ目とメッシュの境界の頂点は動かさない（穴があかないようにする）
+  =========================================================================*/
+
+void mqoMakeLOD(MQO_MATERIAL *mat, unsigned int **pindex, const unsigned char *data,
+		int nvert, int vsize)
+{
+  MQO_LOD_WORK		w;
+  MQO_COLLAPSE		*cand;
+  unsigned int		*index = *pindex, *out, h;
+  int					*table, *edge;
+  int					n, ntri, tsize, keysize, i, j, k, t, live, prev, target, level, pos;
+  double				nrm[3], len, d, *q;
+  const GLfloat		*p0, *p1, *p2;
+  const unsigned char	*vi, *vj;
+
+  n = mat->datanum;
+  ntri = n/3;
+  mat->indexnum = n;
+  mat->lodnum = 1;
+  mat->lodcount[0] = n;
+  mat->lodoffset[0] = 0;
+  if ( l_lodLevels <= 1 || ntri < MQO_LOD_MIN_TRIANGLES ) return;
+
+  w.data   = data;
+  w.vsize  = vsize;
+  w.ntri   = ntri;
+  w.tri    = (int *)malloc(sizeof(int)*n);
+  w.group  = (int *)malloc(sizeof(int)*nvert);
+  w.locked = (unsigned char *)calloc(nvert, 1);
+  w.mark   = (unsigned char *)malloc(nvert);
+  w.quadric = (double *)calloc((size_t)nvert*10, sizeof(double));
+  w.start  = (int *)malloc(sizeof(int)*(nvert+1));
+  w.list   = (int *)malloc(sizeof(int)*n);
+  cand = (MQO_COLLAPSE *)malloc(sizeof(MQO_COLLAPSE)*n);
+  for ( i = 0; i < n; i++ ) w.tri[i] = (int)index[i];
+
+  // 座標とUVが同じ頂点をまとめる（UVはテクスチャを使う時だけ比べる）
+  keysize = sizeof(GLfloat)*3;
+  for ( tsize = 1; tsize < 2*nvert; tsize <<= 1 );
+  table = (int *)malloc(sizeof(int)*tsize);
+  memset(table, 0xff, sizeof(int)*tsize);	// すべて -1
+  for ( i = 0; i < nvert; i++ ) {
+    vi = data + (size_t)i*vsize;
+    h = mqoHashVertex(vi, keysize);
+    if ( mat->isUseTexture ) {
+      h = h*31u + mqoHashVertex(vi + offsetof(VERTEX_TEXUSE, uv), sizeof(GLfloat)*2);
+    }
+    h &= tsize-1;
+    while ( table[h] >= 0 ) {
+      vj = data + (size_t)table[h]*vsize;
+      if ( memcmp(vi, vj, keysize) == 0 &&
+	   ( ! mat->isUseTexture ||
+	     memcmp(vi + offsetof(VERTEX_TEXUSE, uv), vj + offsetof(VERTEX_TEXUSE, uv),
+		    sizeof(GLfloat)*2) == 0 ) ) break;
+      h = (h+1) & (tsize-1);
+    }
+    if ( table[h] < 0 ) table[h] = i;
+    w.group[i] = table[h];
+  }
+
+  // 座標が同じでUVが違う代表頂点（UVの継ぎ目）は動かさない
+  memset(table, 0xff, sizeof(int)*tsize);
+  for ( i = 0; i < nvert; i++ ) {
+    if ( w.group[i] != i ) continue;
+    vi = data + (size_t)i*vsize;
+    h = mqoHashVertex(vi, keysize) & (tsize-1);
+    while ( table[h] >= 0 && memcmp(vi, data + (size_t)table[h]*vsize, keysize) != 0 ) {
+      h = (h+1) & (tsize-1);
+    }
+    if ( table[h] < 0 ) table[h] = i;
+    else w.locked[i] = w.locked[table[h]] = 1;
+  }
+  free(table);
+
+  // 1つの三角形だけが使う辺（境界）と3つ以上が使う辺の頂点は動かさない
+  edge = (int *)malloc(sizeof(int)*2*n);
+  for ( t = 0; t < ntri; t++ ) {
+    for ( k = 0; k < 3; k++ ) {
+      i = w.group[w.tri[3*t+k]];
+      j = w.group[w.tri[3*t+(k+1)%3]];
+      edge[2*(3*t+k)]   = (i < j) ? i : j;
+      edge[2*(3*t+k)+1] = (i < j) ? j : i;
+    }
+  }
+  qsort(edge, n, sizeof(int)*2, mqoCompareEdge);
+  for ( i = 0; i < n; i = j ) {
+    for ( j = i+1; j < n && mqoCompareEdge(edge+2*i, edge+2*j) == 0; j++ );
+    if ( j - i != 2 ) w.locked[edge[2*i]] = w.locked[edge[2*i+1]] = 1;
+  }
+  free(edge);
+
+  // 代表頂点ごとに周りの面の二次形式を面積で重みをつけて足す
+  for ( t = 0; t < ntri; t++ ) {
+    p0 = mqoLodPoint(&w, w.tri[3*t]);
+    p1 = mqoLodPoint(&w, w.tri[3*t+1]);
+    p2 = mqoLodPoint(&w, w.tri[3*t+2]);
+    mqoTriangleNormal(p0, p1, p2, nrm);
+    len = sqrt(nrm[0]*nrm[0] + nrm[1]*nrm[1] + nrm[2]*nrm[2]);
+    if ( len <= 0.0 ) continue;
+    nrm[0] /= len; nrm[1] /= len; nrm[2] /= len;
+    d = -(nrm[0]*p0[0] + nrm[1]*p0[1] + nrm[2]*p0[2]);
+    len *= 0.5;
+    for ( k = 0; k < 3; k++ ) {
+      q = w.quadric + 10*w.group[w.tri[3*t+k]];
+      q[0] += len*nrm[0]*nrm[0]; q[1] += len*nrm[0]*nrm[1]; q[2] += len*nrm[0]*nrm[2];
+      q[3] += len*nrm[0]*d;      q[4] += len*nrm[1]*nrm[1]; q[5] += len*nrm[1]*nrm[2];
+      q[6] += len*nrm[1]*d;      q[7] += len*nrm[2]*nrm[2]; q[8] += len*nrm[2]*d;
+      q[9] += len*d*d;
+    }
+  }
+
+  // 段階ごとに三角形を半分にして後ろに追加する（合計は元の2倍未満）
+  out = (unsigned int *)malloc(sizeof(unsigned int)*2*n);
+  memcpy(out, index, sizeof(unsigned int)*n);
+  pos = n;
+  live = prev = ntri;
+  for ( level = 1; level < l_lodLevels; level++ ) {
+    target = ntri >> level;
+    while ( live > target ) {
+      k = mqoCollapsePass(&w, cand, nvert, live, target);
+      if ( k == live ) break;	// これ以上縮約できない
+      live = k;
+    }
+    if ( live > prev*MQO_LOD_MIN_REDUCTION ) break;
+
+    mat->lodoffset[level] = pos;
+    mat->lodcount[level]  = live*3;
+    for ( t = 0; t < ntri; t++ ) {
+      if ( w.tri[3*t] < 0 ) continue;
+      for ( k = 0; k < 3; k++ ) out[pos++] = (unsigned int)w.tri[3*t+k];
+    }
+    mat->lodnum++;
+    prev = live;
+  }
+
+  free(index);
+  *pindex = (unsigned int *)realloc(out, sizeof(unsigned int)*pos);
+  mat->indexnum = pos;
+
+  free(w.tri);
+  free(w.group);
+  free(w.locked);
+  free(w.mark);
+  free(w.quadric);
+  free(w.start);
+  free(w.list);
+  free(cand);
+}
+
+
+/*=========================================================================
+  【関数】mqoGetDirectory
+  【用途】ファイル名を含むパス文字列からディレクトリのパスのみを抽出する
+  【引数】
+  *path_file	ファイル名を含むパス文字列（入力）
+  *path_dir	ファイル名を除いたパス文字列（出力）
+
+  【戻値】なし
+  【仕様】例：
+  "C:/data/file.bmp" → "C:/data/"
+  "data/file.mqo"    → "data/"
+  =========================================================================*/
+
+void mqoGetDirectory(const char *path_file, char *path_dir)
+{
+  char *pStr;
+  int len;
+
+  pStr = (char*) MY_MAX( strrchr(path_file,'\\'), strrchr(path_file,'/') );
+  len = MY_MAX((int)(pStr-path_file)+1,0);
+  strncpy(path_dir,path_file,len);
+  path_dir[len] = (char)0;
+}
+
+
+/*=========================================================================
+  【関数】mqoSnormal
+  【用途】法線ベクトルを求める
+  【引数】
+  A		3次元座標上の点A
+  B		3次元座標上の点B
+  C		3次元座標上の点C
+  *normal	ベクトルBAとベクトルBCの法線ベクトル（右ねじ方向）
+
+  【戻値】なし
+  【仕様】メタセコイアにおいて面を構成する頂点の番号は，表示面から見て
+  時計回りに記述してある．つまり，頂点A,B,C があったとき，
+  求めるべき法線はBAとBCの外積によって求められる
+  =========================================================================*/
+
+void mqoSnormal(glPOINT3f A, glPOINT3f B, glPOINT3f C, glPOINT3f *normal)
+{
+  double norm;
+  glPOINT3f vec0,vec1;
+
+  // ベクトルBA
+  vec0.x = A.x - B.x; 
+  vec0.y = A.y - B.y;
+  vec0.z = A.z - B.z;
+
+  // ベクトルBC
+  vec1.x = C.x - B.x;
+  vec1.y = C.y - B.y;
+  vec1.z = C.z - B.z;
+
+  // 法線ベクトル
+  normal->x = vec0.y * vec1.z - vec0.z * vec1.y;
+  normal->y = vec0.z * vec1.x - vec0.x * vec1.z;
+  normal->z = vec0.x * vec1.y - vec0.y * vec1.x;
+
+  // 正規化
+  norm = normal->x * normal->x + normal->y * normal->y + normal->z * normal->z;
+  norm = sqrt ( norm );
+
+  normal->x /= norm;
+  normal->y /= norm;
+  normal->z /= norm;
+}
+
+
+/*=========================================================================
+  【関数】mqoReadMaterial
+  【用途】マテリアル情報の読み込み
+  【引数】
+  fp		ファイルポインタ
+  M		マテリアル配列
+
+  【戻値】なし
+  【仕様】mqoCreateModel(), mqoCreateSequence()のサブ関数．
+  =========================================================================*/
+
+void mqoReadMaterial(FILE *fp, MQO_MATDATA M[])
+{
+  GLfloat		dif, amb, emi, spc;
+  glCOLOR4f	c;
+  char		buf[SIZE_STR];
+  char		*pStrEnd, *pStr;
+  int			len;
+  int			i = 0;
+
+  while (1) {
+    fgets(buf,SIZE_STR,fp);	// 行読み込み
+    if (strstr(buf,"}")) break;
+
+    pStr = strstr(buf,"col(");	// 材質名読み飛ばし
+    sscanf( pStr,
+	    "col(%f %f %f %f) dif (%f) amb(%f) emi(%f) spc(%f) power(%f)",
+	    &c.r, &c.g, &c.b, &c.a, &dif, &amb, &emi, &spc, &M[i].power );
+
+    // 頂点カラー
+    M[i].col = c;
+
+    // 拡散光
+    M[i].dif[0] = dif * c.r;
+    M[i].dif[1] = dif * c.g;
+    M[i].dif[2] = dif * c.b;
+    M[i].dif[3] = c.a;
+
+    // 周囲光
+    M[i].amb[0] = amb * c.r;
+    M[i].amb[1] = amb * c.g;
+    M[i].amb[2] = amb * c.b;
+    M[i].amb[3] = c.a;
+
+    // 自己照明
+    M[i].emi[0] = emi * c.r;
+    M[i].emi[1] = emi * c.g;
+    M[i].emi[2] = emi * c.b;
+    M[i].emi[3] = c.a;
+
+    // 反射光
+    M[i].spc[0] = spc * c.r;
+    M[i].spc[1] = spc * c.g;
+    M[i].spc[2] = spc * c.b;
+    M[i].spc[3] = c.a;
+		
+    // tex：模様マッピング名
+    if ( (pStr = strstr(buf,"tex(")) != NULL ) {
+      M[i].useTex = TRUE;
+
+      pStrEnd = strstr(pStr,")")-1;
+      len = pStrEnd - (pStr+5);
+      strncpy(M[i].texFile,pStr+5,len);
+      M[i].texFile[len] = (char)0;
+      if ( (pStr = strstr(buf,"aplane(")) != NULL ) {
+	pStrEnd = strstr(pStr,")")-1;
+	len = pStrEnd - (pStr+8);
+	strncpy(M[i].alpFile,pStr+8,len);
+	M[i].alpFile[len] = (char)0;
+      }
+      else {
+	M[i].alpFile[0] = (char)0;
+      }
+
+    } else {
+      M[i].useTex = FALSE;
+      M[i].texFile[0] = (char)0;
+      M[i].alpFile[0] = (char)0;
+    }
+
+    i++;
+  }
+
+}
+
+
+/*=========================================================================
+  【関数】mqoReadVertex
+  【用途】頂点情報の読み込み
+  【引数】
+  fp		現在オープンしているメタセコイアファイルのファイルポインタ
+  V		頂点を格納する配列
+		
+  【戻値】なし
+  【仕様】mqoReadObject()のサブ関数
+  =========================================================================*/
+
+void mqoReadVertex(FILE *fp, glPOINT3f V[])
+{
+  char buf[SIZE_STR];
+  int  i=0;
+
+  while (1) {
+    fgets(buf,SIZE_STR,fp);
+    if (strstr(buf,"}")) break;
+    sscanf(buf,"%f %f %f",&V[i].x,&V[i].y,&V[i].z);
+    i++;
+  }
+}
+
+
+/*=========================================================================
+  【関数】mqoReadBVertex
+  【用途】バイナリ形式の頂点情報を読み込む
+  【引数】
+  fp		現在オープンしているメタセコイアファイルのファイルポインタ
+  V		頂点を格納する配列
+
+  【戻値】頂点数
+  【仕様】mqoReadObject()のサブ関数
+  =========================================================================*/
+
+int mqoReadBVertex(FILE *fp, glPOINT3f V[])
+{
+  int n_vertex,i;
+  float *wf;
+  int size;
+  char cw[256];
+  char *pStr;
+
+  fgets(cw,sizeof(cw),fp);
+  if ( (pStr = strstr(cw,"Vector")) != NULL ) {
+    sscanf(pStr,"Vector %d [%d]",&n_vertex,&size);	// 頂点数、データサイズを読み込む
+  }
+  else {
+    return -1;
+  }
+  //MQOファイルのバイナリ頂点データはintel形式（リトルエディアン）
+  wf = (float *)malloc(size);
+  fread(wf,size,1,fp);
+  for ( i = 0; i < n_vertex; i++ ) {
+    V[i].x = wf[i*3+0];
+    V[i].y = wf[i*3+1];
+    V[i].z = wf[i*3+2];
+#if DEF_IS_LITTLE_ENDIAN
+#else
+    endianConverter((void *)&V[i].x,sizeof(V[i].x));
+    endianConverter(&V[i].y,sizeof(V[i].y));
+    endianConverter(&V[i].z,sizeof(V[i].z));
+#endif
+  }
+  free(wf);
+
+  // "}"まで読み飛ばし
+  {
+    char buf[SIZE_STR];
+    while (1) {
+      fgets(buf,SIZE_STR,fp);
+      if (strstr(buf,"}")) break;
+    }
+  }
+
+  return n_vertex;
+}
+
+
+/*=========================================================================
+  【関数】mqoReadFace
+  【用途】面情報の読み込み
+  【引数】
+  fp		ファイルポインタ
+  F		面配列
+		
+  【戻値】なし
+  【仕様】mqoReadObject()のサブ関数
+  =========================================================================*/
+
+void mqoReadFace(FILE *fp, MQO_FACE F[])
+{
+  char buf[SIZE_STR];
+  char *pStr;
+  int  i=0;
+
+  while (1) {
+    fgets(buf,SIZE_STR,fp);
+    if (strstr(buf,"}")) break;
+
+    // 面を構成する頂点数
+    sscanf(buf,"%d",&F[i].n);
+
+    // 頂点(V)の読み込み
+    if ( (pStr = strstr(buf,"V(")) != NULL ) {
+      switch (F[i].n) {
+      case 3:
+	//メタセコは頂点の並びが表面からみて右回り
+	//読み込み時に並べ替える方法もある。けど、表面の設定を
+	//glFrontFaceで変えるほうがスマート？
+	sscanf(pStr,"V(%d %d %d)",&F[i].v[0],&F[i].v[1],&F[i].v[2]);
+	//					sscanf(pStr,"V(%d %d %d)",&F[i].v[2],&F[i].v[1],&F[i].v[0]);
+	break;
+      case 4:
+	sscanf(pStr,"V(%d %d %d %d)",&F[i].v[0],&F[i].v[1],&F[i].v[2],&F[i].v[3]);
+	//					sscanf(pStr,"V(%d %d %d %d)",&F[i].v[3],&F[i].v[2],&F[i].v[1],&F[i].v[0]);
+	break;
+      default:
+	break;
+      }		
+    }
+
+    // マテリアル(M)の読み込み
+    F[i].m = 0;
+    if ( (pStr = strstr(buf,"M(")) != NULL ) {
+      sscanf(pStr,"M(%d)",&F[i].m);
+    }
+    else { // マテリアルが設定されていない面
+      F[i].m = -1;
+    }
+
+    // UVマップ(UV)の読み込み
+    if ( (pStr = strstr(buf,"UV(")) != NULL ) {
+      switch (F[i].n) {
+      case 3:	// 頂点数3
+	sscanf(pStr,"UV(%f %f %f %f %f %f)",
+	       &F[i].uv[0].x, &F[i].uv[0].y,
+	       &F[i].uv[1].x, &F[i].uv[1].y,
+	       &F[i].uv[2].x, &F[i].uv[2].y
+	       );
+	break;
+
+      case 4:	// 頂点数4
+	sscanf(pStr,"UV(%f %f %f %f %f %f %f %f)",
+	       &F[i].uv[0].x, &F[i].uv[0].y,
+	       &F[i].uv[1].x, &F[i].uv[1].y,
+	       &F[i].uv[2].x, &F[i].uv[2].y,
+	       &F[i].uv[3].x, &F[i].uv[3].y
+	       );
+	break;
+      default:
+	break;
+      }		
+    }
+
+    i++;
+  }
+
+}
+
+
+/*=========================================================================
+  【関数】mqoReadObject
+  【用途】オブジェクト情報の読み込み
+  【引数】
+  fp		ファイルポインタ
+  obj		オブジェクト情報
+
+  【戻値】なし
+  【仕様】この関数で１個のオブジェクト情報が読み込まれる．
+  =========================================================================*/
+
+void mqoReadObject(FILE *fp, MQO_OBJDATA *obj)
+{
+  char buf[SIZE_STR];
+
+  while (1) {
+    fgets(buf,SIZE_STR,fp);
+    if (strstr(buf,"}")) break;
+
+    // visible
+    if (strstr(buf,"visible ")) {
+      sscanf(buf," visible %d", &obj->visible);
+    }
+
+    // shading
+    if (strstr(buf,"shading ")) {
+      sscanf(buf," shading %d", &obj->shading);
+    }
+
+    // facet
+    if (strstr(buf,"facet ")) {
+      sscanf(buf," facet %f", &obj->facet);
+    }
+
+    // vertex
+    if (strstr(buf,"vertex ")) {
+      sscanf(buf," vertex %d", &obj->n_vertex);
+      obj->V = (glPOINT3f*) calloc( obj->n_vertex, sizeof(glPOINT3f) );
+      mqoReadVertex(fp, obj->V);
+    }
+    // BVertex
+    if (strstr(buf,"BVertex"))	{
+      sscanf(buf," BVertex %d", &obj->n_vertex);
+      obj->V = (glPOINT3f*) calloc( obj->n_vertex, sizeof(glPOINT3f) );
+      mqoReadBVertex(fp,obj->V);
+    }
+
+    // face
+    if (strstr(buf,"face ")) {
+      sscanf(buf," face %d", &obj->n_face);
+      obj->F = (MQO_FACE*) calloc( obj->n_face, sizeof(MQO_FACE) );
+      mqoReadFace(fp, obj->F);
+    }
+
+  }
+
+}
+
+
+/*=========================================================================
+  【関数】mqoMakeArray
+  【用途】頂点配列の作成
+  【引数】
+  mat		マテリアル（この中に頂点データを含む）
+  matpos	材質番号
+  F		面
+  fnum	面数
+  V		頂点
+  N		法線
+  facet	スムージング角
+  mcol	色
+  scale	スケール
+  alpha	アルファ
+
+  【戻値】なし
+  【仕様】頂点配列はすべて三角にするので、四角は三角ｘ２に分割
+  0  3      0    0  3
+  □   →　△　　▽
+  1  2     1  2   2  
+  =========================================================================*/
+
+void mqoMakeArray( MQO_MATERIAL *mat, int matpos, MQO_FACE F[], int fnum,glPOINT3f V[],
+		   glPOINT3f N[], double facet, glCOLOR4f *mcol, double scale, unsigned char alpha )
+{
+  int f;
+  int i;
+  int dpos;
+  double s;
+  glPOINT3f normal;	// 法線ベクトル
+	
+  dpos = 0;
+  mat->color[0] = mcol->r;
+  mat->color[1] = mcol->g;
+  mat->color[2] = mcol->b;
+  mat->color[3] = mcol->a;
+  if ( mat->isUseTexture ) {
+    for ( f = 0; f < fnum; f++ ){
+      if ( F[f].m != matpos ) continue;
+      if ( F[f].n == 3 ) {
+	mqoSnormal(V[F[f].v[0]],V[F[f].v[1]],V[F[f].v[2]],&normal);	// 法線ベクトルを計算
+	for ( i = 0; i < 3; i++ ) {
+	  mat->vertex_t[dpos].point[0] = V[F[f].v[i]].x*scale;
+	  mat->vertex_t[dpos].point[1] = V[F[f].v[i]].y*scale;
+	  mat->vertex_t[dpos].point[2] = V[F[f].v[i]].z*scale;
+	  mat->vertex_t[dpos].uv[0] = F[f].uv[i].x;
+	  mat->vertex_t[dpos].uv[1] = F[f].uv[i].y;
+	  s = acos(normal.x*N[F[f].v[i]].x + normal.y*N[F[f].v[i]].y + normal.z*N[F[f].v[i]].z);
+	  if ( facet < s ) {
+	    // スムージング角　＜（頂点法線と面法線の角度）のときは面法線を頂点法線とする
+	    mat->vertex_t[dpos].normal[0] = normal.x;
+	    mat->vertex_t[dpos].normal[1] = normal.y;
+	    mat->vertex_t[dpos].normal[2] = normal.z;
+	  }
+	  else {
+	    mat->vertex_t[dpos].normal[0] = N[F[f].v[i]].x;
+	    mat->vertex_t[dpos].normal[1] = N[F[f].v[i]].y;
+	    mat->vertex_t[dpos].normal[2] = N[F[f].v[i]].z;
+	  }
+	  dpos++;
+	}
+      }
+      //４頂点（四角）は３頂点（三角）ｘ２に分割
+      if ( F[f].n == 4 ) {
+	mqoSnormal(V[F[f].v[0]],V[F[f].v[1]],V[F[f].v[2]],&normal);	// 法線ベクトルを計算
+	for ( i = 0; i < 4; i++ ) {
+	  if ( i == 3 ) continue;
+	  mat->vertex_t[dpos].point[0] = V[F[f].v[i]].x*scale;
+	  mat->vertex_t[dpos].point[1] = V[F[f].v[i]].y*scale;
+	  mat->vertex_t[dpos].point[2] = V[F[f].v[i]].z*scale;
+	  mat->vertex_t[dpos].uv[0] = F[f].uv[i].x;
+	  mat->vertex_t[dpos].uv[1] = F[f].uv[i].y;
+	  s = acos(normal.x*N[F[f].v[i]].x + normal.y*N[F[f].v[i]].y + normal.z*N[F[f].v[i]].z);
+	  if ( facet < s ) {
+	    mat->vertex_t[dpos].normal[0] = normal.x;
+	    mat->vertex_t[dpos].normal[1] = normal.y;
+	    mat->vertex_t[dpos].normal[2] = normal.z;
+	  }
+	  else {
+	    mat->vertex_t[dpos].normal[0] = N[F[f].v[i]].x;
+	    mat->vertex_t[dpos].normal[1] = N[F[f].v[i]].y;
+	    mat->vertex_t[dpos].normal[2] = N[F[f].v[i]].z;
+	  }
+	  dpos++;
+	}
+	mqoSnormal(V[F[f].v[0]],V[F[f].v[2]],V[F[f].v[3]],&normal);	// 法線ベクトルを計算
+	for ( i = 0; i < 4; i++ ) {
+	  if ( i == 1 ) continue;
+	  mat->vertex_t[dpos].point[0] = V[F[f].v[i]].x*scale;
+	  mat->vertex_t[dpos].point[1] = V[F[f].v[i]].y*scale;
+	  mat->vertex_t[dpos].point[2] = V[F[f].v[i]].z*scale;
+	  mat->vertex_t[dpos].uv[0] = F[f].uv[i].x;
+	  mat->vertex_t[dpos].uv[1] = F[f].uv[i].y;
+	  s = acos(normal.x*N[F[f].v[i]].x + normal.y*N[F[f].v[i]].y + normal.z*N[F[f].v[i]].z);
+	  if ( facet < s ) {
+	    mat->vertex_t[dpos].normal[0] = normal.x;
+	    mat->vertex_t[dpos].normal[1] = normal.y;
+	    mat->vertex_t[dpos].normal[2] = normal.z;
+	  }
+	  else {
+	    mat->vertex_t[dpos].normal[0] = N[F[f].v[i]].x;
+	    mat->vertex_t[dpos].normal[1] = N[F[f].v[i]].y;
+	    mat->vertex_t[dpos].normal[2] = N[F[f].v[i]].z;
+	  }
+	  dpos++;
+	}
+      }
+    }
+  }
+  else {
+    if ( alpha != 255 ) {
+      mat->color[3] = (double)alpha/(double)255;
+    }
+    for ( f = 0; f < fnum; f++ ){
+      if ( F[f].m != matpos ) continue;
+      if ( F[f].n == 3 ) {
+	mqoSnormal(V[F[f].v[0]],V[F[f].v[1]],V[F[f].v[2]],&normal);		// 法線ベクトルを計算
+	for ( i = 0; i < 3; i++ ) {
+	  mat->vertex_p[dpos].point[0] = V[F[f].v[i]].x*scale;
+	  mat->vertex_p[dpos].point[1] = V[F[f].v[i]].y*scale;
+	  mat->vertex_p[dpos].point[2] = V[F[f].v[i]].z*scale;
+	  mat->vertex_p[dpos].normal[0] = normal.x;
+	  mat->vertex_p[dpos].normal[1] = normal.y;
+	  mat->vertex_p[dpos].normal[2] = normal.z;
+	  s = acos(normal.x*N[F[f].v[i]].x + normal.y*N[F[f].v[i]].y + normal.z*N[F[f].v[i]].z);
+	  if ( facet < s ) {
+	    mat->vertex_p[dpos].normal[0] = normal.x;
+	    mat->vertex_p[dpos].normal[1] = normal.y;
+	    mat->vertex_p[dpos].normal[2] = normal.z;
+	  }
+	  else {
+	    mat->vertex_p[dpos].normal[0] = N[F[f].v[i]].x;
+	    mat->vertex_p[dpos].normal[1] = N[F[f].v[i]].y;
+	    mat->vertex_p[dpos].normal[2] = N[F[f].v[i]].z;
+	  }
+	  dpos++;
+	}
+      }
+      //４頂点（四角）は３頂点（三角）ｘ２に分割
+      if ( F[f].n == 4 ) {
+	mqoSnormal(V[F[f].v[0]],V[F[f].v[1]],V[F[f].v[2]],&normal);		// 法線ベクトルを計算
+	for ( i = 0; i < 4; i++ ) {
+	  if ( i == 3 ) continue;
+	  mat->vertex_p[dpos].point[0] = V[F[f].v[i]].x*scale;
+	  mat->vertex_p[dpos].point[1] = V[F[f].v[i]].y*scale;
+	  mat->vertex_p[dpos].point[2] = V[F[f].v[i]].z*scale;
+	  mat->vertex_p[dpos].normal[0] = normal.x;
+	  mat->vertex_p[dpos].normal[1] = normal.y;
+	  mat->vertex_p[dpos].normal[2] = normal.z;
+	  s = acos(normal.x*N[F[f].v[i]].x + normal.y*N[F[f].v[i]].y + normal.z*N[F[f].v[i]].z);
+	  if ( facet < s ) {
+	    mat->vertex_p[dpos].normal[0] = normal.x;
+	    mat->vertex_p[dpos].normal[1] = normal.y;
+	    mat->vertex_p[dpos].normal[2] = normal.z;
+	  }
+	  else {
+	    mat->vertex_p[dpos].normal[0] = N[F[f].v[i]].x;
+	    mat->vertex_p[dpos].normal[1] = N[F[f].v[i]].y;
+	    mat->vertex_p[dpos].normal[2] = N[F[f].v[i]].z;
+	  }
+	  dpos++;
+	}
+	mqoSnormal(V[F[f].v[0]],V[F[f].v[2]],V[F[f].v[3]],&normal);		// 法線ベクトルを計算
+	for ( i = 0; i < 4; i++ ) {
+	  if ( i == 1 ) continue;
+	  mat->vertex_p[dpos].point[0] = V[F[f].v[i]].x*scale;
+	  mat->vertex_p[dpos].point[1] = V[F[f].v[i]].y*scale;
+	  mat->vertex_p[dpos].point[2] = V[F[f].v[i]].z*scale;
+	  mat->vertex_p[dpos].normal[0] = normal.x;
+	  mat->vertex_p[dpos].normal[1] = normal.y;
+	  mat->vertex_p[dpos].normal[2] = normal.z;
+	  s = acos(normal.x*N[F[f].v[i]].x + normal.y*N[F[f].v[i]].y + normal.z*N[F[f].v[i]].z);
+	  if ( facet < s ) {
+	    mat->vertex_p[dpos].normal[0] = normal.x;
+	    mat->vertex_p[dpos].normal[1] = normal.y;
+	    mat->vertex_p[dpos].normal[2] = normal.z;
+	  }
+	  else {
+	    mat->vertex_p[dpos].normal[0] = N[F[f].v[i]].x;
+	    mat->vertex_p[dpos].normal[1] = N[F[f].v[i]].y;
+	    mat->vertex_p[dpos].normal[2] = N[F[f].v[i]].z;
+	  }
+	  dpos++;
+	}
+      }
+    }
+  }
+}
+
+
+/*=========================================================================
+  【関数】mqoVertexNormal
+  【用途】頂点法線の計算
+  【引数】
+  obj			オブジェクト情報
+
+  【戻値】法線配列
+  【仕様】４頂点の面は三角形に分割して計算
+  戻り値は必ず呼び出し元で解放（free）すること！
+  =========================================================================*/
+
+glPOINT3f * mqoVertexNormal(MQO_OBJDATA *obj)
+{
+  int f;
+  int v;
+  int i;
+  double len;
+  glPOINT3f fnormal;	// 面法線ベクトル
+  MQO_FACE *F;
+  glPOINT3f *V;
+  glPOINT3f *ret;
+  F = obj->F;
+  V = obj->V;
+  ret = (glPOINT3f *)calloc(obj->n_vertex,sizeof(glPOINT3f));
+  //面の法線を頂点に足し込み
+  for ( f = 0; f < obj->n_face; f++ ) {
+    if ( obj->F[f].n == 3 ) {
+      mqoSnormal(V[F[f].v[0]],V[F[f].v[1]],V[F[f].v[2]],&fnormal);
+      for ( i = 0; i < 3; i++ ) {
+	ret[F[f].v[i]].x += fnormal.x;
+	ret[F[f].v[i]].y += fnormal.y;
+	ret[F[f].v[i]].z += fnormal.z;
+      }
+    }
+    if ( obj->F[f].n == 4 ) {
+      mqoSnormal(V[F[f].v[0]],V[F[f].v[1]],V[F[f].v[2]],&fnormal);
+      for ( i = 0; i < 4; i++ ) {
+	if ( i == 3 ) continue;
+	ret[F[f].v[i]].x += fnormal.x;
+	ret[F[f].v[i]].y += fnormal.y;
+	ret[F[f].v[i]].z += fnormal.z;
+      }
+      mqoSnormal(V[F[f].v[0]],V[F[f].v[2]],V[F[f].v[3]],&fnormal);
+      for ( i = 0; i < 4; i++ ) {
+	if ( i == 1 ) continue;
+	ret[F[f].v[i]].x += fnormal.x;
+	ret[F[f].v[i]].y += fnormal.y;
+	ret[F[f].v[i]].z += fnormal.z;
+      }
+    }
+  }
+  //正規化
+  for ( v = 0; v < obj->n_vertex; v++ ) {
+    if ( ret[v].x == 0 && ret[v].y == 0 && ret[v].z == 0 ) {
+      //面に使われてない点
+      continue;
+    }
+    len = sqrt(ret[v].x*ret[v].x + ret[v].y*ret[v].y + ret[v].z*ret[v].z);
+    if ( len != 0 ) {
+      ret[v].x = ret[v].x/len;
+      ret[v].y = ret[v].y/len;
+      ret[v].z = ret[v].z/len;
+    }
+  }
+
+  return ret;
+}
+
+/*=========================================================================
+  【関数】mqoMakePolygon
+  【用途】ポリゴンの生成
+  【引数】
+  readObj		読み込んだオブジェクト情報
+  mqoobj		MQOオブジェクト 
+  N[]			法線配列
+  M[]			マテリアル配列
+  n_mat		マテリアル数
+  scale		スケール
+  alpha		アルファ
+
+  【戻値】なし
+  =========================================================================*/
+
+void mqoMakePolygon(MQO_OBJDATA *readObj, MQO_OBJECT *mqoobj,
+		    glPOINT3f N[], MQO_MATDATA M[], int n_mat, double scale, unsigned char alpha)
+{
+
+  MQO_INNER_OBJECT		*setObj;
+  MQO_MATERIAL			*material;
+  glCOLOR4f				defcol;
+  glCOLOR4f				*pcol;
+  int						f, m, *mat_vnum;
+  int						fnum;
+  MQO_FACE				*F;
+  glPOINT3f				*V;
+  double					facet;
+
+
+  setObj = &mqoobj->obj[mqoobj->objnum];
+  strcpy(setObj->objname,readObj->objname);
+  setObj->isVisible = readObj->visible;
+  setObj->isShadingFlat = (readObj->shading == 0);
+  F = readObj->F;
+  fnum = readObj->n_face;
+  V = readObj->V;
+  facet = readObj->facet;
+
+  // 境界（視錐台カリング用）
+  mqoMakeObjectBounds(&setObj->bounds, F, fnum, V, scale);
+
+  // faceの中でのマテリアル毎の頂点の数
+  // M=NULLのとき、F[].m = 0 が入ってくる
+  if ( M == NULL ) n_mat = 1;
+
+  mat_vnum = (int *)malloc(sizeof(int)*n_mat);
+  memset(mat_vnum,0,sizeof(int)*n_mat);
+
+  for ( f = 0; f < fnum; f++ ){
+    if( F[f].m < 0 ) continue; // マテリアルが設定されていない面
+    if ( F[f].n == 3 ) {
+      mat_vnum[F[f].m] += 3;
+    }
+    if ( F[f].n == 4 ) {
+      //４頂点（四角）は３頂点（三角）ｘ２に分割
+      //  0  3      0    0  3
+      //   □   →　△　　▽
+      //  1  2     1  2   2
+      // ４頂点の平面データは
+      // ３頂点の平面データｘ２個
+      mat_vnum[F[f].m] += 3*2;
+    }
+    if ( setObj->matnum < F[f].m+1 ) setObj->matnum = F[f].m+1;
+  }
+
+  // マテリアル別に頂点配列を作成する
+  setObj->mat = (MQO_MATERIAL *)malloc(sizeof(MQO_MATERIAL)*setObj->matnum);
+  memset(setObj->mat,0,sizeof(MQO_MATERIAL)*setObj->matnum);
+
+  for ( m = 0; m < setObj->matnum; m++ ) {
+    material = &setObj->mat[m];
+    material->datanum = mat_vnum[m];
+    material->isValidMaterialInfo = (M != NULL);
+
+    if ( mat_vnum[m] <= 0 ) continue;
+    if ( material->isValidMaterialInfo ) {
+      memcpy(material->dif,M[m].dif,sizeof(material->dif));
+      memcpy(material->amb,M[m].amb,sizeof(material->amb));
+      memcpy(material->spc,M[m].spc,sizeof(material->spc));
+      memcpy(material->emi,M[m].emi,sizeof(material->emi));
+      material->power = M[m].power;
+      material->isUseTexture = M[m].useTex;
+      pcol = &M[m].col;
+    }
+    else {
+      defcol.r = 1.0;
+      defcol.g = 1.0;
+      defcol.b = 1.0;
+      defcol.a = 1.0;
+      material->isUseTexture = 0;
+      pcol = &defcol;
+    }
+    if ( material->isUseTexture ) {
+      material->vertex_t = (VERTEX_TEXUSE *)calloc(material->datanum,sizeof(VERTEX_TEXUSE));
+      material->texture_id = M[m].texName;
+    }
+    else {
+      material->vertex_p = (VERTEX_NOTEX *)calloc(material->datanum,sizeof(VERTEX_NOTEX));
+    }
+    mqoMakeArray(material,m,F,fnum,V,N,facet,pcol,scale,alpha);
+    // 重複する頂点をまとめてインデックス配列にする
+    mqoMakeIndex(material);
+    // 頂点データの量子化（mqoCreateModelEx で指定された時だけ）
+    if ( l_vertexLayout == MQO_LAYOUT_PACKED ) mqoPackVertices(material);
+    // 頂点バッファへの転送（描画のたびに頂点配列を送らないようにする）
+    mqoMakeVertexBuffer(material);
+  }
+  mqoobj->objnum++;
+  if ( MAX_OBJECT <= mqoobj->objnum ) {
+    printf("MQOファイル読み込み：　最大オブジェクト数を超えました[%d]\n",mqoobj->objnum);
+    mqoobj->objnum = MAX_OBJECT-1;
+  }
+
+  free(mat_vnum);
+
+}
+
+
+/*=========================================================================
+  【関数】mqoMakeObjectsEx
+  【用途】オブジェクトのデータからポリゴンモデルを作成する
+  【引数】
+  mqoobj	MQOオブジェクト
+  obj		オブジェクト配列
+  n_obj	オブジェクトの個数
+  M		マテリアル配列
+  n_mat	マテリアルの個数
+  scale	拡大率
+  alpha	アルファ
+
+  【戻値】なし
+  =========================================================================*/
+
+void mqoMakeObjectsEx( MQO_OBJECT *mqoobj, MQO_OBJDATA obj[], int n_obj, MQO_MATDATA M[],int n_mat,
+		       double scale,unsigned char alpha)
+{
+  int i;
+  glPOINT3f *N;
+  for (i=0; i<n_obj; i++) {
+    N = mqoVertexNormal(&obj[i]);
+    mqoMakePolygon(
+		   &obj[i],
+		   mqoobj,
+		   N,
+		   M,n_mat,
+		   scale,
+		   alpha);
+    free(N);
+  }
+}
+
+
+/*=========================================================================
+  【関数】mqoCreateModel
+  【用途】MQOファイルからMQOモデルを作成する
+  【引数】
+  filename	MQOファイル
+  scale		拡大率（1.0でそのまま）
+
+  【戻値】MQO_MODEL（MQOモデル）
+  =========================================================================*/
+
+MQO_MODEL mqoCreateModel(char *filename, double scale)
+{
+  MQO_MODEL ret;
+  ret = mqoCreateList(1);
+  if ( mqoCreateListObject(ret,1-1,filename,scale,(unsigned char)255) < 0 ) {
+    mqoDeleteObject(ret,1);
+    ret = NULL;
+  }
+  return ret;
+}
+
+
+/*=========================================================================
+  【関数】mqoCreateModelEx
+  【用途】MQOファイルからMQOモデルを作成する（頂点データの形式を指定する）
+  【引数】
+  filename	MQOファイル
+  scale		拡大率（1.0でそのまま）
+  layout		MQO_LAYOUT_FLOAT：float のまま
+  MQO_LAYOUT_PACKED：量子化して詰める（メモリと転送量がおよそ半分）
+
+  【戻値】MQO_MODEL（MQOモデル）
+  =========================================================================*/
+
+MQO_MODEL mqoCreateModelEx(char *filename, double scale, int layout)
+{
+  MQO_MODEL ret;
+  l_vertexLayout = layout;
+  ret = mqoCreateModel(filename, scale);
+  l_vertexLayout = MQO_LAYOUT_FLOAT;
+  return ret;
+}
+
+
+/*=========================================================================
+  【関数】mqoCreateSequenceEx
+  【用途】連番のMQOファイルからMQOシーケンスを作成する
+  【引数】
+  format		ファイル名の書式
+  n_file		ファイル数
+  scale		拡大率（1.0でそのまま）
+  fade_inout	0:そのまま　正：フェードイン　負：フェードアウト
+  絶対値は効果をかけるフレーム数
+  alpha		アルファ
+
+  【戻値】MQO_SEQUENCE（MQOシーケンス）
+  【備考】連番は0から開始
+  =========================================================================*/
+
+MQO_SEQUENCE mqoCreateSequenceEx(const char *format, int n_file, double scale,
+				 int fade_inout, unsigned char alpha)
+{
+  MQO_SEQUENCE retSeq;
+  int iret;
+  int seq;
+  char filename[SIZE_STR];
+  short setAlpha;
+  short calAlpha;
+  int frames;
+
+  retSeq.n_frame = 0;
+  if ( format == NULL ) {
+    return retSeq;
+  }
+  calAlpha = alpha;
+  frames = abs(fade_inout);
+  frames = MY_MAX(frames,n_file);
+  setAlpha = (fade_inout<=0)?alpha:0;
+
+  retSeq.model = mqoCreateList(n_file);
+  for ( seq = 0; seq < frames; seq++ ) {
+    if ( seq < n_file ) {
+      sprintf(filename,format,seq);
+    }
+    if ( (fade_inout !=  0) && ((frames-1) == seq) ) {
+      setAlpha = (fade_inout<0)?0:calAlpha;
+    }
+    iret = mqoCreateListObject(retSeq.model,seq,filename,scale,(unsigned char)setAlpha);
+    if ( iret == - 1 ) {
+      seq--;
+      mqoClearObject(retSeq.model,seq,n_file-seq);
+      break;
+    }
+    if ( fade_inout !=  0 ) {
+      if ( fade_inout<0 ) {
+	if ( (n_file-seq) <= (-1*fade_inout) ) {
+	  setAlpha -= (calAlpha/(-1*fade_inout));
+	  if ( setAlpha < 0 ) setAlpha = 0;
+	}
+      }
+      else {
+	setAlpha += (calAlpha/fade_inout);
+	if ( calAlpha < setAlpha ) setAlpha = calAlpha;
+      }
+    }
+  }
+  retSeq.n_frame = seq;
+  return retSeq;
+}
+
+
+/*=========================================================================
+  【関数】mqoCreateSequence
+  【用途】連番のMQOファイルからMQOシーケンスを作成する
+  【引数】
+  format		ファイル名のフォーマット
+  n_file		ファイル数
+  scale		拡大率（1.0でそのまま）
+
+  【戻値】MQO_SEQUENCE（MQOシーケンス）
+  【備考】連番は0から開始
+  =========================================================================*/
+
+MQO_SEQUENCE mqoCreateSequence(const char *format, int n_file, double scale)
+{
+  return mqoCreateSequenceEx(format, n_file, scale, 0, (unsigned char)255);
+}
+
+
+/*=========================================================================
+  【関数】mqoCallModel
+  【用途】MQOモデルをOpenGLの画面上に呼び出す
+  【引数】
+  model		MQOモデル
+
+  【戻値】なし
+  =========================================================================*/
+
+void mqoCallModel(MQO_MODEL model)
+{
+  mqoCallListObject(model, 0);
+}
+
+
+/*=========================================================================
+  【関数】mqoSelectLOD
+  【用途】行列の位置に描画するモデルの詳細度の段階を選ぶ
+  【引数】
+  model	MQOモデル
+  matrix	モデルビュー行列（列優先）
+
+  【戻値】詳細度の段階（0が元のメッシュ），視錐台に入らない時は -1
+  【仕様】境界の球を投影した半径（画面の中心から端を1とする）が
+  MQO_LOD_SIZE より小さくなるごとに，半分になるたびに1段階下げる．
+  視錐台が設定されていない時は元のメッシュにする
+  =========================================================================*/
+
+static int mqoSelectLOD(const MQO_OBJECT *model, const GLfloat *matrix)
+{
+  const MQO_BOUNDS	*b = &model->bounds;
+  GLfloat				c[3], dist, scale, size, threshold, len;
+  int					k, level;
+
+  if ( ! l_isFrustumCulling ) return 0;
+  if ( ! mqoIsBoundsVisible(b, matrix) ) return -1;
+  if ( model->lodnum <= 1 ) return 0;
+
+  // 球の中心の視点からの距離と，行列の拡大率（列の長さの最大）
+  scale = 0.0f;
+  for ( k = 0; k < 3; k++ ) {
+    c[k] = matrix[k]*b->center[0] + matrix[4+k]*b->center[1] + matrix[8+k]*b->center[2]
+      + matrix[12+k];
+    len = matrix[4*k]*matrix[4*k] + matrix[4*k+1]*matrix[4*k+1] + matrix[4*k+2]*matrix[4*k+2];
+    if ( len > scale ) scale = len;
+  }
+  dist = (GLfloat)sqrt(c[0]*c[0] + c[1]*c[1] + c[2]*c[2]);
+  if ( dist <= b->radius*(GLfloat)sqrt(scale) ) return 0;	// 視点が球の中
+  size = b->radius*(GLfloat)sqrt(scale)*l_projScale/dist;
+
+  level = 0;
+  threshold = MQO_LOD_SIZE;
+  while ( level < model->lodnum-1 && size < threshold ) {
+    level++;
+    threshold *= 0.5f;
+  }
+  return level;
+}
+
+
+/*=========================================================================
+  【関数】mqoCallModelInstanced
+  【用途】MQOモデルを複数の位置に描画する
+  【引数】
+  model		MQOモデル
+  matrices	モデルごとの行列（16個ずつ，列優先．現在のモデルビュー行列に掛ける）
+  count		描画する数
+
+  【戻値】なし
+  【仕様】インスタンス描画に対応している時は行列を詳細度の段階ごとにまとめて
+  バッファに転送し，段階とマテリアルごとに1回の描画で済ませる．対応して
+  いない時は行列を掛けて1つずつ描画する．視錐台が設定されている時は，
+  視錐台に入らない行列を除き，内部オブジェクトも境界で調べる
+  （行列はモデルビュー行列が単位行列の時の位置とみなす）
+  =========================================================================*/
+
+void mqoCallModelInstanced(MQO_MODEL model, const GLfloat *matrices, int count)
+{
+  int i, n, level;
+
+  if ( model == NULL || matrices == NULL || count <= 0 ) return;
+
+  if ( l_visibleCapacity < count ) {
+    free(l_visibleMatrices);
+    free(l_visibleLevels);
+    l_visibleMatrices = (GLfloat *)malloc(sizeof(GLfloat)*16*count);
+    l_visibleLevels = (int *)malloc(sizeof(int)*count);
+    l_visibleCapacity = count;
+  }
+  for ( i = 0; i < count; i++ ) {
+    l_visibleLevels[i] = mqoSelectLOD(model, matrices + 16*i);
+  }
+
+  for ( level = 0; level < model->lodnum; level++ ) {
+    // この段階で描画する行列を集める
+    n = 0;
+    for ( i = 0; i < count; i++ ) {
+      if ( l_visibleLevels[i] != level ) continue;
+      memcpy(l_visibleMatrices + 16*n, matrices + 16*i, sizeof(GLfloat)*16);
+      n++;
+    }
+    if ( n == 0 ) continue;
+
+    if ( ! g_isInstancingSupported || model->drawnum <= 0 ) {
+      for ( i = 0; i < n; i++ ) {
+	glPushMatrix();
+	glMultMatrixf(l_visibleMatrices + 16*i);
+	mqoDrawObject(model, l_visibleMatrices + 16*i, 1, 0, level);
+	glPopMatrix();
+      }
+      continue;
+    }
+
+    // 行列の転送（以前の内容は捨てさせるので描画の完了を待たない）
+    glBindBufferARB( GL_ARRAY_BUFFER_ARB, l_instanceVBO );
+    glBufferDataARB( GL_ARRAY_BUFFER_ARB, sizeof(GLfloat)*16*n, l_visibleMatrices,
+		     GL_STREAM_DRAW_ARB );
+    glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
+
+    mqoDrawObject(model, l_visibleMatrices, n, 1, level);
+  }
+}
+
+
+/*=========================================================================
+  【関数】mqoSetFrustum
+  【用途】視錐台カリングと詳細度の選択に使う視錐台を設定する
+  【引数】
+  left, right, bottom, top, nearDist, farDist	glFrustum と同じ
+  （nearDist <= 0 の時はカリングを行わず，詳細度は元のメッシュにする）
+
+  【戻値】なし
+  【仕様】視点座標系の6つの平面（内側が正）と，投影した大きさの倍率
+  （画面の短い方の向きで求める）にして覚えておく
+  =========================================================================*/
+
+void mqoSetFrustum(double left, double right, double bottom, double top,
+		   double nearDist, double farDist)
+{
+  double	p[6][4] = {
+    {  nearDist, 0.0, left,   0.0 },		// 左
+    { -nearDist, 0.0, -right, 0.0 },		// 右
+    { 0.0,  nearDist, bottom, 0.0 },		// 下
+    { 0.0, -nearDist, -top,   0.0 },		// 上
+    { 0.0, 0.0, -1.0, -nearDist },		// 前
+    { 0.0, 0.0,  1.0,  farDist  }		// 後
+  };
+  double	len, w;
+  int		i, j;
+
+  l_isFrustumCulling = ( nearDist > 0.0 );
+  if ( ! l_isFrustumCulling ) return;
+  w = fabs(right - left);
+  if ( fabs(top - bottom) < w ) w = fabs(top - bottom);
+  l_projScale = (GLfloat)( 2.0*nearDist/w );
+  for ( i = 0; i < 6; i++ ) {
+    len = sqrt(p[i][0]*p[i][0] + p[i][1]*p[i][1] + p[i][2]*p[i][2]);
+    for ( j = 0; j < 4; j++ ) l_frustum[i][j] = (GLfloat)(p[i][j]/len);
+  }
+}
+
+
+/*=========================================================================
+  【関数】mqoIsModelVisible
+  【用途】MQOモデルが視錐台に入るかどうかを調べる
+  【引数】
+  model	MQOモデル
+  matrix	モデルビュー行列（列優先）
+
+  【戻値】1：入る（カリングが無効な時も），0：入らない
+  =========================================================================*/
+
+int mqoIsModelVisible(MQO_MODEL model, const GLfloat *matrix)
+{
+  if ( model == NULL ) return 0;
+  if ( ! l_isFrustumCulling ) return 1;
+  return mqoIsBoundsVisible(&model->bounds, matrix);
+}
+
+
+/*=========================================================================
+  【関数】mqoCallSequence
+  【用途】MQOシーケンスをOpenGLの画面に呼び出す
+  【引数】
+  seq		MQOシーケンス
+  i		フレーム番号
+
+  【戻値】なし
+  【仕様】MQOシーケンスの中から指定したフレーム番号のモデルを呼び出す
+  =========================================================================*/
+
+void mqoCallSequence(MQO_SEQUENCE seq, int i)
+{
+  if ( i>=0 && i<seq.n_frame ) {
+    mqoCallListObject(seq.model,i);
+  }
+}
+
+
+/*=========================================================================
+  【関数】mqoClearObject
+  【用途】MQOオブジェクトのクリア
+  【引数】
+  object	MQOオブジェクト配列
+  from	削除開始番号（0〜）
+  num		削除する個数
+
+  【戻値】なし
+  =========================================================================*/
+
+void mqoClearObject( MQO_OBJECT object[], int from, int num ) 
+{
+  int					loop, o, m;
+  MQO_INNER_OBJECT	*obj;
+  MQO_MATERIAL		*mat;
+
+  if ( object == NULL ) return;
+
+  for ( loop = from; loop < from + num; loop++ ) {
+    for ( o = 0; o < (object+from)->objnum; o++ ) {
+
+      obj = &(object+loop)->obj[o];
+      for ( m = 0; m < obj->matnum; m++ ) {
+	mat = &obj->mat[m];
+	if ( mat->datanum <= 0 ) continue;
+	// 頂点配列オブジェクトと頂点バッファの削除
+	if ( mat->VAO_id != 0 ) {
+	  glDeleteVertexArrays( 1, &mat->VAO_id );
+	  mat->VAO_id = 0;
+	}
+	if ( mat->VBO_id != 0 ) {
+	  glDeleteBuffersARB( 1, &mat->VBO_id );
+	  mat->VBO_id = 0;
+	}
+	if ( mat->IBO_id != 0 ) {
+	  glDeleteBuffersARB( 1, &mat->IBO_id );
+	  mat->IBO_id = 0;
+	}
+
+	// インデックス配列の削除
+	if ( mat->index != NULL ) {
+	  free(mat->index);
+	  mat->index = NULL;
+	}
+
+	// 頂点配列の削除
+	if ( mat->vertex_q != NULL ) {
+	  free(mat->vertex_q);
+	  mat->vertex_q = NULL;
+	}
+	if ( mat->isUseTexture ) {
+	  if ( mat->vertex_t != NULL ) {
+	    free(mat->vertex_t);
+	    mat->vertex_t = NULL;
+	  }
+	}
+	else {
+	  if ( mat->vertex_p != NULL ) {
+	    free(mat->vertex_p);
+	    mat->vertex_p = NULL;
+	  }
+	}
+      }
+      if ( obj->mat != NULL ) {
+	free(obj->mat);
+	obj->mat = NULL;
+      }
+      obj->matnum = 0;
+    }
+
+    // 描画リストの削除
+    if ( (object+loop)->drawlist != NULL ) {
+      free((object+loop)->drawlist);
+      (object+loop)->drawlist = NULL;
+    }
+    (object+loop)->drawnum = 0;
+  }
+
+}
+
+
+/*=========================================================================
+  【関数】mqoDeleteObject
+  【用途】MQOオブジェクトを削除する
+  【引数】
+  object	MQOオブジェクト配列
+  num		削除する個数
+
+  【戻値】なし
+  =========================================================================*/
+
+void mqoDeleteObject(MQO_OBJECT object[], int num)
+{
+  mqoClearObject(object,0,num);
+  free(object);
+}
+
+
+/*=========================================================================
+  【関数】mqoDeleteModel
+  【用途】MQOモデルを削除する
+  【引数】
+  model	MQOモデル
+
+  【戻値】なし
+  【備考】削除処理を行った変数を再利用する可能性がある場合は
+  この関数の実行後にNULLを代入しておくこと
+  =========================================================================*/
+
+void mqoDeleteModel(MQO_MODEL model)
+{
+  mqoDeleteObject(model,1);
+}
+
+
+/*=========================================================================
+  【関数】mqoDeleteSequence
+  【用途】MQOシーケンスを削除する
+  【引数】
+  seq		MQOシーケンス
+
+  【備考】削除処理を行った変数を再利用する可能性がある場合は
+  この関数の実行後にNULLを代入しておくこと
+  =========================================================================*/
+
+void mqoDeleteSequence(MQO_SEQUENCE seq)
+{
+  mqoDeleteObject( seq.model, seq.n_frame );
+}
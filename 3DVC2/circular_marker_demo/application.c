@@ -1,106 +1,189 @@
-/* ******************************************************* application.c *** *
- * アプリケーションクラス
- * ************************************************************************* */
-#include "application.h"
-#include <fstream>
-/*!
- * @brief コンストラクタ
- */
-Application::Application(const char* title) {
-  // カメラに関する変数
-  camera.deviceID = 0;
-  camera.width    = IMAGE_WIDTH;
-  camera.height   = IMAGE_HEIGHT;
-  
-  focus    = CAMERA_FOCUS; // [画素]
-  u0       = IMAGE_U0;     // [画素]
-  v0       = IMAGE_V0;     // [画素]  
-
-  proj_param.horiz = (camera.width  / 2.0) * DEFAULT_SCALE;
-  proj_param.vert  = (camera.height / 2.0) * DEFAULT_SCALE;
-  proj_param.nearDist  = focus * DEFAULT_SCALE;
-  proj_param.farDist   = proj_param.nearDist * DEFAULT_FAR_SCALE;
-    
-  // ウィンドウに関数変数
-  window.MakeContext (camera.width, camera.height, title);
-  
-  // ウィンドウに描画する背景画像
-  drawMode = DRAW_INPUT;
-
-  // 座標系の変換行列
-  A = Eigen::MatrixXd::Zero(3, 3);
-  A << 0.0, focus, u0, -focus, 0.0, v0, 0.0, 0.0, 1.0;
-  marker_detector.A = A;
-  marker_detector.drawMarker = true;
-  ellipse_detector.drawEllipseCenter = true;
-}
-
-/*!
- * @brief　デストラクタ
- */
-Application::~Application() {
-  camera.Close();
-}
-
-/*!
- * @brief  設定ファイルの読み込み
- *
- * @param[in] filename  設定ファイル名
- */
-void Application::ReadSettings(const std::string& filename)
-{
-  std::ifstream ifs(filename);
-  if (!ifs.fail()) {
-    ifs >> camera.deviceID;
-    ifs >> camera.width >> camera.height;
-    ifs >> focus;
-    ifs >> model_filename;
-    ifs >> model.scale;
-    ifs >> marker_detector.radiusOuter;
-    ifs >> marker_detector.radiusInner;
-    ifs.close();
-  } else {
-    std::cout << "Setting file open error." << std::endl;
-  }
-  u0 = camera.width  / 2.0;
-  v0 = camera.height / 2.0;
-  A << 0.0, focus, u0, -focus, 0.0, v0, 0.0, 0.0, 1.0;
-  
-  proj_param.horiz = (camera.width  / 2.0) * DEFAULT_SCALE;
-  proj_param.vert  = (camera.height / 2.0) * DEFAULT_SCALE;
-  proj_param.nearDist  = focus * DEFAULT_SCALE;
-  proj_param.farDist   = proj_param.nearDist * DEFAULT_FAR_SCALE;
-
-  glfwSetWindowSize (window.window, camera.width, camera.height);
-  glViewport(0, 0, camera.width, camera.height);  
-}
-
-/*!
- * @brief  カメラのオープン
- *
- * @retval  True of False
- */
-bool Application::OpenCamera(void)
-{
-  int channel = 3;
-  return camera.Open(camera.width, camera.height, channel);
-}
-
-/*!
- * @brief 楕円検出
- */
-// bool Application::MarkerDetect(void) {
-//   camera.CaptureImage();
-//   bool retval = ellipse_detector.Detect (camera.image, ellipse_list);
-//   if (retval) {
-//     retval = marker_detector.Detect (ellipse_list, camera.image, marker_list);
-//   }
-//   return retval;
-// }
-
-bool Application::MarkerDetect(void) { 
-  camera.CaptureImage();
-  bool retval = rectangle_detector.Detect(camera.image, rectangle_list);
-  return retval;
-}
-/* ************************************************ End of application.c *** */
+/* ******************************************************* application.c *** *
+ * アプリケーションクラス
+ * ************************************************************************* */
+#include "application.h"
+#include "marker_backend.h"
+#include <fstream>
+/*!
+ * @brief コンストラクタ
+ */
+Application::Application(const char* title) {
+  // カメラに関する変数
+  camera.deviceID = 0;
+  camera.width    = IMAGE_WIDTH;
+  camera.height   = IMAGE_HEIGHT;
+  
+  focus    = CAMERA_FOCUS; // [画素]
+  u0       = IMAGE_U0;     // [画素]
+  v0       = IMAGE_V0;     // [画素]  
+
+  proj_param.horiz = (camera.width  / 2.0) * DEFAULT_SCALE;
+  proj_param.vert  = (camera.height / 2.0) * DEFAULT_SCALE;
+  proj_param.nearDist  = focus * DEFAULT_SCALE;
+  proj_param.farDist   = proj_param.nearDist * DEFAULT_FAR_SCALE;
+    
+  // ウィンドウに関数変数
+  window.MakeContext (camera.width, camera.height, title);
+  
+  // ウィンドウに描画する背景画像
+  drawMode = DRAW_INPUT;
+
+  // 座標系の変換行列
+  A = Eigen::MatrixXd::Zero(3, 3);
+  A << 0.0, focus, u0, -focus, 0.0, v0, 0.0, 0.0, 1.0;
+  marker_detector.A = A;
+  marker_detector.drawMarker = true;
+  rect_marker_detector.A = A;
+  rect_marker_detector.drawMarker = true;
+  useTracking = true;
+  ellipse_detector.drawEllipseCenter = true;
+
+  SetBackend(BACKEND_RECTANGLE);
+}
+
+/*!
+ * @brief　デストラクタ
+ */
+Application::~Application() {
+  camera.Close();
+}
+
+/*!
+ * @brief  設定ファイルの読み込み
+ *
+ * 最後の行に入力モードを書くとカメラ以外から画像を入力できる（省略時はカメラ）．
+ *   1 ファイル名        : ビデオファイル
+ *   2 パターン          : 連番画像（ディレクトリ名または glob パターン）
+ *   3 ファイル名        : 無圧縮フレームファイル(.raw)
+ *   4                   : 合成画像
+ *
+ * @param[in] filename  設定ファイル名
+ */
+void Application::ReadSettings(const std::string& filename)
+{
+  std::ifstream ifs(filename);
+  if (!ifs.fail()) {
+    ifs >> camera.deviceID;
+    ifs >> camera.width >> camera.height;
+    ifs >> focus;
+    ifs >> model_filename;
+    ifs >> model.scale;
+    ifs >> marker_detector.radiusOuter;
+    ifs >> marker_detector.radiusInner;
+    int inputMode;
+    if (ifs >> inputMode) {
+      camera.inputMode = inputMode;
+      if (inputMode != CCamera::INPUT_CAMERA &&
+	  inputMode != CCamera::INPUT_SYNTHETIC) {
+	ifs >> camera.inputFileName;
+      }
+    }
+    ifs.close();
+  } else {
+    std::cout << "Setting file open error." << std::endl;
+  }
+  u0 = camera.width  / 2.0;
+  v0 = camera.height / 2.0;
+  A << 0.0, focus, u0, -focus, 0.0, v0, 0.0, 0.0, 1.0;
+  rect_marker_detector.A = A;
+  
+  proj_param.horiz = (camera.width  / 2.0) * DEFAULT_SCALE;
+  proj_param.vert  = (camera.height / 2.0) * DEFAULT_SCALE;
+  proj_param.nearDist  = focus * DEFAULT_SCALE;
+  proj_param.farDist   = proj_param.nearDist * DEFAULT_FAR_SCALE;
+
+  glfwSetWindowSize (window.window, camera.width, camera.height);
+  glViewport(0, 0, camera.width, camera.height);  
+}
+
+/*!
+ * @brief  カメラのオープン
+ *
+ * @retval  True of False
+ */
+bool Application::OpenCamera(void)
+{
+  int channel = 3;
+  return camera.Open(camera.width, camera.height, channel);
+}
+
+/*!
+ * @brief  カメラパラメータの読み込み（カメラをオープンしてから呼び出す）
+ *
+ * CCamera::LoadParameters で歪み補正テーブルを用意し（2回目からは
+ * キャッシュを使う），補正後の画像の内部パラメータで座標系の変換行列と
+ * 視錐台を設定しなおす．
+ *
+ * @param[in] filename  カメラパラメータファイル名（SaveParameters の形式）
+ *
+ * @retval  True of False
+ */
+bool Application::LoadCameraParameters(const std::string& filename)
+{
+  if (!camera.LoadParameters(filename, true)) return false;
+
+  cv::Mat_<double> K(camera.internalParams);
+  focus = K(0, 0);
+  u0    = K(0, 2);
+  v0    = K(1, 2);
+  A << 0.0, focus, u0, -focus, 0.0, v0, 0.0, 0.0, 1.0;
+  marker_detector.A = A;
+  rect_marker_detector.A = A;
+
+  proj_param.nearDist  = focus * DEFAULT_SCALE;
+  proj_param.farDist   = proj_param.nearDist * DEFAULT_FAR_SCALE;
+  return true;
+}
+
+/*!
+ * @brief  マーカー検出の方式の切り替え
+ *
+ * 方式ごとに実体化した DetectWith から1つを選ぶ．
+ * 前の方式で検出したマーカーが残らないようにリストを空にする．
+ *
+ * @param[in] _backend  BACKEND_CIRCULAR, BACKEND_RECTANGLE, BACKEND_COMBINED
+ */
+void Application::SetBackend(int _backend)
+{
+  switch (_backend) {
+  case BACKEND_CIRCULAR:
+    detectFunc = &Application::DetectWith<CircularMarkerBackend>;
+    break;
+  case BACKEND_COMBINED:
+    detectFunc = &Application::DetectWith<
+      CombinedMarkerBackend<RectangleMarkerBackend, CircularMarkerBackend> >;
+    break;
+  default:
+    _backend   = BACKEND_RECTANGLE;
+    detectFunc = &Application::DetectWith<RectangleMarkerBackend>;
+    break;
+  }
+  backend = _backend;
+
+  ellipse_list.clear();
+  marker_list.clear();
+  rect_marker_list.clear();
+  rectangle_tracker.Reset();
+}
+
+/*!
+ * @brief  マーカー検出
+ *
+ * @retval  マーカーが検出された場合はtrue, そうでなければfalse
+ */
+bool Application::MarkerDetect(void)
+{
+  return (this->*detectFunc)();
+}
+
+/*!
+ * @brief  方式 Backend でのマーカー検出
+ */
+template <class Backend>
+bool Application::DetectWith(void)
+{
+  camera.CaptureImage();
+  Backend detector;
+  return detector.Detect(*this);
+}
+/* ************************************************ End of application.c *** */
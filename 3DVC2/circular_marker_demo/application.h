@@ -1,75 +1,101 @@
-/* ******************************************************* application.h *** *
- * アプリケーションクラス
- * ************************************************************************* */
-#pragma once
-
-#include <vector>
-#include <opencv2/opencv.hpp>
-#include <Eigen/Dense>
-#include "camera.h"
-#include "glfw_window.h"
-#include "ellipse.h"
-#include "ellipse_detection.h"
-#include "circular_marker_detection.h"
-#include "circular_marker.h"
-#include "metasequoia.h"
-#include "rectangle_detection.h"
-
-typedef struct _GLProjectionParam {
-  double horiz;
-  double vert;
-  double nearDist;
-  double farDist;
-} GLProjectionParam;
-
-class Application {
-public:
-  // コンストラクタ
-  Application(const char* title);
-
-  // デストラクタ
-  ~Application();
-
-  // カメラ関係の関数
-  void ReadSettings(const std::string& filename);
-  bool OpenCamera(void);
-
-  // マーカーを検出する関数
-  bool MarkerDetect(void);
-  
-  // 定数
-  const int DRAW_INPUT      = 0;
-  const int IMAGE_WIDTH     = 640;
-  const int IMAGE_HEIGHT    = 480;  
-  const int IMAGE_U0        = 320;
-  const int IMAGE_V0        = 240;
-  const double CAMERA_FOCUS = 700.0;
-  const double DEFAULT_SCALE = 0.005;
-  const double DEFAULT_FAR_SCALE = 1.0e+6;
-  
-  // メンバ変数
-  CCamera camera;    // カメラ
-  GLFWWindow window; // 表示用ウィンドウ
-  cv::Mat image;     // 背景用画像
-  int drawMode;      // 何を描画するか
-  double focus;      // カメラの焦点距離
-  double u0;         // 光軸点の座標(u0, v0)
-  double v0;
-  Eigen::MatrixXd A; // 楕円パラメータの座標系変換行列
-  GLProjectionParam proj_param;
-  
-  EllipseDetection            ellipse_detector; // 楕円検出クラス
-  CircularMarkerDetection     marker_detector;  // マーカー検出クラス
-  std::vector<Ellips>        ellipse_list;     // 楕円リスト
-
-  RectangleDetection          rectangle_detector;
-  std::vector<<std::vector<cv::Point>> rectangle_list;
-
-  std::vector<CircularMarker> marker_list;      // マーカーリスト
-
-  Metasequoia model;
-  char model_filename[1024];
-  double model_scale;
-};
-
-/* ************************************************ End of application.h *** */
+/* ******************************************************* application.h *** *
+ * アプリケーションクラス
+ * ************************************************************************* */
+#pragma once
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <Eigen/Dense>
+#include "camera.h"
+#include "glfw_window.h"
+#include "ellipse.h"
+#include "ellipse_detection.h"
+#include "circular_marker_detection.h"
+#include "circular_marker.h"
+#include "metasequoia.h"
+#include "rectangle_detection.h"
+#include "rectangle_marker_detection.h"
+#include "rectangle_marker.h"
+#include "rectangle_tracker.h"
+
+typedef struct _GLProjectionParam {
+  double horiz;
+  double vert;
+  double nearDist;
+  double farDist;
+} GLProjectionParam;
+
+class Application {
+public:
+  // コンストラクタ
+  Application(const char* title);
+
+  // デストラクタ
+  ~Application();
+
+  // カメラ関係の関数
+  void ReadSettings(const std::string& filename);
+  bool OpenCamera(void);
+  bool LoadCameraParameters(const std::string& filename);
+
+  // マーカーを検出する関数
+  bool MarkerDetect(void);
+  // マーカー検出の方式の切り替え
+  void SetBackend(int _backend);
+  
+  // 定数
+  const int DRAW_INPUT      = 0;
+  const int IMAGE_WIDTH     = 640;
+  const int IMAGE_HEIGHT    = 480;  
+  const int IMAGE_U0        = 320;
+  const int IMAGE_V0        = 240;
+  const double CAMERA_FOCUS = 700.0;
+  const double DEFAULT_SCALE = 0.005;
+  const double DEFAULT_FAR_SCALE = 1.0e+6;
+
+  // マーカー検出の方式
+  static const int BACKEND_CIRCULAR  = 0; // 円形マーカー（楕円検出）
+  static const int BACKEND_RECTANGLE = 1; // 正方形マーカー（矩形検出）
+  static const int BACKEND_COMBINED  = 2; // 両方
+  static const int NUM_BACKENDS      = 3;
+  
+  // メンバ変数
+  CCamera camera;    // カメラ
+  GLFWWindow window; // 表示用ウィンドウ
+  cv::Mat image;     // 背景用画像
+  int drawMode;      // 何を描画するか
+  double focus;      // カメラの焦点距離
+  double u0;         // 光軸点の座標(u0, v0)
+  double v0;
+  Eigen::MatrixXd A; // 楕円パラメータの座標系変換行列
+  GLProjectionParam proj_param;
+  
+  EllipseDetection            ellipse_detector; // 楕円検出クラス
+  CircularMarkerDetection     marker_detector;  // マーカー検出クラス
+  std::vector<Ellips>        ellipse_list;     // 楕円リスト
+
+  RectangleDetection          rectangle_detector; // 矩形検出クラス
+  std::vector<std::vector<cv::Point> > rectangle_list; // 矩形リスト
+  RectangleTracker            rectangle_tracker;  // 四角形の追跡クラス
+  std::vector<std::vector<cv::Point2f> > tracked_list; // 追跡した四角形のリスト
+  bool                        useTracking;        // 四角形を追跡するかどうか
+  RectangleMarkerDetection    rect_marker_detector; // 正方形マーカー検出クラス
+  std::vector<RectangleMarker> rect_marker_list;    // 正方形マーカーリスト
+
+  std::vector<CircularMarker> marker_list;      // マーカーリスト
+
+  Metasequoia model;
+  std::vector<float> model_matrices; // モデルを描画する位置（16個ずつ）
+  char model_filename[1024];
+  double model_scale;
+
+  int backend;       // マーカー検出の方式
+
+ private:
+  // 方式ごとに実体化する検出処理
+  template <class Backend> bool DetectWith(void);
+
+  bool (Application::*detectFunc)(void); // 選択中の方式の検出処理
+};
+
+/* ************************************************ End of application.h *** */
@@ -0,0 +1,153 @@
+/*!
+ * @file	async_frame_writer.c
+ * @brief	別スレッドで画像を保存するクラス
+ */
+#include "async_frame_writer.h"
+
+/*!
+ * @brief  コンストラクタ
+ */
+AsyncFrameWriter::AsyncFrameWriter ()
+{
+  policy        = POLICY_DROP_OLDEST;
+  capacity      = DEFAULT_CAPACITY;
+  encodedFrames = 0;
+  droppedFrames = 0;
+  running       = false;
+}
+
+/*!
+ * @brief  デストラクタ
+ */
+AsyncFrameWriter::~AsyncFrameWriter ()
+{
+  Stop ();
+}
+
+/*!
+ * @brief  保存スレッドの開始
+ *
+ * @param[in] _sink  画像を保存する関数
+ *
+ * @retval  True or False
+ */
+bool AsyncFrameWriter::Start (Sink _sink)
+{
+  if (running) return false;
+  if (capacity < 1) capacity = 1;
+
+  sink          = _sink;
+  encodedFrames = 0;
+  droppedFrames = 0;
+  queue.clear ();
+  running = true;
+  worker  = std::thread (&AsyncFrameWriter::Run, this);
+  return true;
+}
+
+/*!
+ * @brief  保存スレッドの終了（キューに残った画像はすべて保存する）
+ */
+void AsyncFrameWriter::Stop (void)
+{
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    if (!running) return;
+    running = false;
+  }
+  cond.notify_all ();
+  if (worker.joinable ()) worker.join ();
+}
+
+/*!
+ * @brief  保存スレッドが動いているかどうか
+ */
+bool AsyncFrameWriter::IsRunning (void) const
+{
+  return running;
+}
+
+/*!
+ * @brief  画像をキューに積む
+ *
+ * @param[in] image      保存する画像（コピーされるので呼び出し後に書き換えてよい）
+ * @param[in] timestamp  撮影時刻 [マイクロ秒]
+ * @param[in] name       出力ファイル名（静止画として保存する場合）
+ *
+ * @retval  キューに積めた場合は true, 捨てた場合は false
+ *
+ * 画像のコピーはロックの外で行い，保存スレッドを止めないようにする．
+ */
+bool AsyncFrameWriter::Push (const cv::Mat &image, int64_t timestamp,
+			     const std::string &name)
+{
+  // プールのバッファを再利用する（サイズが同じなら確保は起きない）
+  Item item;
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    if (!running) return false;
+    if (queue.size () >= capacity && policy == POLICY_DROP_NEWEST) {
+      droppedFrames++;
+      return false;
+    }
+    if (!pool.empty ()) {
+      item.image = pool.back ();
+      pool.pop_back ();
+    }
+  }
+  image.copyTo (item.image);
+  item.timestamp = timestamp;
+  item.name      = name;
+
+  std::unique_lock<std::mutex> lock (mutex);
+  if (!running) {
+    pool.push_back (item.image);
+    return false;
+  }
+  if (queue.size () >= capacity) {
+    if (policy == POLICY_DROP_NEWEST) {
+      pool.push_back (item.image);
+      droppedFrames++;
+      return false;
+    } else if (policy == POLICY_DROP_OLDEST) {
+      pool.push_back (queue.front ().image);
+      queue.pop_front ();
+      droppedFrames++;
+    } else {
+      cond.wait (lock, [this] { return queue.size () < capacity || !running; });
+      if (!running) {
+	pool.push_back (item.image);
+	return false;
+      }
+    }
+  }
+  queue.push_back (item);
+  lock.unlock ();
+  cond.notify_all ();
+
+  return true;
+}
+
+/*!
+ * @brief  保存スレッド
+ */
+void AsyncFrameWriter::Run (void)
+{
+  for (;;) {
+    Item item;
+    {
+      std::unique_lock<std::mutex> lock (mutex);
+      cond.wait (lock, [this] { return !queue.empty () || !running; });
+      if (queue.empty ()) return; // 終了要求かつキューが空
+      item = queue.front ();
+      queue.pop_front ();
+    }
+    cond.notify_all (); // POLICY_BLOCK で待っている Push を起こす
+
+    sink (item.image, item.timestamp, item.name);
+    encodedFrames++;
+
+    std::lock_guard<std::mutex> lock (mutex);
+    pool.push_back (item.image);
+  }
+}
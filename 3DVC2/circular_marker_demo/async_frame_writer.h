@@ -0,0 +1,79 @@
+/*!
+ * @file	async_frame_writer.h
+ * @brief	別スレッドで画像を保存するクラス
+ */
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+/*!
+ * @class  非同期の画像保存クラス
+ * @brief　画像をプールしたバッファにコピーしてキューに積み，
+ *         保存（エンコード）は別スレッドで行う
+ */
+class AsyncFrameWriter
+{
+ public:
+  // 画像を実際に保存する関数（保存スレッドから呼ばれる）
+  typedef std::function<void (const cv::Mat &image, int64_t timestamp,
+			      const std::string &name)> Sink;
+
+  // コンストラクタ
+  AsyncFrameWriter ();
+
+  // デストラクタ
+  ~AsyncFrameWriter ();
+
+  // 保存スレッドの開始と終了（Stop はキューに残った画像を保存してから戻る）
+  bool Start (Sink sink);
+  void Stop (void);
+  bool IsRunning (void) const;
+
+  // 画像をキューに積む
+  bool Push (const cv::Mat &image, int64_t timestamp,
+	     const std::string &name = "");
+
+  // キューが一杯のときの動作
+  static const int POLICY_BLOCK       = 0; // 空きができるまで待つ
+  static const int POLICY_DROP_OLDEST = 1; // 一番古い画像を捨てる
+  static const int POLICY_DROP_NEWEST = 2; // 新しい画像を捨てる
+
+  static const int DEFAULT_CAPACITY = 8;
+
+  // メンバー（Start の前に設定する）
+  int    policy;                       // キューが一杯のときの動作
+  size_t capacity;                     // キューの長さ
+
+  // 統計
+  std::atomic<uint64_t> encodedFrames; // 保存した枚数
+  std::atomic<uint64_t> droppedFrames; // 捨てた枚数
+
+ private:
+  struct Item {
+    cv::Mat     image;
+    int64_t     timestamp;
+    std::string name;
+  };
+
+  void Run (void);
+
+  Sink                    sink;
+  std::thread             worker;
+  std::mutex              mutex;
+  std::condition_variable cond;
+  std::deque<Item>        queue;       // 保存待ちの画像
+  std::vector<cv::Mat>    pool;        // 再利用するバッファ
+  std::atomic<bool>       running;     // 書き換えは mutex の中で行う
+
+  AsyncFrameWriter (const AsyncFrameWriter&);
+  AsyncFrameWriter& operator= (const AsyncFrameWriter&);
+};
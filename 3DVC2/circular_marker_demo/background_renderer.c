@@ -0,0 +1,186 @@
+/*!
+ * @file	background_renderer.c
+ * @brief	背景画像の描画クラス
+ */
+#include "background_renderer.h"
+#include <stdio.h>
+#include <string.h>
+
+/*!
+ * @brief  コンストラクタ
+ */
+BackgroundRenderer::BackgroundRenderer ()
+{
+  initialized = false;
+  usePBO      = false;
+  useNPOT     = false;
+  texture     = 0;
+  pbo[0]      = pbo[1] = 0;
+  index       = 0;
+  width       = height = 0;
+  texWidth    = texHeight = 0;
+  maxS        = maxT = 1.0f;
+}
+
+/*!
+ * @brief  GL の機能を調べてテクスチャとバッファを作る
+ */
+void BackgroundRenderer::Init (void)
+{
+  // ピクセルバッファオブジェクトは OpenGL 2.1 以降または拡張機能で，
+  // 2のべき乗以外の大きさのテクスチャは OpenGL 2.0 以降または拡張機能で使える
+  int major = 0, minor = 0;
+  const char *version    = (const char *) glGetString (GL_VERSION);
+  const char *extensions = (const char *) glGetString (GL_EXTENSIONS);
+  if (version != NULL) sscanf (version, "%d.%d", &major, &minor);
+  usePBO = (major > 2 || (major == 2 && minor >= 1)) ||
+    (extensions != NULL && strstr (extensions, "GL_ARB_pixel_buffer_object") != NULL);
+  useNPOT = (major >= 2) ||
+    (extensions != NULL && strstr (extensions, "GL_ARB_texture_non_power_of_two") != NULL);
+
+  glGenTextures (1, &texture);
+  glBindTexture (GL_TEXTURE_2D, texture);
+  glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glBindTexture (GL_TEXTURE_2D, 0);
+
+  if (usePBO) {
+    glGenBuffers (2, pbo);
+  }
+  initialized = true;
+}
+
+/*!
+ * @brief  終了
+ */
+void BackgroundRenderer::Release (void)
+{
+  if (texture != 0) {
+    glDeleteTextures (1, &texture);
+    texture = 0;
+  }
+  if (pbo[0] != 0) {
+    glDeleteBuffers (2, pbo);
+    pbo[0] = pbo[1] = 0;
+  }
+  width = height = 0;
+  initialized = false;
+}
+
+/*!
+ * @brief  画像の大きさが変わったときにテクスチャとバッファを確保しなおす
+ *
+ * @param[in] _width   画像の幅
+ * @param[in] _height  画像の高さ
+ */
+void BackgroundRenderer::Resize (int _width, int _height)
+{
+  width  = _width;
+  height = _height;
+  texWidth  = width;
+  texHeight = height;
+  if (!useNPOT) {
+    for (texWidth  = 1; texWidth  < width;  texWidth  <<= 1);
+    for (texHeight = 1; texHeight < height; texHeight <<= 1);
+  }
+  maxS = (GLfloat) width  / texWidth;
+  maxT = (GLfloat) height / texHeight;
+
+  glBindTexture (GL_TEXTURE_2D, texture);
+  glTexImage2D (GL_TEXTURE_2D, 0, GL_RGB8, texWidth, texHeight, 0,
+		GL_BGR, GL_UNSIGNED_BYTE, NULL);
+
+  if (usePBO) {
+    GLsizeiptr size = (GLsizeiptr) width * height * 3;
+    for (int i = 0; i < 2; i++) {
+      glBindBuffer (GL_PIXEL_UNPACK_BUFFER, pbo[i]);
+      glBufferData (GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+    }
+    glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+}
+
+/*!
+ * @brief  画像をテクスチャに転送する（テクスチャは結びつけておく）
+ *
+ * バッファに書き込んだ直後に glTexSubImage2D で転送を指示するので，
+ * 背景は検出に使った画像と同じフレームになる．転送自体は GPU 側で
+ * 行われ，次のフレームは別のバッファに書き込むので完了を待たない．
+ *
+ * @param[in] pixels  画像データ
+ */
+void BackgroundRenderer::Upload (const GLubyte *pixels)
+{
+  size_t size = (size_t) width * height * 3;
+
+  glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+  if (usePBO) {
+    glBindBuffer (GL_PIXEL_UNPACK_BUFFER, pbo[index]);
+    // 以前の内容は不要なので捨てさせる（転送中でも待たずに新しい領域がもらえる）
+    glBufferData (GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) size, NULL, GL_STREAM_DRAW);
+    void *dst = glMapBuffer (GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+    if (dst != NULL) {
+      memcpy (dst, pixels, size);
+      glUnmapBuffer (GL_PIXEL_UNPACK_BUFFER);
+      glTexSubImage2D (GL_TEXTURE_2D, 0, 0, 0, width, height,
+		       GL_BGR, GL_UNSIGNED_BYTE, (const GLvoid *) 0);
+    } else {
+      glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+      glTexSubImage2D (GL_TEXTURE_2D, 0, 0, 0, width, height,
+		       GL_BGR, GL_UNSIGNED_BYTE, pixels);
+    }
+    glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+    index = (index + 1) % 2;
+  } else {
+    glTexSubImage2D (GL_TEXTURE_2D, 0, 0, 0, width, height,
+		     GL_BGR, GL_UNSIGNED_BYTE, pixels);
+  }
+  glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
+}
+
+/*!
+ * @brief  画像の描画
+ *
+ * 射影行列とモデルビュー行列は単位行列にしたままにする
+ * （呼び出し側は描画のたびに行列を設定しなおしている）．
+ *
+ * @param[in] pixels         画像データ（BGR）
+ * @param[in] image_width    画像の幅
+ * @param[in] image_height   画像の高さ
+ * @param[in] window_width   ウィンドウの幅
+ * @param[in] window_height  ウィンドウの高さ
+ */
+void BackgroundRenderer::Draw (const GLubyte *pixels, int image_width, int image_height,
+			       int window_width, int window_height)
+{
+  if (pixels == NULL || image_width <= 0 || image_height <= 0) return;
+  if (!initialized) Init ();
+
+  glBindTexture (GL_TEXTURE_2D, texture);
+  if (image_width != width || image_height != height) {
+    Resize (image_width, image_height);
+  }
+  Upload (pixels);
+
+  glViewport (0, 0, window_width, window_height);
+  glMatrixMode (GL_PROJECTION);
+  glLoadIdentity ();
+  glMatrixMode (GL_MODELVIEW);
+  glLoadIdentity ();
+
+  // 画像の1行目が画面の上になるように貼る
+  glDisable (GL_DEPTH_TEST);
+  glEnable (GL_TEXTURE_2D);
+  glColor4f (1.0f, 1.0f, 1.0f, 1.0f);
+  glBegin (GL_QUADS);
+  glTexCoord2f (0.0f, 0.0f); glVertex2f (-1.0f,  1.0f);
+  glTexCoord2f (0.0f, maxT); glVertex2f (-1.0f, -1.0f);
+  glTexCoord2f (maxS, maxT); glVertex2f ( 1.0f, -1.0f);
+  glTexCoord2f (maxS, 0.0f); glVertex2f ( 1.0f,  1.0f);
+  glEnd ();
+  glDisable (GL_TEXTURE_2D);
+  glBindTexture (GL_TEXTURE_2D, 0);
+  glEnable (GL_DEPTH_TEST);
+}
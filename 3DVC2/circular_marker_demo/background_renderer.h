@@ -0,0 +1,47 @@
+/*!
+ * @file	background_renderer.h
+ * @brief	背景画像の描画クラス
+ */
+#pragma once
+
+#include <GLFW/glfw3.h>
+#include <GL/glext.h>
+
+/*!
+ * @class  背景画像の描画クラス
+ * @brief　画像を毎フレーム同じテクスチャに転送し，画面全体の四角形に
+ *         貼って描画する．転送は2つのピクセルバッファオブジェクトを交互に
+ *         使うので，前のフレームの転送の完了を待たずに書き込める．
+ *         拡大縮小はテクスチャの補間で行う．
+ */
+class BackgroundRenderer
+{
+ public:
+  // コンストラクタ
+  BackgroundRenderer ();
+
+  // 終了（GL のコンテキストを破棄する前に呼び出す）
+  void Release (void);
+
+  // 画像（BGR, 行の詰め物なし）の描画
+  void Draw (const GLubyte *pixels, int image_width, int image_height,
+	     int window_width, int window_height);
+
+ private:
+  void Init (void);
+  void Resize (int width, int height);
+  void Upload (const GLubyte *pixels);
+
+  bool   initialized;   // GL の機能を調べたかどうか
+  bool   usePBO;        // ピクセルバッファオブジェクトが使えるかどうか
+  bool   useNPOT;       // 2のべき乗以外の大きさのテクスチャが使えるかどうか
+  GLuint texture;       // 背景のテクスチャ
+  GLuint pbo[2];        // 転送用のバッファ
+  int    index;         // 次に書き込むバッファ
+  int    width;         // 画像の大きさ
+  int    height;
+  int    texWidth;      // テクスチャの大きさ
+  int    texHeight;
+  GLfloat maxS;         // 画像の右下のテクスチャ座標
+  GLfloat maxT;
+};
@@ -0,0 +1,219 @@
+/*!
+ * @file	calibration_cache.c
+ * @brief	カメラパラメータと歪み補正テーブルのキャッシュ
+ */
+#include "calibration_cache.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// テーブルの境界
+#define CALIBRATION_CACHE_ALIGNMENT 64
+
+/*!
+ * @brief  コンストラクタ
+ */
+CalibrationCache::CalibrationCache ()
+{
+  mapped     = NULL;
+  mappedSize = 0;
+}
+
+/*!
+ * @brief  デストラクタ
+ */
+CalibrationCache::~CalibrationCache ()
+{
+  Close ();
+}
+
+/*!
+ * @brief  キャッシュの読み込み
+ *
+ * @param[in] name       キャッシュファイル名
+ * @param[in] paramHash  カメラパラメータファイルのハッシュ値
+ * @param[in] size       画像サイズ
+ *
+ * @retval  True or False
+ */
+bool CalibrationCache::Load (const std::string &name, uint64_t paramHash,
+			     const cv::Size &size)
+{
+  Close ();
+
+  int fd = open (name.c_str (), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat (fd, &st) != 0 ||
+      (size_t) st.st_size < sizeof (CalibrationCacheHeader)) {
+    close (fd);
+    return false;
+  }
+  mappedSize = (size_t) st.st_size;
+  void *addr = mmap (NULL, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  if (addr == MAP_FAILED) {
+    mappedSize = 0;
+    return false;
+  }
+  mapped = (unsigned char *) addr;
+
+  // ヘッダのチェック（古いキャッシュは黙って作り直す）
+  CalibrationCacheHeader header;
+  memcpy (&header, mapped, sizeof (header));
+  if (memcmp (header.magic, CALIBRATION_CACHE_MAGIC, 4) != 0 ||
+      header.version != CALIBRATION_CACHE_VERSION ||
+      header.paramHash != paramHash ||
+      header.width != (uint32_t) size.width ||
+      header.height != (uint32_t) size.height ||
+      header.distCount > CALIBRATION_CACHE_MAX_DIST ||
+      header.fileSize != mappedSize) {
+    Close ();
+    return false;
+  }
+
+  internalParams = cv::Mat (3, 3, CV_64FC1, header.A).clone ();
+  distortionParams = cv::Mat ((int) header.distCount, 1, CV_64FC1, header.D).clone ();
+
+  if (header.hasMaps) {
+    size_t map1Bytes = (size_t) size.width * size.height * 2 * sizeof (short);
+    size_t map2Bytes = (size_t) size.width * size.height * sizeof (unsigned short);
+    if (header.map1Offset + map1Bytes > mappedSize ||
+	header.map2Offset + map2Bytes > mappedSize) {
+      Close ();
+      return false;
+    }
+    // テーブルはコピーせずに mmap した領域を参照する
+    map1 = cv::Mat (size, CV_16SC2, mapped + header.map1Offset);
+    map2 = cv::Mat (size, CV_16UC1, mapped + header.map2Offset);
+  }
+
+  return true;
+}
+
+/*!
+ * @brief  キャッシュのクローズ
+ */
+void CalibrationCache::Close (void)
+{
+  map1.release ();
+  map2.release ();
+  if (mapped != NULL) {
+    munmap (mapped, mappedSize);
+  }
+  mapped     = NULL;
+  mappedSize = 0;
+}
+
+/*!
+ * @brief  キャッシュの保存
+ *
+ * 書き込み途中のファイルを読まないように，一時ファイルに書いてから置き換える．
+ *
+ * @param[in] name       キャッシュファイル名
+ * @param[in] paramHash  カメラパラメータファイルのハッシュ値
+ * @param[in] size       画像サイズ
+ * @param[in] A          内部パラメータ
+ * @param[in] D          歪み補正パラメータ
+ * @param[in] map1       歪み補正テーブル（CV_16SC2, 空なら保存しない）
+ * @param[in] map2       歪み補正テーブル（CV_16UC1）
+ *
+ * @retval  True or False
+ */
+bool CalibrationCache::Save (const std::string &name, uint64_t paramHash,
+			     const cv::Size &size, const cv::Mat &A, const cv::Mat &D,
+			     const cv::Mat &map1, const cv::Mat &map2)
+{
+  if (A.total () != 9 || D.total () > CALIBRATION_CACHE_MAX_DIST) {
+    fprintf (stderr, "Invalid camera parameters\n");
+    return false;
+  }
+  bool hasMaps = !map1.empty () && !map2.empty ();
+  if (hasMaps && (map1.type () != CV_16SC2 || map2.type () != CV_16UC1 ||
+		  map1.size () != size || map2.size () != size)) {
+    fprintf (stderr, "Invalid undistortion maps\n");
+    return false;
+  }
+
+  CalibrationCacheHeader header;
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, CALIBRATION_CACHE_MAGIC, 4);
+  header.version   = CALIBRATION_CACHE_VERSION;
+  header.width     = (uint32_t) size.width;
+  header.height    = (uint32_t) size.height;
+  header.paramHash = paramHash;
+  header.distCount = (uint32_t) D.total ();
+  header.hasMaps   = hasMaps ? 1 : 0;
+  cv::Mat A64, D64;
+  A.convertTo (A64, CV_64F);
+  D.convertTo (D64, CV_64F);
+  A64 = A64.reshape (1, 1).clone ();
+  D64 = D64.reshape (1, 1).clone ();
+  memcpy (header.A, A64.data, 9 * sizeof (double));
+  memcpy (header.D, D64.data, header.distCount * sizeof (double));
+
+  size_t offset = (sizeof (header) + CALIBRATION_CACHE_ALIGNMENT - 1)
+    / CALIBRATION_CACHE_ALIGNMENT * CALIBRATION_CACHE_ALIGNMENT;
+  size_t map1Bytes = hasMaps ? map1.total () * map1.elemSize () : 0;
+  size_t map2Bytes = hasMaps ? map2.total () * map2.elemSize () : 0;
+  header.map1Offset = hasMaps ? offset : 0;
+  offset += (map1Bytes + CALIBRATION_CACHE_ALIGNMENT - 1)
+    / CALIBRATION_CACHE_ALIGNMENT * CALIBRATION_CACHE_ALIGNMENT;
+  header.map2Offset = hasMaps ? offset : 0;
+  header.fileSize   = hasMaps ? offset + map2Bytes : sizeof (header);
+
+  std::vector<unsigned char> buffer ((size_t) header.fileSize, 0);
+  memcpy (&buffer[0], &header, sizeof (header));
+  if (hasMaps) {
+    cv::Mat m1 = map1.isContinuous () ? map1 : map1.clone ();
+    cv::Mat m2 = map2.isContinuous () ? map2 : map2.clone ();
+    memcpy (&buffer[header.map1Offset], m1.data, map1Bytes);
+    memcpy (&buffer[header.map2Offset], m2.data, map2Bytes);
+  }
+
+  std::string tmpName = name + ".tmp";
+  FILE *fp = fopen (tmpName.c_str (), "wb");
+  if (fp == NULL) {
+    fprintf (stderr, "Cannot open %s\n", tmpName.c_str ());
+    return false;
+  }
+  bool ok = fwrite (&buffer[0], 1, buffer.size (), fp) == buffer.size ();
+  ok = (fclose (fp) == 0) && ok;
+  if (!ok || rename (tmpName.c_str (), name.c_str ()) != 0) {
+    fprintf (stderr, "Cannot write %s\n", name.c_str ());
+    unlink (tmpName.c_str ());
+    return false;
+  }
+  return true;
+}
+
+/*!
+ * @brief  ファイル内容のハッシュ値
+ *
+ * @param[in]  name  ファイル名
+ * @param[out] hash  ハッシュ値（FNV-1a, 64ビット）
+ *
+ * @retval  True or False
+ */
+bool CalibrationCache::HashFile (const std::string &name, uint64_t &hash)
+{
+  FILE *fp = fopen (name.c_str (), "rb");
+  if (fp == NULL) return false;
+
+  hash = 14695981039346656037ULL;
+  unsigned char buffer[4096];
+  size_t n;
+  while ((n = fread (buffer, 1, sizeof (buffer), fp)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      hash ^= buffer[i];
+      hash *= 1099511628211ULL;
+    }
+  }
+  bool ok = !ferror (fp);
+  fclose (fp);
+  return ok;
+}
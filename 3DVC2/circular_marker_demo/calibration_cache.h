@@ -0,0 +1,77 @@
+/*!
+ * @file	calibration_cache.h
+ * @brief	カメラパラメータと歪み補正テーブルのキャッシュ
+ *
+ * ファイル構成:
+ *   [CalibrationCacheHeader][map1 (CV_16SC2)][map2 (CV_16UC1)]
+ * 歪み補正テーブルは cv::convertMaps の固定小数点形式で保存し，
+ * mmap した領域をそのまま cv::remap に渡す．
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+// ファイル識別子とバージョン
+#define CALIBRATION_CACHE_MAGIC    "CALC"
+#define CALIBRATION_CACHE_VERSION  1
+// 歪み補正パラメータの最大数（cv::initUndistortRectifyMap が扱える数）
+#define CALIBRATION_CACHE_MAX_DIST 14
+
+/*!
+ * @brief  ファイルヘッダ（リトルエンディアン）
+ */
+typedef struct _CalibrationCacheHeader {
+  char     magic[4];     // "CALC"
+  uint32_t version;      // フォーマットのバージョン
+  uint32_t width;        // 画像の幅
+  uint32_t height;       // 画像の高さ
+  uint64_t paramHash;    // カメラパラメータファイルのハッシュ値
+  uint32_t distCount;    // 歪み補正パラメータの数
+  uint32_t hasMaps;      // 歪み補正テーブルを含むかどうか
+  double   A[9];         // 内部パラメータ
+  double   D[CALIBRATION_CACHE_MAX_DIST]; // 歪み補正パラメータ
+  uint64_t map1Offset;   // map1 のファイル内オフセット
+  uint64_t map2Offset;   // map2 のファイル内オフセット
+  uint64_t fileSize;     // ファイルサイズ
+} CalibrationCacheHeader;
+
+/*!
+ * @class  カメラパラメータのキャッシュクラス
+ * @brief　XML の解析と歪み補正テーブルの計算を次回以降の起動で省く
+ */
+class CalibrationCache
+{
+ public:
+  // コンストラクタ
+  CalibrationCache ();
+
+  // デストラクタ
+  ~CalibrationCache ();
+
+  // キャッシュの読み込み（サイズとハッシュ値が一致しない場合は false）
+  bool Load (const std::string &name, uint64_t paramHash, const cv::Size &size);
+  void Close (void);
+
+  // キャッシュの保存
+  static bool Save (const std::string &name, uint64_t paramHash,
+		    const cv::Size &size, const cv::Mat &A, const cv::Mat &D,
+		    const cv::Mat &map1, const cv::Mat &map2);
+
+  // ファイル内容のハッシュ値（FNV-1a, 64ビット）
+  static bool HashFile (const std::string &name, uint64_t &hash);
+
+  // メンバー（map1, map2 はキャッシュをクローズするまで有効）
+  cv::Mat internalParams;     // カメラの内部パラメータ
+  cv::Mat distortionParams;   // 歪み補正パラメータ
+  cv::Mat map1;               // 歪み補正テーブル（CV_16SC2）
+  cv::Mat map2;               // 歪み補正テーブル（CV_16UC1）
+
+ private:
+  unsigned char *mapped;      // mmap した領域の先頭
+  size_t mappedSize;          // mmap した領域のサイズ
+
+  CalibrationCache (const CalibrationCache&);
+  CalibrationCache& operator= (const CalibrationCache&);
+};
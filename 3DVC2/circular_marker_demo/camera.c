@@ -1,441 +1,477 @@
-/*!
- * @file	camera.c
- * @brief	カメラでの映像撮影クラス
- */
-#include "camera.h"
-
-/*!
- * @brief  コンストラクタ
- */
-CCamera::CCamera ()
-{
-  deviceID         = 0;
-  inputMode        = INPUT_CAMERA;
-  outputMode       = OUTPUT_WINDOW_AND_FILE;
-  flipFlag         = false;
-  undistortionFlag = false;
-  inputFileName    = "";
-  outputFileName   = "";
-}
-
-/*!
- * @brief コンストラクタ
- *
- * @param[in] _deviceID          デバイスID
- * @param[in] _inputMode         入力モード
- * @param[in] _outputMode        出力モード
- * @param[in] _flipFlag          入力を反転するかのフラグ
- * @param[in] _undistortionFlag  歪み補正をするかのフラグ
- */
-CCamera::CCamera (int _deviceID,
-		  int _inputMode,
-		  int _outputMode,
-		  bool _flipFlag,
-		  bool _undistortionFlag)
-{
-  deviceID         = _deviceID;
-  inputMode        = _inputMode;
-  outputMode       = _outputMode;
-  flipFlag         = _flipFlag;
-  undistortionFlag = _undistortionFlag;
-  inputFileName    = "";
-  outputFileName   = "";
-}
-
-/*!
- * @brief  デストラクタ
- */
-CCamera::~CCamera ()
-{
-  Close();
-}
-
-/*!
- * @brief　カメラのクローズ
- */
-void CCamera::Close (void)
-{
-#ifdef USEPGR
-  if (PGRCapture.IsConnected ()){
-    FlyCapture2::Error error;
-    error = mPGRCapture.StopCapture ();
-    if (error != FlyCapture2::PGRERROR_OK){
-      fprintf(stderr, "error at %d in %s\n", __LINE__, __FUNCTION__);
-    }
-    error = PGRCapture.Disconnect();
-    if (error != FlyCapture2::PGRERROR_OK){
-      fprintf(stderr, "error at %d in %s\n", __LINE__, __FUNCTION__);
-    }
-  }
-#endif
-  if (capture.isOpened ()) capture.release ();
-}
-
-/*!
- * @brief  カメラまたはビデオ画像をオープンする関数
- *
- * @param[in]	name		入力ビデオファイル名
- * @param[out]	width		ビデオ画像の横サイズ
- * @param[out]	height		ビデオ画像の縦サイズ
- * @param[out]	channels	ビデオ画像のチャネル数
- *
- * @retval	True or False
- */
-bool CCamera::Open (int &w, int &h, int &c)
-{
-  if (inputMode == CCamera::INPUT_VIDEO) {
-    return OpenVideo(inputFileName, w, h, c);
-  }
-  else {
-    return OpenCamera(w, h, c);
-  }
-}
-
-/*!
- * @brief　カメラのオープン
- *
- * @param[out]	w	画像の横サイズ
- * @param[out]	h	画像の縦サイズ
- * @param[out]	c	画像のチャネル数
- *
- * @retval  True or False   
- */
-bool CCamera::OpenCamera (int &w, int &h, int &c)
-{
-  inputMode = CCamera::INPUT_CAMERA;
-#ifdef USEPGR
-  if (!PGRCapture.IsConnected ()){
-    FlyCapture2::Error error;
-    // カメラへの接続
-    error = PGRCapture.Connect (0);
-    if (error != FlyCapture2::PGRERROR_OK) {
-      return false;
-    }
-    // カメラ情報の取得
-    FlyCapture2::CameraInfo camInfo;
-    error = PGRCapture.GetCameraInfo (&camInfo);
-    if (error != FlyCapture2::PGRERROR_OK) {
-      return false;
-    }
-    // 画像取得開始
-    error = mPGRCap.StartCapture ();
-    if (error != FlyCapture2::PGRERROR_OK) {
-      return false;
-    }
-    // 画像の取得
-    FlyCapture2::Image raw;
-    error = PGRCapture.RetrieveBuffer (&raw);
-    if (error != FlyCapture2::PGRERROR_OK) {
-      return false;
-    }
-    // 画像サイズの取得
-    w = width = raw.GetCols() / 2;
-    h = height = raw.GetRows() / 2;
-    c = channels = 3;
-    imageSize = width * height * channels;
-    image = cv::Mat (cv::Size (width, height), CV_8UC3);
-		
-    return true;
-  }
-  else {
-    return false;
-  }
-#else
-  if (!capture.isOpened ()) {
-    // カメラデバイスのオープン
-    if (deviceID != -1) {
-      if (!capture.open (deviceID)) {
-	fprintf (stderr, "Camera ID %d is not found\n", deviceID);
-	return false;
-      }
-    } else {
-      for (int n = 0; n < 5; n++) {
-	if (!capture.open (n)) {
-	  fprintf (stderr, "Camera ID %d is not found\n", n);
-	} else {
-	  fprintf (stdout, "Camera is opened on device ID %d\n", n);
-	  deviceID = n;
-	  break;
-	}
-      }
-      if (deviceID == -1) return false;
-    }
-    // 画像サイズの設定
-    capture.set (cv::CAP_PROP_FRAME_WIDTH, w);
-    capture.set (cv::CAP_PROP_FRAME_HEIGHT, h);
-
-    // 画像取得チェック
-    int count = 0;
-    while (image.data == NULL) {
-      capture >> image;
-      ++count;
-      if (count > 10) {
-	fprintf(stderr, "Cannot retrieve images\n");
-	// 指定した画像サイズで画像を取得できなかった場合は、
-	// 画像サイズをVGAにして再チェック
-	w = 640;
-	h = 480;
-	capture.set (cv::CAP_PROP_FRAME_WIDTH, w);
-	capture.set (cv::CAP_PROP_FRAME_HEIGHT, h);
-	count = 0;
-	while (image.data == NULL) {
-	  capture >> image;
-	  ++count;
-	  if (count > 10){
-	    fprintf(stderr, "Cannot retrieve images\n");
-	    return false;
-	  }
-	}
-      }
-    }
-    width = image.cols;
-    height = image.rows;
-    channels = c = image.channels();
-    imageSize = height * (int) image.step;
-
-    return true;
-  } else {
-    return false;
-  }
-#endif
-}
-
-/*!
- * @brief  入力ビデオのオープン
- *
- * @param[in]	name		入力ビデオファイル名
- * @param[out]	width		ビデオ画像の横サイズ
- * @param[out]	height		ビデオ画像の縦サイズ
- * @param[out]	channels	ビデオ画像のチャネル数
- *
- * @retval	True or False
- */
-bool CCamera::OpenVideo (const std::string &name, int &w, int &h, int &c)
-{
-  inputMode = CCamera::INPUT_VIDEO;
-  inputFileName = name;
-
-  bool isOpen = capture.open (inputFileName);
-  if (isOpen) {
-    capture >> image;
-    w = width = image.cols;
-    h = height = image.rows;
-    c = channels = image.channels ();
-    imageSize = height * (int) image.step;
-  }
-  return isOpen;
-}
-
-/*! 
- * @brief  入力ビデオファイル名の登録
- *
- * @param[in] name  入力ビデオファイル名
- */
-void CCamera::SetInputFile (const std::string& name)
-{
-  inputMode = INPUT_VIDEO;
-  inputFileName = name;
-}
-
-/*! 
- * @brief  入力ビデオファイル名の取得
- * 
- * @return 入力ビデオファイル名
- */
-std::string CCamera::GetInputFile (void)
-{
-  return inputFileName;
-}
-
-/*!
- * @brief　出力ビデオ画像の設定
- * @param[in]	name	出力ビデオファイル名
- * @param[in]	fps		フレームレート
- * @retval　True or Flase
- */
-bool CCamera::SaveVideoSetting (const std::string &name, const float fps)
-{
-  bool isOpen;
-#ifdef USEPGR
-  isOpen = PGRCapture.IsConnected ();
-#else
-  isOpen = capture.isOpened ();
-#endif
-  if (isOpen) {	
-    outputMode = OUTPUT_WINDOW_AND_VIDEO;
-    outputFileName = name;
-    bool isColor = (channels == 3) ? true : false;
-    return writer.open (outputFileName,
-			int (NULL), fps, cv::Size(width, height), isColor);
-  } else {
-    return false;
-  }
-}
-
-/*!
- * @brief  画像の取得
- * @param[out]	img		取得した画像
- *
- * @retval	True or False
- */
-bool CCamera::CaptureImage (void)
-{
-#ifdef USEPGR
-  if (videoFlag) {
-    capture >> image;
-    if (image.empty ()) {
-      capture.open (fileName);
-      capture >> image;
-    }
-  } else if (PGRCapture.IsConnected ()) {
-    FlyCapture2::Error error;
-    FlyCapture2::Image raw;
-    error = PGRCapture.RetrieveBuffer (&raw);
-    if (error != FlyCapture2::PGRERROR_OK) {
-      fprintf (stderr, "error at %d in %s\n", __LINE__, __FUNCTION__);
-    }
-    FlyCapture2::Image PGRimg;
-    error = raw.Convert (FlyCapture2::PIXEL_FORMAT_BGR, &PGRimg);
-    if (error != FlyCapture2::PGRERROR_OK) {
-      fprintf (stderr, "error at %d in %s\n", __LINE__, __FUNCTION__);
-    }
-    cv::Mat cvImg(cv::Size(raw.GetCols (), raw.GetRows ()), CV_8UC3);
-    int bufferSize
-      = sizeof (unsigned char) * PGRimg.GetCols() * PGRimg.GetRows() * 3;
-    memcpy_s (cvImg.data, bufferSize, PGRimg.GetData (), bufferSize);
-    cv::resize (cvImg, image, image.size());
-  } else {
-    return false;
-  }
-#else
-  if (capture.isOpened ()) {
-    capture >> image;
-    if (image.data == NULL) return false;
-  } else {
-    fprintf (stderr, "Failed to capture\n");
-    return false;
-  }
-#endif
-  if (undistortionFlag) {
-    cv::remap (image.clone (), image, mapx, mapy, cv::INTER_LINEAR);
-  }
-  if (flipFlag) {
-    cv::flip(image.clone(), image, 1);
-  }
-  return true;
-}
-
-/*!
- * @brief 画像の保存
- *
- * @param[in] name  出力画像ファイル名
- */
-void CCamera::SaveImage (const std::string &name)
-{
-  if (outputMode == CCamera::OUTPUT_WINDOW_AND_FILE &&
-      name != "") {
-    cv::imwrite (name, image);
-  } else {
-    writer << image;
-  }
-}
-
-/*!
- * @brief カメラパラメータの読み込み（カメラをオープンしてから呼び出す）
- *
- * @param[in]	name		  カメラパラメータファイル名
- * @param[in]	undistortion  画像の歪みを補正するかどうかのフラグ
- *
- * @retval	True or False
- */
-bool CCamera::LoadParameters (const std::string &name,
-			      const bool undistortion)
-{
-  cv::FileStorage fs;
-  if (!fs.open (name, cv::FileStorage::READ)) {
-    fprintf (stderr, "Cannot load camera parameters\n");
-    return false;
-  }
-  //cv::FileNode node (fs.fs, NULL);
-
-  //cv::read(node["A"], internalParams);
-  //cv::read(node["D"], distortionParams);
-
-  undistortionFlag = undistortion;
-
-  if (undistortionFlag) {
-    cv::initUndistortRectifyMap (internalParams,
-				 distortionParams,
-				 cv::Mat (),
-				 internalParams,
-				 image.size (),
-				 CV_32FC1, mapx, mapy);
-    distortionParams = cv::Mat_<double>::zeros(5, 1);
-  }
-  return true;
-}
-
-/*!
- * @brief  カメラパラメータの保存
- *
- * @param[in]	name  カメラパラメータを保存するファイル名
- *
- * @retval  True of False
- */
-bool CCamera::SaveParameters (const std::string &name) const
-{
-  if (internalParams.empty () || distortionParams.empty ()) {
-    fprintf (stderr, "Empty parameters\n");
-    return false;
-  }
-  cv::FileStorage fs;
-  fs.open (name + ".xml", cv::FileStorage::WRITE);
-  cv::write (fs, "A", internalParams);
-  cv::write (fs, "D", distortionParams);
-
-  fs.release();
-
-  return true;
-}
-
-/*!
- * @breif	画像の横サイズの取得
- * 
- * @retval	画像の横サイズ
- */
-int CCamera::GetImageWidth(void)
-{
-  return width;
-}
-
-/*!
- * @breif	画像の縦サイズの取得
- *
- * @retval	画像の縦サイズ
- */
-int CCamera::GetImageHeight(void)
-{
-  return height;
-}
-
-/*! 
- * @breif  カメラデバイスIDの設定
- *
- * @param[in] _deviceID  カメラのデバイスID
- */
-void CCamera::SetDeviceID(int _deviceID)
-{
-  deviceID = _deviceID;
-  std::cout << "Set devide ID to " << deviceID << std::endl;
-
-}
-
-/*!
- * @brief  カメラデバイスIDの取得
- *
- * retval  カメラのデバイスID
- */
-int  CCamera::GetDeviceID(void)
-{
-  return deviceID;
-}
+/*!
+ * @file	camera.c
+ * @brief	カメラでの映像撮影クラス
+ */
+#include "camera.h"
+
+/*!
+ * @brief  コンストラクタ
+ */
+CCamera::CCamera ()
+{
+  deviceID         = 0;
+  inputMode        = INPUT_CAMERA;
+  outputMode       = OUTPUT_WINDOW_AND_FILE;
+  flipFlag         = false;
+  undistortionFlag = false;
+  inputFileName    = "";
+  outputFileName   = "";
+  timestamp        = 0;
+}
+
+/*!
+ * @brief コンストラクタ
+ *
+ * @param[in] _deviceID          デバイスID
+ * @param[in] _inputMode         入力モード
+ * @param[in] _outputMode        出力モード
+ * @param[in] _flipFlag          入力を反転するかのフラグ
+ * @param[in] _undistortionFlag  歪み補正をするかのフラグ
+ */
+CCamera::CCamera (int _deviceID,
+		  int _inputMode,
+		  int _outputMode,
+		  bool _flipFlag,
+		  bool _undistortionFlag)
+{
+  deviceID         = _deviceID;
+  inputMode        = _inputMode;
+  outputMode       = _outputMode;
+  flipFlag         = _flipFlag;
+  undistortionFlag = _undistortionFlag;
+  inputFileName    = "";
+  outputFileName   = "";
+  timestamp        = 0;
+}
+
+/*!
+ * @brief  デストラクタ
+ */
+CCamera::~CCamera ()
+{
+  Close();
+}
+
+/*!
+ * @brief　カメラのクローズ
+ */
+void CCamera::Close (void)
+{
+  StopRecorder ();
+  rawWriter.Close ();
+  if (source) {
+    source->Close ();
+    source.reset ();
+  }
+}
+
+/*!
+ * @brief  入力モードに応じた入力元をオープンする関数
+ *
+ * @param[in,out]	w	画像の横サイズ
+ * @param[in,out]	h	画像の縦サイズ
+ * @param[out]		c	画像のチャネル数
+ *
+ * @retval	True or False
+ */
+bool CCamera::Open (int &w, int &h, int &c)
+{
+  if (source && source->IsOpened ()) {
+    return false;
+  }
+  switch (inputMode) {
+  case INPUT_VIDEO:
+    source.reset (new VideoFileSource (inputFileName));
+    break;
+  case INPUT_IMAGES:
+    source.reset (new ImageSequenceSource (inputFileName));
+    break;
+  case INPUT_RAW:
+    source.reset (new RawFileSource (inputFileName));
+    break;
+  case INPUT_SYNTHETIC:
+    source.reset (new SyntheticMarkerSource ());
+    break;
+  default:
+    source.reset (new CameraSource (deviceID));
+    break;
+  }
+  if (!source->Open (w, h, c)) {
+    source.reset ();
+    return false;
+  }
+  if (inputMode == INPUT_CAMERA) {
+    deviceID = static_cast<CameraSource*> (source.get ())->deviceID;
+  }
+
+  // 最初の画像を取得して画像サイズを確定する
+  if (!source->Grab (frame)) {
+    fprintf (stderr, "Cannot retrieve images\n");
+    Close ();
+    return false;
+  }
+  frame.copyTo (image);
+  w = width = image.cols;
+  h = height = image.rows;
+  c = channels = image.channels ();
+  imageSize = height * (int) image.step;
+
+  return true;
+}
+
+/*!
+ * @brief　カメラのオープン
+ *
+ * @param[out]	w	画像の横サイズ
+ * @param[out]	h	画像の縦サイズ
+ * @param[out]	c	画像のチャネル数
+ *
+ * @retval  True or False   
+ */
+bool CCamera::OpenCamera (int &w, int &h, int &c)
+{
+  inputMode = CCamera::INPUT_CAMERA;
+  return Open (w, h, c);
+}
+
+/*!
+ * @brief  入力ビデオのオープン
+ *
+ * @param[in]	name		入力ビデオファイル名
+ * @param[out]	width		ビデオ画像の横サイズ
+ * @param[out]	height		ビデオ画像の縦サイズ
+ * @param[out]	channels	ビデオ画像のチャネル数
+ *
+ * @retval	True or False
+ */
+bool CCamera::OpenVideo (const std::string &name, int &w, int &h, int &c)
+{
+  inputMode = CCamera::INPUT_VIDEO;
+  inputFileName = name;
+  return Open (w, h, c);
+}
+
+/*!
+ * @brief  連番画像のオープン
+ *
+ * @param[in]	pattern	ディレクトリ名または cv::glob のパターン
+ * @param[out]	w	画像の横サイズ
+ * @param[out]	h	画像の縦サイズ
+ * @param[out]	c	画像のチャネル数
+ *
+ * @retval	True or False
+ */
+bool CCamera::OpenImages (const std::string &pattern, int &w, int &h, int &c)
+{
+  inputMode = CCamera::INPUT_IMAGES;
+  inputFileName = pattern;
+  return Open (w, h, c);
+}
+
+/*!
+ * @brief  無圧縮フレームファイル(.raw)のオープン
+ *
+ * @param[in]	name	入力ファイル名
+ * @param[out]	w	画像の横サイズ
+ * @param[out]	h	画像の縦サイズ
+ * @param[out]	c	画像のチャネル数
+ *
+ * @retval	True or False
+ */
+bool CCamera::OpenRaw (const std::string &name, int &w, int &h, int &c)
+{
+  inputMode = CCamera::INPUT_RAW;
+  inputFileName = name;
+  return Open (w, h, c);
+}
+
+/*!
+ * @brief  合成画像の入力のオープン
+ *
+ * @param[in,out]	w	画像の横サイズ
+ * @param[in,out]	h	画像の縦サイズ
+ * @param[out]		c	画像のチャネル数
+ *
+ * @retval	True or False
+ */
+bool CCamera::OpenSynthetic (int &w, int &h, int &c)
+{
+  inputMode = CCamera::INPUT_SYNTHETIC;
+  return Open (w, h, c);
+}
+
+/*! 
+ * @brief  入力ビデオファイル名の登録
+ *
+ * @param[in] name  入力ビデオファイル名
+ */
+void CCamera::SetInputFile (const std::string& name)
+{
+  inputMode = INPUT_VIDEO;
+  inputFileName = name;
+}
+
+/*! 
+ * @brief  入力ビデオファイル名の取得
+ * 
+ * @return 入力ビデオファイル名
+ */
+std::string CCamera::GetInputFile (void)
+{
+  return inputFileName;
+}
+
+/*!
+ * @brief　出力ビデオ画像の設定
+ *
+ * 拡張子が .raw のときは再エンコードせずに無圧縮フレームファイルに保存する．
+ *
+ * @param[in]	name	出力ビデオファイル名
+ * @param[in]	fps		フレームレート
+ * @retval　True or Flase
+ */
+bool CCamera::SaveVideoSetting (const std::string &name, const float fps)
+{
+  bool isOpen = source && source->IsOpened ();
+  if (!isOpen) {
+    return false;
+  }
+  StopRecorder ();
+  if (name.size () > 4 &&
+      name.compare (name.size () - 4, 4, ".raw") == 0) {
+    outputMode = OUTPUT_WINDOW_AND_RAW;
+    outputFileName = name;
+    if (!rawWriter.Open (outputFileName, width, height, image.type ())) {
+      return false;
+    }
+    return recorder.Start ([this] (const cv::Mat &img, int64_t t,
+				   const std::string &) {
+			     rawWriter.Write (img, t);
+			   });
+  } else {
+    outputMode = OUTPUT_WINDOW_AND_VIDEO;
+    outputFileName = name;
+    bool isColor = (channels == 3) ? true : false;
+    if (!writer.open (outputFileName,
+		      int (NULL), fps, cv::Size(width, height), isColor)) {
+      return false;
+    }
+    return recorder.Start ([this] (const cv::Mat &img, int64_t,
+				   const std::string &) {
+			     writer << img;
+			   });
+  }
+}
+
+/*!
+ * @brief　ビデオ出力の終了（キューに残った画像を保存してから閉じる）
+ */
+void CCamera::CloseVideo (void)
+{
+  StopRecorder ();
+  rawWriter.Close ();
+  if (writer.isOpened ()) writer.release ();
+  outputMode = OUTPUT_WINDOW_AND_FILE;
+}
+
+/*!
+ * @brief　保存スレッドの終了
+ */
+void CCamera::StopRecorder (void)
+{
+  if (!recorder.IsRunning ()) return;
+  recorder.Stop ();
+  fprintf (stderr, "Saved %llu frames, dropped %llu frames\n",
+	   (unsigned long long) recorder.encodedFrames,
+	   (unsigned long long) recorder.droppedFrames);
+}
+
+/*!
+ * @brief  画像の取得
+ * @param[out]	img		取得した画像
+ *
+ * @retval	True or False
+ */
+bool CCamera::CaptureImage (void)
+{
+  if (!source || !source->Grab (frame)) {
+    fprintf (stderr, "Failed to capture\n");
+    return false;
+  }
+  timestamp = source->Timestamp ();
+  if (timestamp < 0) {
+    timestamp = (int64_t) (cv::getTickCount () * 1.0e+6 / cv::getTickFrequency ());
+  }
+
+  // ビデオ・無圧縮フレームファイルへの記録は，歪み補正や反転，マーカーの
+  // 描画の前の入力画像を入力元の時刻とともに行う（再生で同じ入力を再現する）
+  if (outputMode != OUTPUT_WINDOW_AND_FILE && recorder.IsRunning ()) {
+    recorder.Push (frame, timestamp);
+  }
+
+  // 入力元の画像（mmap した領域など）は書き換えず，歪み補正と反転の結果は
+  // カメラが持つ image に書き込む（反転はその場で行える）
+  if (undistortionFlag) {
+    cv::remap (frame, image, mapx, mapy, cv::INTER_LINEAR);
+    if (flipFlag) cv::flip (image, image, 1);
+  } else if (flipFlag) {
+    cv::flip (frame, image, 1);
+  } else {
+    frame.copyTo (image);
+  }
+  return true;
+}
+
+/*!
+ * @brief 画像の保存
+ *
+ * 保存（エンコード）は別スレッドで行う．保存が追いつかない場合は
+ * recorder.policy に従って待つか画像を捨てる．ビデオ出力中は
+ * CaptureImage が入力画像を記録するので何もしない．
+ *
+ * @param[in] name  出力画像ファイル名
+ */
+void CCamera::SaveImage (const std::string &name)
+{
+  if (outputMode != CCamera::OUTPUT_WINDOW_AND_FILE || name == "") return;
+  if (!recorder.IsRunning ()) {
+    recorder.Start ([] (const cv::Mat &img, int64_t,
+			const std::string &fileName) {
+		      cv::imwrite (fileName, img);
+		    });
+  }
+  recorder.Push (image, timestamp, name);
+}
+
+/*!
+ * @brief カメラパラメータの読み込み（カメラをオープンしてから呼び出す）
+ *
+ * 読み込んだパラメータと歪み補正テーブルは name + ".cache" に保存しておき，
+ * 次回からはパラメータファイルの内容と画像サイズが同じであれば
+ * XML の解析とテーブルの計算を省いてキャッシュを mmap する．
+ *
+ * @param[in]	name		  カメラパラメータファイル名
+ * @param[in]	undistortion  画像の歪みを補正するかどうかのフラグ
+ *
+ * @retval	True or False
+ */
+bool CCamera::LoadParameters (const std::string &name,
+			      const bool undistortion)
+{
+  uint64_t hash;
+  if (!CalibrationCache::HashFile (name, hash)) {
+    fprintf (stderr, "Cannot load camera parameters\n");
+    return false;
+  }
+  std::string cacheName = name + ".cache";
+  cv::Size size = image.size ();
+
+  undistortionFlag = undistortion;
+  mapx.release ();
+  mapy.release ();
+
+  if (calibCache.Load (cacheName, hash, size) &&
+      (!undistortionFlag || !calibCache.map1.empty ())) {
+    internalParams   = calibCache.internalParams;
+    distortionParams = calibCache.distortionParams;
+  } else {
+    calibCache.Close ();
+    cv::FileStorage fs;
+    if (!fs.open (name, cv::FileStorage::READ)) {
+      fprintf (stderr, "Cannot load camera parameters\n");
+      return false;
+    }
+    fs["A"] >> internalParams;
+    fs["D"] >> distortionParams;
+    if (internalParams.empty () || distortionParams.empty ()) {
+      fprintf (stderr, "Invalid camera parameters\n");
+      return false;
+    }
+
+    if (undistortionFlag) {
+      // cv::remap が速い固定小数点形式のテーブルを作る
+      cv::initUndistortRectifyMap (internalParams,
+				   distortionParams,
+				   cv::Mat (),
+				   internalParams,
+				   size,
+				   CV_16SC2, mapx, mapy);
+    }
+    CalibrationCache::Save (cacheName, hash, size, internalParams,
+			    distortionParams, mapx, mapy);
+  }
+
+  if (undistortionFlag) {
+    if (mapx.empty ()) {
+      mapx = calibCache.map1;
+      mapy = calibCache.map2;
+    }
+    distortionParams = cv::Mat_<double>::zeros(5, 1);
+  }
+  return true;
+}
+
+/*!
+ * @brief  カメラパラメータの保存
+ *
+ * @param[in]	name  カメラパラメータを保存するファイル名
+ *
+ * @retval  True of False
+ */
+bool CCamera::SaveParameters (const std::string &name) const
+{
+  if (internalParams.empty () || distortionParams.empty ()) {
+    fprintf (stderr, "Empty parameters\n");
+    return false;
+  }
+  cv::FileStorage fs;
+  fs.open (name + ".xml", cv::FileStorage::WRITE);
+  cv::write (fs, "A", internalParams);
+  cv::write (fs, "D", distortionParams);
+
+  fs.release();
+
+  return true;
+}
+
+/*!
+ * @breif	画像の横サイズの取得
+ * 
+ * @retval	画像の横サイズ
+ */
+int CCamera::GetImageWidth(void)
+{
+  return width;
+}
+
+/*!
+ * @breif	画像の縦サイズの取得
+ *
+ * @retval	画像の縦サイズ
+ */
+int CCamera::GetImageHeight(void)
+{
+  return height;
+}
+
+/*! 
+ * @breif  カメラデバイスIDの設定
+ *
+ * @param[in] _deviceID  カメラのデバイスID
+ */
+void CCamera::SetDeviceID(int _deviceID)
+{
+  deviceID = _deviceID;
+  std::cout << "Set devide ID to " << deviceID << std::endl;
+
+}
+
+/*!
+ * @brief  カメラデバイスIDの取得
+ *
+ * retval  カメラのデバイスID
+ */
+int  CCamera::GetDeviceID(void)
+{
+  return deviceID;
+}
@@ -0,0 +1,608 @@
+/*!
+ * @file	frame_source.c
+ * @brief	画像の入力元クラス
+ */
+#include "frame_source.h"
+#include <algorithm>
+#include <math.h>
+
+/* ************************************************************************* *
+ * カメラ
+ * ************************************************************************* */
+
+/*!
+ * @brief  コンストラクタ
+ *
+ * @param[in] _deviceID  デバイスID
+ */
+CameraSource::CameraSource (int _deviceID)
+{
+  deviceID = _deviceID;
+}
+
+/*!
+ * @brief  デストラクタ
+ */
+CameraSource::~CameraSource ()
+{
+  Close ();
+}
+
+/*!
+ * @brief　カメラのオープン
+ *
+ * @param[in,out]	w	画像の横サイズ
+ * @param[in,out]	h	画像の縦サイズ
+ * @param[out]		c	画像のチャネル数
+ *
+ * @retval  True or False
+ */
+bool CameraSource::Open (int &w, int &h, int &c)
+{
+#ifdef USEPGR
+  if (!PGRCapture.IsConnected ()){
+    FlyCapture2::Error error;
+    // カメラへの接続
+    error = PGRCapture.Connect (0);
+    if (error != FlyCapture2::PGRERROR_OK) {
+      return false;
+    }
+    // カメラ情報の取得
+    FlyCapture2::CameraInfo camInfo;
+    error = PGRCapture.GetCameraInfo (&camInfo);
+    if (error != FlyCapture2::PGRERROR_OK) {
+      return false;
+    }
+    // 画像取得開始
+    error = PGRCapture.StartCapture ();
+    if (error != FlyCapture2::PGRERROR_OK) {
+      return false;
+    }
+    // 画像の取得
+    FlyCapture2::Image raw;
+    error = PGRCapture.RetrieveBuffer (&raw);
+    if (error != FlyCapture2::PGRERROR_OK) {
+      return false;
+    }
+    // 画像サイズの取得
+    w = raw.GetCols() / 2;
+    h = raw.GetRows() / 2;
+    c = 3;
+    size = cv::Size (w, h);
+    return true;
+  }
+  else {
+    return false;
+  }
+#else
+  if (!capture.isOpened ()) {
+    // カメラデバイスのオープン
+    if (deviceID != -1) {
+      if (!capture.open (deviceID)) {
+	fprintf (stderr, "Camera ID %d is not found\n", deviceID);
+	return false;
+      }
+    } else {
+      for (int n = 0; n < 5; n++) {
+	if (!capture.open (n)) {
+	  fprintf (stderr, "Camera ID %d is not found\n", n);
+	} else {
+	  fprintf (stdout, "Camera is opened on device ID %d\n", n);
+	  deviceID = n;
+	  break;
+	}
+      }
+      if (deviceID == -1) return false;
+    }
+    // 画像サイズの設定
+    capture.set (cv::CAP_PROP_FRAME_WIDTH, w);
+    capture.set (cv::CAP_PROP_FRAME_HEIGHT, h);
+
+    // 画像取得チェック
+    cv::Mat image;
+    int count = 0;
+    while (image.data == NULL) {
+      capture >> image;
+      ++count;
+      if (count > 10) {
+	fprintf(stderr, "Cannot retrieve images\n");
+	// 指定した画像サイズで画像を取得できなかった場合は、
+	// 画像サイズをVGAにして再チェック
+	w = 640;
+	h = 480;
+	capture.set (cv::CAP_PROP_FRAME_WIDTH, w);
+	capture.set (cv::CAP_PROP_FRAME_HEIGHT, h);
+	count = 0;
+	while (image.data == NULL) {
+	  capture >> image;
+	  ++count;
+	  if (count > 10){
+	    fprintf(stderr, "Cannot retrieve images\n");
+	    return false;
+	  }
+	}
+      }
+    }
+    w = image.cols;
+    h = image.rows;
+    c = image.channels();
+
+    return true;
+  } else {
+    return false;
+  }
+#endif
+}
+
+/*!
+ * @brief　カメラのクローズ
+ */
+void CameraSource::Close (void)
+{
+#ifdef USEPGR
+  if (PGRCapture.IsConnected ()){
+    FlyCapture2::Error error;
+    error = PGRCapture.StopCapture ();
+    if (error != FlyCapture2::PGRERROR_OK){
+      fprintf(stderr, "error at %d in %s\n", __LINE__, __FUNCTION__);
+    }
+    error = PGRCapture.Disconnect();
+    if (error != FlyCapture2::PGRERROR_OK){
+      fprintf(stderr, "error at %d in %s\n", __LINE__, __FUNCTION__);
+    }
+  }
+#endif
+  if (capture.isOpened ()) capture.release ();
+}
+
+/*!
+ * @brief　カメラがオープンされているかどうか
+ */
+bool CameraSource::IsOpened (void) const
+{
+#ifdef USEPGR
+  return const_cast<FlyCapture2::Camera&>(PGRCapture).IsConnected ();
+#else
+  return capture.isOpened ();
+#endif
+}
+
+/*!
+ * @brief  画像の取得
+ *
+ * @param[out] image  取得した画像
+ *
+ * @retval	True or False
+ */
+bool CameraSource::Grab (cv::Mat &image)
+{
+#ifdef USEPGR
+  if (PGRCapture.IsConnected ()) {
+    FlyCapture2::Error error;
+    FlyCapture2::Image raw;
+    error = PGRCapture.RetrieveBuffer (&raw);
+    if (error != FlyCapture2::PGRERROR_OK) {
+      fprintf (stderr, "error at %d in %s\n", __LINE__, __FUNCTION__);
+    }
+    FlyCapture2::Image PGRimg;
+    error = raw.Convert (FlyCapture2::PIXEL_FORMAT_BGR, &PGRimg);
+    if (error != FlyCapture2::PGRERROR_OK) {
+      fprintf (stderr, "error at %d in %s\n", __LINE__, __FUNCTION__);
+    }
+    cv::Mat cvImg(cv::Size(PGRimg.GetCols (), PGRimg.GetRows ()), CV_8UC3,
+		  PGRimg.GetData (), PGRimg.GetStride ());
+    cv::resize (cvImg, image, size);
+    return true;
+  } else {
+    return false;
+  }
+#else
+  if (capture.isOpened ()) {
+    capture >> image;
+    if (image.data == NULL) return false;
+  } else {
+    return false;
+  }
+  return true;
+#endif
+}
+
+/* ************************************************************************* *
+ * ビデオファイル
+ * ************************************************************************* */
+
+/*!
+ * @brief  コンストラクタ
+ *
+ * @param[in] name  入力ビデオファイル名
+ */
+VideoFileSource::VideoFileSource (const std::string &name)
+{
+  fileName = name;
+  loop     = true;
+}
+
+/*!
+ * @brief  入力ビデオのオープン
+ *
+ * @param[out]	w	ビデオ画像の横サイズ
+ * @param[out]	h	ビデオ画像の縦サイズ
+ * @param[out]	c	ビデオ画像のチャネル数
+ *
+ * @retval	True or False
+ */
+bool VideoFileSource::Open (int &w, int &h, int &c)
+{
+  if (!capture.open (fileName)) {
+    fprintf (stderr, "Cannot open %s\n", fileName.c_str ());
+    return false;
+  }
+  w = (int) capture.get (cv::CAP_PROP_FRAME_WIDTH);
+  h = (int) capture.get (cv::CAP_PROP_FRAME_HEIGHT);
+  c = 3;
+  return true;
+}
+
+void VideoFileSource::Close (void)
+{
+  if (capture.isOpened ()) capture.release ();
+}
+
+bool VideoFileSource::IsOpened (void) const
+{
+  return capture.isOpened ();
+}
+
+/*!
+ * @brief  画像の取得（最後まで読んだら先頭に戻る）
+ */
+bool VideoFileSource::Grab (cv::Mat &image)
+{
+  if (!capture.isOpened ()) return false;
+  capture >> image;
+  if (image.empty () && loop) {
+    capture.set (cv::CAP_PROP_POS_FRAMES, 0);
+    capture >> image;
+  }
+  return !image.empty ();
+}
+
+/*!
+ * @brief  最後に取得した画像のビデオ内の時刻
+ */
+int64_t VideoFileSource::Timestamp (void) const
+{
+  if (!capture.isOpened ()) return -1;
+  return (int64_t) (capture.get (cv::CAP_PROP_POS_MSEC) * 1000.0);
+}
+
+/* ************************************************************************* *
+ * 連番画像
+ * ************************************************************************* */
+
+/*!
+ * @brief  コンストラクタ
+ *
+ * @param[in] _pattern  ディレクトリ名または cv::glob のパターン
+ */
+ImageSequenceSource::ImageSequenceSource (const std::string &_pattern)
+{
+  pattern  = _pattern;
+  loop     = true;
+  head     = 0;
+  count    = 0;
+  next     = 0;
+  running  = false;
+  finished = false;
+}
+
+/*!
+ * @brief  デストラクタ
+ */
+ImageSequenceSource::~ImageSequenceSource ()
+{
+  Close ();
+}
+
+/*!
+ * @brief  連番画像のオープン（先読みスレッドを起動する）
+ *
+ * @param[out]	w	画像の横サイズ
+ * @param[out]	h	画像の縦サイズ
+ * @param[out]	c	画像のチャネル数
+ *
+ * @retval	True or False
+ */
+bool ImageSequenceSource::Open (int &w, int &h, int &c)
+{
+  Close ();
+
+  // ディレクトリが指定された場合は中のファイルをすべて使う
+  files.clear ();
+  cv::glob (pattern, files, false);
+  if (files.empty ()) {
+    cv::glob (pattern + "/*", files, false);
+  }
+  std::sort (files.begin (), files.end ());
+  if (files.empty ()) {
+    fprintf (stderr, "No image is found in %s\n", pattern.c_str ());
+    return false;
+  }
+
+  // 1枚目で画像サイズを決める
+  cv::Mat first = cv::imread (files[0], cv::IMREAD_COLOR);
+  if (first.empty ()) {
+    fprintf (stderr, "Cannot read %s\n", files[0].c_str ());
+    return false;
+  }
+  w = first.cols;
+  h = first.rows;
+  c = first.channels ();
+
+  head     = 0;
+  count    = 1;
+  slots[0] = first;
+  next     = (files.size () > 1) ? 1 : 0;
+  finished = (files.size () == 1 && !loop);
+  running  = true;
+  worker   = std::thread (&ImageSequenceSource::Prefetch, this);
+
+  return true;
+}
+
+/*!
+ * @brief  先読みスレッドの停止
+ */
+void ImageSequenceSource::Close (void)
+{
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    running = false;
+  }
+  cond.notify_all ();
+  if (worker.joinable ()) worker.join ();
+  for (int n = 0; n < PREFETCH_DEPTH; n++) slots[n].release ();
+  count = 0;
+}
+
+bool ImageSequenceSource::IsOpened (void) const
+{
+  return running;
+}
+
+/*!
+ * @brief  先読みスレッド：リングバッファに空きがあれば次の画像をデコードする
+ *
+ * 1周分のファイルを続けて読めなかった時は，ループ指定でも終わりとして
+ * 待っている Grab を起こす．
+ */
+void ImageSequenceSource::Prefetch (void)
+{
+  size_t failures = 0; // 続けて読めなかったファイルの数
+  for (;;) {
+    size_t target;
+    {
+      std::unique_lock<std::mutex> lock (mutex);
+      cond.wait (lock, [this] {
+	  return !running || (!finished && count < (size_t) PREFETCH_DEPTH);
+	});
+      if (!running) return;
+      target = next;
+    }
+
+    // デコードはロックの外で行う
+    cv::Mat frame = cv::imread (files[target], cv::IMREAD_COLOR);
+    if (frame.empty ()) {
+      fprintf (stderr, "Cannot read %s\n", files[target].c_str ());
+      failures++;
+    } else {
+      failures = 0;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock (mutex);
+      if (!frame.empty ()) {
+	slots[(head + count) % PREFETCH_DEPTH] = frame;
+	count++;
+      }
+      next = target + 1;
+      if (next >= files.size ()) {
+	if (loop) next = 0;
+	else      finished = true;
+      }
+      if (failures >= files.size ()) {
+	fprintf (stderr, "No readable image in %s\n", pattern.c_str ());
+	finished = true;
+      }
+    }
+    cond.notify_all ();
+  }
+}
+
+/*!
+ * @brief  画像の取得（先読み済みの画像を受け取る）
+ */
+bool ImageSequenceSource::Grab (cv::Mat &image)
+{
+  std::unique_lock<std::mutex> lock (mutex);
+  cond.wait (lock, [this] { return !running || count > 0 || finished; });
+  if (count == 0) return false;
+
+  // スロットの画像をそのまま渡し，スロットは次のデコード先として空ける
+  image = slots[head];
+  slots[head] = cv::Mat ();
+  head = (head + 1) % PREFETCH_DEPTH;
+  count--;
+  lock.unlock ();
+  cond.notify_all ();
+
+  return true;
+}
+
+/* ************************************************************************* *
+ * 無圧縮フレームファイル
+ * ************************************************************************* */
+
+/*!
+ * @brief  コンストラクタ
+ *
+ * @param[in] name  入力ファイル名
+ */
+RawFileSource::RawFileSource (const std::string &name)
+{
+  fileName = name;
+  loop     = true;
+  index    = 0;
+}
+
+/*!
+ * @brief  ファイルのオープン
+ *
+ * @param[out]	w	画像の横サイズ
+ * @param[out]	h	画像の縦サイズ
+ * @param[out]	c	画像のチャネル数
+ *
+ * @retval	True or False
+ */
+bool RawFileSource::Open (int &w, int &h, int &c)
+{
+  if (!reader.Open (fileName)) return false;
+  w = (int) reader.header.width;
+  h = (int) reader.header.height;
+  c = CV_MAT_CN ((int) reader.header.type);
+  index = 0;
+  return true;
+}
+
+void RawFileSource::Close (void)
+{
+  reader.Close ();
+}
+
+bool RawFileSource::IsOpened (void) const
+{
+  return reader.IsOpened ();
+}
+
+/*!
+ * @brief  画像の取得
+ *
+ * @param[out] image  マップした領域を指す画像（コピーしない．読み取り専用）
+ */
+bool RawFileSource::Grab (cv::Mat &image)
+{
+  if (index >= reader.frameCount) {
+    if (!loop) return false;
+    index = 0;
+  }
+  image = reader.Frame (index++);
+  return !image.empty ();
+}
+
+/*!
+ * @brief  最後に取得した画像の記録時の時刻
+ */
+int64_t RawFileSource::Timestamp (void) const
+{
+  if (index == 0) return -1;
+  return reader.Timestamp (index - 1);
+}
+
+/* ************************************************************************* *
+ * 合成画像
+ * ************************************************************************* */
+
+/*!
+ * @brief  コンストラクタ
+ */
+SyntheticMarkerSource::SyntheticMarkerSource ()
+{
+  width      = 640;
+  height     = 480;
+  markerSize = 120.0;
+  frameIndex = 0;
+  opened     = false;
+}
+
+/*!
+ * @brief  オープン（w, h で指定したサイズの画像を生成する）
+ */
+bool SyntheticMarkerSource::Open (int &w, int &h, int &c)
+{
+  if (w > 0) width  = w;
+  if (h > 0) height = h;
+  w = width;
+  h = height;
+  c = 3;
+  frameIndex = 0;
+  opened = true;
+  return true;
+}
+
+void SyntheticMarkerSource::Close (void)
+{
+  opened = false;
+}
+
+bool SyntheticMarkerSource::IsOpened (void) const
+{
+  return opened;
+}
+
+/*!
+ * @brief  画像の生成
+ *
+ * フレーム番号だけで決まる軌道上に，正方形マーカー（黒枠）と
+ * 円形マーカー（大小の円）を描画する．同じフレーム番号からは常に同じ画像が得られる．
+ */
+bool SyntheticMarkerSource::Grab (cv::Mat &image)
+{
+  if (!opened) return false;
+
+  const double t = (double) frameIndex++;
+  const int    shift = 4; // 頂点座標の小数部のビット数
+  const double scale = 1 << shift;
+
+  image.create (height, width, CV_8UC3);
+  image.setTo (cv::Scalar (200, 200, 200));
+
+  // 正方形マーカー：外側の黒い正方形と内側の白い正方形
+  double cx    = width  * (0.35 + 0.15 * sin (0.021 * t));
+  double cy    = height * (0.50 + 0.25 * sin (0.033 * t));
+  double theta = 0.013 * t;
+  const double ratio[2] = {1.0, 0.5};
+  const cv::Scalar color[2] = {cv::Scalar (0, 0, 0), cv::Scalar (255, 255, 255)};
+  for (int k = 0; k < 2; k++) {
+    double half = 0.5 * markerSize * ratio[k];
+    cv::Point corner[4];
+    for (int n = 0; n < 4; n++) {
+      double a = theta + (n + 0.5) * CV_PI / 2.0;
+      double r = half * sqrt (2.0);
+      corner[n].x = cvRound ((cx + r * cos (a)) * scale);
+      corner[n].y = cvRound ((cy + r * sin (a)) * scale);
+    }
+    cv::fillConvexPoly (image, corner, 4, color[k], cv::LINE_AA, shift);
+  }
+
+  // 円形マーカー：大きな円の内側に，中心をずらした小さな円
+  double ox = width  * (0.72 + 0.10 * cos (0.017 * t));
+  double oy = height * (0.50 + 0.20 * cos (0.027 * t));
+  double radius = 0.45 * markerSize;
+  cv::circle (image,
+	      cv::Point (cvRound (ox * scale), cvRound (oy * scale)),
+	      cvRound (radius * scale), cv::Scalar (0, 0, 0), 3, cv::LINE_AA, shift);
+  cv::circle (image,
+	      cv::Point (cvRound ((ox + 0.4 * radius) * scale), cvRound (oy * scale)),
+	      cvRound (0.4 * radius * scale), cv::Scalar (0, 0, 0), 3, cv::LINE_AA, shift);
+
+  return true;
+}
+
+/*!
+ * @brief  最後に生成した画像の時刻（30fps とみなしたフレーム番号の時刻）
+ */
+int64_t SyntheticMarkerSource::Timestamp (void) const
+{
+  if (frameIndex == 0) return -1;
+  return (int64_t) (frameIndex - 1) * 1000000 / 30;
+}
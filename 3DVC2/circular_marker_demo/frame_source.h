@@ -0,0 +1,160 @@
+/*!
+ * @file	frame_source.h
+ * @brief	画像の入力元クラス
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <opencv2/opencv.hpp>
+#include "raw_frame_file.h"
+
+#ifdef USEPGR
+#include <FlyCapture2.h>
+#endif
+
+/*!
+ * @class  画像の入力元の基底クラス
+ * @brief　CCamera はこのクラスを通して画像を取得する
+ */
+class FrameSource
+{
+ public:
+  virtual ~FrameSource () {}
+
+  // 入力元のオープン（w, h は要求サイズ．実際のサイズを返す）
+  virtual bool Open (int &w, int &h, int &c) = 0;
+  // 入力元のクローズ
+  virtual void Close (void) = 0;
+  // 入力元がオープンされているかどうか
+  virtual bool IsOpened (void) const = 0;
+  // 画像の取得（入力元の領域を指すことがあるので，受け取った画像は書き換えない）
+  virtual bool Grab (cv::Mat &image) = 0;
+  // 最後に取得した画像の時刻 [マイクロ秒]（入力元が時刻を持たない時は負）
+  virtual int64_t Timestamp (void) const { return -1; }
+};
+
+/*!
+ * @class  カメラからの入力
+ */
+class CameraSource : public FrameSource
+{
+ public:
+  CameraSource (int _deviceID);
+  ~CameraSource ();
+
+  bool Open (int &w, int &h, int &c);
+  void Close (void);
+  bool IsOpened (void) const;
+  bool Grab (cv::Mat &image);
+
+  int deviceID;               // デバイスID（-1 のときは自動で探す）
+#ifdef USEPGR
+  // ポイントグレイ製カメラを使用する場合
+  FlyCapture2::Camera PGRCapture;
+  cv::Size size;
+#endif
+  cv::VideoCapture capture;
+};
+
+/*!
+ * @class  ビデオファイルからの入力
+ */
+class VideoFileSource : public FrameSource
+{
+ public:
+  VideoFileSource (const std::string &name);
+
+  bool Open (int &w, int &h, int &c);
+  void Close (void);
+  bool IsOpened (void) const;
+  bool Grab (cv::Mat &image);
+  int64_t Timestamp (void) const;
+
+  std::string fileName;       // 入力ビデオファイル名
+  bool loop;                  // 最後まで読んだら先頭に戻るかどうか
+  cv::VideoCapture capture;
+};
+
+/*!
+ * @class  連番画像からの入力
+ * @brief　別スレッドで先読みしてデコード待ちをなくす
+ */
+class ImageSequenceSource : public FrameSource
+{
+ public:
+  ImageSequenceSource (const std::string &pattern);
+  ~ImageSequenceSource ();
+
+  bool Open (int &w, int &h, int &c);
+  void Close (void);
+  bool IsOpened (void) const;
+  bool Grab (cv::Mat &image);
+
+  static const int PREFETCH_DEPTH = 8; // 先読みする枚数
+
+  std::string pattern;        // ディレクトリ名または cv::glob のパターン
+  bool loop;                  // 最後まで読んだら先頭に戻るかどうか
+  std::vector<std::string> files;
+
+ private:
+  void Prefetch (void);
+
+  std::thread             worker;
+  std::mutex              mutex;
+  std::condition_variable cond;
+  cv::Mat  slots[PREFETCH_DEPTH]; // 先読みしたフレームのリングバッファ
+  size_t   head;              // 次に Grab するスロット
+  size_t   count;             // 先読み済みの枚数
+  size_t   next;              // 次に読み込むファイル番号
+  std::atomic<bool> running;  // 先読みスレッドが動いているか（書き換えは mutex の中）
+  bool     finished;          // 全ファイルを読み終えたかどうか
+};
+
+/*!
+ * @class  無圧縮フレームファイル(.raw)からの入力
+ * @brief　mmap した領域を直接参照するのでデコードもコピーも行わない
+ *         （領域は読み取り専用）
+ */
+class RawFileSource : public FrameSource
+{
+ public:
+  RawFileSource (const std::string &name);
+
+  bool Open (int &w, int &h, int &c);
+  void Close (void);
+  bool IsOpened (void) const;
+  bool Grab (cv::Mat &image);
+  int64_t Timestamp (void) const;
+
+  std::string fileName;       // 入力ファイル名
+  bool loop;                  // 最後まで読んだら先頭に戻るかどうか
+  RawFrameReader reader;
+  size_t index;               // 次に読むフレーム番号
+};
+
+/*!
+ * @class  マーカーを描画した合成画像の入力
+ * @brief　カメラなしで同じ入力を何度でも再現するためのもの
+ */
+class SyntheticMarkerSource : public FrameSource
+{
+ public:
+  SyntheticMarkerSource ();
+
+  bool Open (int &w, int &h, int &c);
+  void Close (void);
+  bool IsOpened (void) const;
+  bool Grab (cv::Mat &image);
+  int64_t Timestamp (void) const;
+
+  int    width;               // 画像の幅
+  int    height;              // 画像の高さ
+  double markerSize;          // 正方形マーカーの一辺 [画素]
+  long   frameIndex;          // 次に生成するフレーム番号
+  bool   opened;
+};
@@ -47,6 +47,7 @@ GLFWWindow::GLFWWindow(int width, int height, char* title) {
  * デストラクタ
  */
 GLFWWindow::~GLFWWindow() {
+  background.Release();
   glfwTerminate();
 }
 
@@ -66,33 +67,17 @@ void GLFWWindow::MakeContext (int width, int height, const char* title) {
 /*
  * 画像を描画する関数
  *
- * @param [in] pixels : 画像データ
- * @param [in] width  : ウィンドウの横サイズ
- * @param [in] height : ウィンドウの縦サイズ
+ * 画像はテクスチャに転送して画面全体に貼る（BackgroundRenderer）．
+ * 射影行列とモデルビュー行列は単位行列になる．
+ *
+ * @param [in] pixels        : 画像データ（BGR）
+ * @param [in] image_width   : 画像の横サイズ
+ * @param [in] image_height  : 画像の縦サイズ
+ * @param [in] window_width  : ウィンドウの横サイズ
+ * @param [in] window_height : ウィンドウの縦サイズ
  */
 void GLFWWindow::drawImage (GLubyte* pixels, int image_width, int image_height, int window_width, int window_height) {
-  glDisable (GL_DEPTH_TEST);
-
-  glMatrixMode (GL_MODELVIEW);
-  glPushMatrix ();
-  glLoadIdentity ();
-
-  glMatrixMode (GL_PROJECTION);
-  glPushMatrix ();
-  glLoadIdentity ();
-
-  glViewport(0, 0, window_width, window_height);
-  glOrtho (0.0, (GLdouble) image_width, 0.0, (GLdouble) image_height, -1.0, 1.0);
-  glPixelZoom ((double) window_width / image_width, (double) -window_height / image_height);
-  glRasterPos2i (0, image_height - 1);
-  glDrawPixels (image_width, image_height, GL_BGR_EXT, GL_UNSIGNED_BYTE, pixels);
-
-  glMatrixMode (GL_PROJECTION);
-  glPopMatrix ();
-  glMatrixMode (GL_MODELVIEW);
-  glPopMatrix ();
-
-  glEnable (GL_DEPTH_TEST);
+  background.Draw (pixels, image_width, image_height, window_width, window_height);
 }
 
 /*
@@ -6,6 +6,7 @@
 #include <opencv2/opencv.hpp>
 #include <GLFW/glfw3.h>
 //#include <glut.h>
+#include "background_renderer.h"
 
 class GLFWWindow
 {
@@ -27,6 +28,7 @@ class GLFWWindow
 				    int		mods));
 
   GLFWwindow* window;
+  BackgroundRenderer background; // 背景画像の描画
 };
 
 /* ************************************************ End of glfw_window.h *** */
@@ -1,101 +1,156 @@
-#include <opencv2/opencv.hpp>
-#include <math.h>
-#include <string.h>
-#include "application.h"
-
-static void display (Application& app) {
-  // 画面のクリア
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-  /* ****************************************************************** *
-   * アプリケーションに応じた処理を書く(ここから)
-   * ****************************************************************** */
-  /* マーカー検出 */
-  bool detected = app.MarkerDetect();
-  
-  // 画像の描画
-  int window_width, window_height;
-  glfwGetWindowSize(app.window.window, &window_width, &window_height);
-  app.window.drawImage ((GLubyte *) app.camera.image.data, app.camera.width, app.camera.height, window_width, window_height);
-
-  /* ****************************************************************** *
-   * アプリケーションに応じた処理を書く(ここまで)
-   * ****************************************************************** */
-
-  // 3Dモデルの描画
-  if (detected) {
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glFrustum(-app.proj_param.horiz, app.proj_param.horiz,
-	      -app.proj_param.vert, app.proj_param.vert,
-	      app.proj_param.nearDist, app.proj_param.farDist);
-
-    for (int n = 0; n < (int) app.marker_list.size(); n++) {
-      glMatrixMode(GL_MODELVIEW);
-      glLoadIdentity();
-
-      /* ************************************************************* *
-       * 3次元モデルの描画部分
-       * ************************************************************* */
-      /* 検出したマーカーからカメラパラメータを計算 */
-      app.marker_list[n].ComputeCameraParam();
-      /* モデルビュー行列を登録 */
-      glLoadMatrixf(app.marker_list[n].M);
-      /* モデルの描画 */
-      app.model.DrawModel();
-      /* ************************************************************* *
-       * 3次元モデルの描画部分
-       * ************************************************************* */
-    }
-  }
-  glfwSwapBuffers (app.window.window);
-}
-
-static void CustomKeyFunc (GLFWwindow*	window,
-			   int		key,
-			   int		scancode,
-			   int		action,
-			   int		mods) {
-  static int count = 0;
-
-  if (key == GLFW_KEY_Q) {
-    glfwTerminate();
-    exit(1);
-  } else if (key == GLFW_KEY_S) {
-    glReadBuffer (GL_BACK);
-    cv::Mat image(cv::Size(640, 480), CV_8UC4);
-    glReadPixels (0, 0,
-		  640, 480,
-		  GL_BGRA_EXT,
-		  GL_UNSIGNED_BYTE,
-		  image.data);
-    char name[1024];
-    sprintf (name, "output-%03d.png", count++);
-    cv::flip (image ,image, 0);
-    cv::imwrite (name, image);
-  }
-}
-
-int main (int argc, char **argv)
-{
-  /* アプリケーションクラスの作成 */
-  Application app("Circular Marker Demo");
-  
-  /* カメラの設定 */
-  app.ReadSettings ("./settings.txt");
-  if (!app.OpenCamera ()) exit (1);
-
-  /* 3Dモデルの読み込み */
-  //app.model.OpenModel("./mqo/Gengar/GengarMega.mqo");
-  //char filename[] = "./mqo/Groudon/GroudonPrimal.mqo";
-  app.model.OpenModel(app.model_filename);  
-
-  app.window.SetKeyFunc (CustomKeyFunc);
-  
-  /* メインループ */
-  while (!glfwWindowShouldClose (app.window.window)) {
-    display (app);
-    glfwWaitEventsTimeout(1e-03);
-  }
-  return 0;
-}
+#include <opencv2/opencv.hpp>
+#include <math.h>
+#include <string.h>
+#include <fstream>
+#include "application.h"
+#include "screen_capture.h"
+
+static Application* s_app = NULL;  // キーボード関数から参照するアプリケーション
+static bool s_recording = false;   // 入力画像を記録中かどうか
+static ScreenCapture s_capture;     // 画面の保存
+
+static void display (Application& app) {
+  // 画面のクリア
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  /* ****************************************************************** *
+   * アプリケーションに応じた処理を書く(ここから)
+   * ****************************************************************** */
+  /* マーカー検出 */
+  /* （記録中の入力画像は CaptureImage が検出の前に保存する） */
+  bool detected = app.MarkerDetect();
+  
+  // 画像の描画
+  int window_width, window_height;
+  glfwGetWindowSize(app.window.window, &window_width, &window_height);
+  app.window.drawImage ((GLubyte *) app.camera.image.data, app.camera.width, app.camera.height, window_width, window_height);
+
+  /* ****************************************************************** *
+   * アプリケーションに応じた処理を書く(ここまで)
+   * ****************************************************************** */
+
+  // 3Dモデルの描画
+  if (detected) {
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glFrustum(-app.proj_param.horiz, app.proj_param.horiz,
+	      -app.proj_param.vert, app.proj_param.vert,
+	      app.proj_param.nearDist, app.proj_param.farDist);
+    /* 同じ視錐台の外にあるマーカーやオブジェクトは描画しない */
+    mqoSetFrustum(-app.proj_param.horiz, app.proj_param.horiz,
+		  -app.proj_param.vert, app.proj_param.vert,
+		  app.proj_param.nearDist, app.proj_param.farDist);
+
+    /* ************************************************************* *
+     * 3次元モデルの描画部分
+     * ************************************************************* */
+    /* マーカーごとのモデルビュー行列を集めて，まとめて描画する */
+    std::vector<float>& matrices = app.model_matrices;
+    matrices.clear();
+    for (int n = 0; n < (int) app.marker_list.size(); n++) {
+      /* 検出したマーカーからカメラパラメータを計算 */
+      app.marker_list[n].ComputeCameraParam();
+      matrices.insert(matrices.end(), app.marker_list[n].M, app.marker_list[n].M + 16);
+    }
+    for (int n = 0; n < (int) app.rect_marker_list.size(); n++) {
+      /* 正方形マーカーの位置姿勢は検出時に計算済み */
+      matrices.insert(matrices.end(), app.rect_marker_list[n].M, app.rect_marker_list[n].M + 16);
+    }
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    app.model.DrawInstances(matrices.data(), (int) matrices.size() / 16);
+    /* ************************************************************* *
+     * 3次元モデルの描画部分
+     * ************************************************************* */
+  }
+  s_capture.Update (app.window.window);
+  glfwSwapBuffers (app.window.window);
+}
+
+static void CustomKeyFunc (GLFWwindow*	window,
+			   int		key,
+			   int		scancode,
+			   int		action,
+			   int		mods) {
+  if (key == GLFW_KEY_Q) {
+    // exit ではデストラクタが呼ばれないので，記録中のファイルをここで閉じる
+    s_app->camera.Close ();
+    s_capture.Release ();
+    glfwTerminate();
+    exit(1);
+  } else if (key == GLFW_KEY_R && action == GLFW_PRESS) {
+    // 入力画像を無圧縮のまま記録する（もう一度押すと終了）
+    static int record_count = 0;
+    if (!s_recording) {
+      char name[1024];
+      sprintf (name, "record-%03d.raw", record_count++);
+      s_recording = s_app->camera.SaveVideoSetting (name);
+    } else {
+      s_app->camera.CloseVideo ();
+      s_recording = false;
+    }
+  } else if (key == GLFW_KEY_S && action == GLFW_PRESS) {
+    // 画面の保存（読み出しと保存は次のフレーム以降に行われる）
+    s_capture.Request ();
+  } else if (key == GLFW_KEY_F && action == GLFW_PRESS) {
+    // 矩形検出の高速モードと全探索モードの切り替え
+    RectangleDetection& detector = s_app->rectangle_detector;
+    detector.mode = (detector.mode == RectangleDetection::MODE_FAST) ?
+      RectangleDetection::MODE_EXHAUSTIVE : RectangleDetection::MODE_FAST;
+    s_app->rectangle_tracker.Reset ();
+  } else if (key == GLFW_KEY_T && action == GLFW_PRESS) {
+    // 四角形の追跡の有効・無効の切り替え
+    s_app->useTracking = !s_app->useTracking;
+    s_app->rectangle_tracker.Reset ();
+  } else if (key == GLFW_KEY_B && action == GLFW_PRESS) {
+    // マーカー検出の方式の切り替え（円形→正方形→両方）
+    static const char* names[Application::NUM_BACKENDS] = {
+      "circular", "rectangle", "combined"
+    };
+    int backend = (s_app->backend + 1) % Application::NUM_BACKENDS;
+    s_app->SetBackend (backend);
+    printf ("Marker backend: %s\n", names[backend]);
+  } else if (key == GLFW_KEY_C && action == GLFW_PRESS) {
+    // 毎フレームの画面の保存（もう一度押すと終了）
+    s_capture.SetContinuous (!s_capture.continuous);
+  }
+}
+
+int main (int argc, char **argv)
+{
+  /* アプリケーションクラスの作成 */
+  Application app("Circular Marker Demo");
+  s_app = &app;
+  
+  /* カメラの設定 */
+  app.ReadSettings ("./settings.txt");
+  if (!app.OpenCamera ()) exit (1);
+
+  /* カメラパラメータ（ファイルがあれば歪みを補正する．2回目からはキャッシュを使う） */
+  std::ifstream camera_param("./camera.xml");
+  if (camera_param.good()) {
+    app.LoadCameraParameters("./camera.xml");
+  }
+
+  /* 3Dモデルの読み込み */
+  //app.model.OpenModel("./mqo/Gengar/GengarMega.mqo");
+  //char filename[] = "./mqo/Groudon/GroudonPrimal.mqo";
+  app.model.OpenModel(app.model_filename);  
+
+  /* 正方形マーカーのID辞書（ファイルがなければIDを判定しない） */
+  std::ifstream dictionary("./marker_dictionary.txt");
+  if (dictionary.good()) {
+    app.rect_marker_detector.decoder.LoadDictionary("./marker_dictionary.txt");
+  }
+
+  app.window.SetKeyFunc (CustomKeyFunc);
+  s_capture.Init ();
+  
+  /* メインループ */
+  while (!glfwWindowShouldClose (app.window.window)) {
+    display (app);
+    glfwWaitEventsTimeout(1e-03);
+  }
+  s_capture.Release ();
+  return 0;
+}
@@ -0,0 +1,110 @@
+/* **************************************************** marker_backend.h *** *
+ * マーカー検出の方式(ヘッダファイル)
+ *
+ * 方式ごとのクラスは MarkerBackend<方式> を継承して DetectMarkers と
+ * DrawMarkers を持つ．DetectMarkers は画像に描画せず，検出結果の描画は
+ * DrawMarkers で行う（複数の方式を組み合わせた時に，先の方式の描画が
+ * 後の方式の入力に混ざらないようにするため）．
+ * Application は方式ごとに検出処理をテンプレートとして実体化しておき，
+ * 実行時には関数ポインタで1つを選ぶだけなので，フレームごとの処理に
+ * 仮想関数の呼び出しや使わない方式の処理は入らない．
+ * ************************************************************************* */
+#pragma once
+
+#include "application.h"
+
+/*
+ * 検出方式の基底クラス（CRTP）
+ */
+template <class Derived>
+class MarkerBackend
+{
+ public:
+  // マーカー検出と描画（派生クラスの DetectMarkers と DrawMarkers を静的に呼ぶ）
+  bool Detect(Application& app) {
+    Derived* backend = static_cast<Derived*>(this);
+    bool retval = backend->DetectMarkers(app);
+    backend->DrawMarkers(app);
+    return retval;
+  }
+};
+
+/*
+ * 円形マーカー（楕円検出）
+ */
+class CircularMarkerBackend : public MarkerBackend<CircularMarkerBackend>
+{
+ public:
+  bool DetectMarkers(Application& app) {
+    bool retval = app.ellipse_detector.Detect(app.camera.image, app.ellipse_list);
+    if (retval) {
+      retval = app.marker_detector.Detect(app.ellipse_list, app.camera.image,
+					  app.marker_list);
+    } else {
+      app.ellipse_list.clear();
+      app.marker_list.clear();
+    }
+    return retval;
+  }
+
+  void DrawMarkers(Application& app) {
+    app.ellipse_detector.Draw(app.camera.image, app.ellipse_list);
+    app.marker_detector.Draw(app.camera.image, app.marker_list);
+  }
+};
+
+/*
+ * 正方形マーカー（矩形検出，または前のフレームからの追跡）
+ */
+class RectangleMarkerBackend : public MarkerBackend<RectangleMarkerBackend>
+{
+ public:
+  bool DetectMarkers(Application& app) {
+    bool retval;
+    if (app.useTracking) {
+      // 前のフレームの四角形を追跡する（見失ったら検出しなおす）
+      retval = app.rectangle_tracker.Track(app.camera.image, app.rectangle_detector,
+					   app.tracked_list);
+      if (retval) {
+	retval = app.rect_marker_detector.Detect(app.tracked_list, app.camera.image,
+						 app.rect_marker_list);
+      }
+    } else {
+      retval = app.rectangle_detector.Detect(app.camera.image, app.rectangle_list);
+      if (retval) {
+	retval = app.rect_marker_detector.Detect(app.rectangle_list, app.camera.image,
+						 app.rect_marker_list);
+      }
+    }
+    if (!retval) app.rect_marker_list.clear();
+    return retval;
+  }
+
+  void DrawMarkers(Application& app) {
+    app.rect_marker_detector.Draw(app.camera.image, app.rect_marker_list);
+  }
+};
+
+/*
+ * 2つの方式の組み合わせ（両方を同じ画像で検出してから描画する）
+ */
+template <class First, class Second>
+class CombinedMarkerBackend : public MarkerBackend<CombinedMarkerBackend<First, Second> >
+{
+ public:
+  bool DetectMarkers(Application& app) {
+    bool first  = firstBackend.DetectMarkers(app);
+    bool second = secondBackend.DetectMarkers(app);
+    return first || second;
+  }
+
+  void DrawMarkers(Application& app) {
+    firstBackend.DrawMarkers(app);
+    secondBackend.DrawMarkers(app);
+  }
+
+  First  firstBackend;
+  Second secondBackend;
+};
+
+/* ********************************************* End of marker_backend.h *** */
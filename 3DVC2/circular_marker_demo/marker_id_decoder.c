@@ -0,0 +1,306 @@
+/* ************************************************* marker_id_decoder.c *** *
+ * 正方形マーカーのID判定クラス
+ * ************************************************************************* */
+#include "marker_id_decoder.h"
+#include "rectangle_marker.h"
+#include <fstream>
+#include <sstream>
+
+/*
+ * コンストラクタ
+ */
+MarkerIdDecoder::MarkerIdDecoder() {
+  gridSize    = DEFAULT_GRID_SIZE;
+  borderBits  = DEFAULT_BORDER_BITS;
+  subSamples  = DEFAULT_SUB_SAMPLES;
+  minContrast = DEFAULT_MIN_CONTRAST;
+  patternCells      = 0;
+  patternSubSamples = 0;
+}
+
+/*
+ * デストラクタ
+ */
+MarkerIdDecoder::~MarkerIdDecoder() {
+  ;
+}
+
+/*
+ * ビット列を反時計回りに 90 度回転する関数
+ *
+ * 頂点の始点を1つずらして読んだビット列になる．
+ *
+ * @param [in] bits : ビット列（行優先, 先頭が最下位ビット）
+ *
+ * @return 回転したビット列
+ */
+uint64_t MarkerIdDecoder::Rotate(uint64_t bits) const {
+  int N = gridSize;
+  uint64_t rotated = 0;
+  for (int r = 0; r < N; r++) {
+    for (int c = 0; c < N; c++) {
+      // new[r][c] = old[c][N-1-r]
+      uint64_t bit = (bits >> (c * N + (N - 1 - r))) & 1;
+      rotated |= bit << (r * N + c);
+    }
+  }
+  return rotated;
+}
+
+/*
+ * 辞書の登録
+ *
+ * @param [in] id   : マーカーのID
+ * @param [in] bits : 正しい向きで読んだビット列
+ *
+ * @return 登録できればtrue（回転すると既存の符号と重なる場合はfalse）
+ */
+bool MarkerIdDecoder::AddCode(int id, uint64_t bits) {
+  if (gridSize < 1 || gridSize > 8 || id < 0) return false;
+  uint64_t code[4];
+  code[0] = bits;
+  for (int k = 1; k < 4; k++) code[k] = Rotate(code[k - 1]);
+  for (int k = 0; k < 4; k++) {
+    if (dictionary.count(code[k]) != 0) {
+      fprintf(stderr, "Marker code %d collides with marker %d\n",
+	      id, dictionary[code[k]] / 4);
+      return false;
+    }
+  }
+  // 回転対称な符号は向きが決まらないので登録しない
+  for (int k = 1; k < 4; k++) {
+    if (code[k] == code[0]) {
+      fprintf(stderr, "Marker code %d is rotationally symmetric\n", id);
+      return false;
+    }
+  }
+  for (int k = 0; k < 4; k++) dictionary[code[k]] = id * 4 + k;
+  return true;
+}
+
+/*
+ * 辞書の読み込み
+ *
+ * @param [in] name : 辞書ファイル名
+ *
+ * @return 読み込めればtrue
+ */
+bool MarkerIdDecoder::LoadDictionary(const std::string& name) {
+  std::ifstream ifs(name);
+  if (ifs.fail()) {
+    fprintf(stderr, "Cannot open marker dictionary %s\n", name.c_str());
+    return false;
+  }
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream iss(line);
+    int id;
+    std::string bitString;
+    if (!(iss >> id >> bitString)) continue;
+    if ((int) bitString.size() != gridSize * gridSize) {
+      fprintf(stderr, "Invalid marker code for %d\n", id);
+      continue;
+    }
+    uint64_t bits = 0;
+    for (int n = 0; n < (int) bitString.size(); n++) {
+      if (bitString[n] == '1') bits |= (uint64_t) 1 << n;
+    }
+    AddCode(id, bits);
+  }
+  return !dictionary.empty();
+}
+
+/*
+ * 辞書のクリア
+ */
+void MarkerIdDecoder::ClearDictionary(void) {
+  dictionary.clear();
+}
+
+/*
+ * 辞書が空かどうか
+ */
+bool MarkerIdDecoder::Empty(void) const {
+  return dictionary.empty();
+}
+
+/*
+ * 標本点の配置を計算する関数
+ *
+ * 枠を含む各セルの内側に subSamples x subSamples 点を等間隔に置く
+ * （セルの境界付近はぼけているので端の 1/6 は使わない）．
+ */
+void MarkerIdDecoder::BuildPattern(void) {
+  int cellsPerSide = gridSize + 2 * borderBits;
+  int S = std::max(subSamples, 1);
+  if (cellsPerSide == patternCells && S == patternSubSamples) return;
+
+  int count = cellsPerSide * cellsPerSide * S * S;
+  sx.resize(count);
+  sy.resize(count);
+  px.resize(count);
+  py.resize(count);
+  samples.resize(count);
+  cells.resize(cellsPerSide * cellsPerSide);
+
+  // セルごとに標本点が連続するように並べる
+  int i = 0;
+  for (int r = 0; r < cellsPerSide; r++) {
+    for (int c = 0; c < cellsPerSide; c++) {
+      for (int j = 0; j < S; j++) {
+	for (int k = 0; k < S; k++) {
+	  double fx = (S == 1) ? 0.5 : (1.0 + 4.0 * k / (S - 1)) / 6.0;
+	  double fy = (S == 1) ? 0.5 : (1.0 + 4.0 * j / (S - 1)) / 6.0;
+	  sx[i] = (float) ((c + fx) / cellsPerSide);
+	  sy[i] = (float) ((r + fy) / cellsPerSide);
+	  i++;
+	}
+      }
+    }
+  }
+  patternCells      = cellsPerSide;
+  patternSubSamples = S;
+}
+
+/*
+ * セルの平均輝度と白黒の閾値を求める関数
+ *
+ * 頂点から単位正方形→画像のホモグラフィを1回だけ計算し，全標本点を
+ * まとめて射影して双線形補間で輝度を求める．射影は分岐のない
+ * 配列演算なのでコンパイラがベクトル化できる．
+ *
+ * @param [in] gray       : 濃淡画像
+ * @param [in] x, y       : マーカーの頂点（画像上で時計回り）
+ * @param [out] threshold : 白と黒の閾値（セルの最小と最大の中間）
+ *
+ * @return 白と黒のセルの輝度差が minContrast 以上あればtrue
+ */
+bool MarkerIdDecoder::SampleCells(const cv::Mat& gray, const double x[4], const double y[4],
+				  float& threshold) {
+  if (gray.empty() || gray.type() != CV_8UC1) return false;
+  BuildPattern();
+
+  // 単位正方形から画像へのホモグラフィ
+  const double U[4] = {0, 1, 1, 0};
+  const double V[4] = {0, 0, 1, 1};
+  Eigen::Matrix3d H;
+  if (!ComputeHomography(U, V, x, y, H)) return false;
+  const float h0 = (float) H(0, 0), h1 = (float) H(0, 1), h2 = (float) H(0, 2);
+  const float h3 = (float) H(1, 0), h4 = (float) H(1, 1), h5 = (float) H(1, 2);
+  const float h6 = (float) H(2, 0), h7 = (float) H(2, 1), h8 = (float) H(2, 2);
+
+  // 標本点の射影（画像の内側に収める）
+  const int count = (int) sx.size();
+  const float xmax = (float) (gray.cols - 1.001);
+  const float ymax = (float) (gray.rows - 1.001);
+  const float* sxp = &sx[0];
+  const float* syp = &sy[0];
+  float* pxp = &px[0];
+  float* pyp = &py[0];
+  for (int i = 0; i < count; i++) {
+    float w  = 1.0f / (h6 * sxp[i] + h7 * syp[i] + h8);
+    float u_ = (h0 * sxp[i] + h1 * syp[i] + h2) * w;
+    float v_ = (h3 * sxp[i] + h4 * syp[i] + h5) * w;
+    pxp[i] = std::min(std::max(u_, 0.0f), xmax);
+    pyp[i] = std::min(std::max(v_, 0.0f), ymax);
+  }
+
+  // 双線形補間
+  const size_t step = gray.step;
+  const unsigned char* data = gray.data;
+  float* sp = &samples[0];
+  for (int i = 0; i < count; i++) {
+    int   ix = (int) pxp[i];
+    int   iy = (int) pyp[i];
+    float fx = pxp[i] - ix;
+    float fy = pyp[i] - iy;
+    const unsigned char* p = data + iy * step + ix;
+    float top    = p[0]    + fx * (p[1]        - p[0]);
+    float bottom = p[step] + fx * (p[step + 1] - p[step]);
+    sp[i] = top + fy * (bottom - top);
+  }
+
+  // セルごとの平均輝度と閾値（最小と最大の中間）
+  const int cellsPerSide = patternCells;
+  const int perCell = patternSubSamples * patternSubSamples;
+  float vmin = 255.0f, vmax = 0.0f;
+  for (int n = 0; n < cellsPerSide * cellsPerSide; n++) {
+    float sum = 0.0f;
+    for (int k = 0; k < perCell; k++) sum += sp[n * perCell + k];
+    cells[n] = sum / perCell;
+    vmin = std::min(vmin, cells[n]);
+    vmax = std::max(vmax, cells[n]);
+  }
+  if (vmax - vmin < minContrast) return false;
+  threshold = 0.5f * (vmin + vmax);
+  return true;
+}
+
+/*
+ * 枠のセルがすべて黒いかどうか（SampleCells の後に呼ぶ）
+ */
+bool MarkerIdDecoder::IsBorderDark(float threshold) const {
+  const int cellsPerSide = patternCells;
+  for (int r = 0; r < cellsPerSide; r++) {
+    for (int c = 0; c < cellsPerSide; c++) {
+      bool border = (r < borderBits || r >= cellsPerSide - borderBits ||
+		     c < borderBits || c >= cellsPerSide - borderBits);
+      if (border && cells[r * cellsPerSide + c] > threshold) return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * 黒い枠があるかどうかの判定
+ *
+ * 辞書がない場合に，マーカーの内側の白い四角形や枠のない四角形を
+ * 除くために使う（枠が黒く，内側に白いセルがあればtrue）．
+ *
+ * @param [in] gray : 濃淡画像
+ * @param [in] x, y : 四角形の頂点（画像上で時計回り）
+ */
+bool MarkerIdDecoder::CheckBorder(const cv::Mat& gray, const double x[4], const double y[4]) {
+  float threshold;
+  return SampleCells(gray, x, y, threshold) && IsBorderDark(threshold);
+}
+
+/*
+ * ID の判定
+ *
+ * @param [in] gray      : 濃淡画像
+ * @param [in] x, y      : マーカーの頂点（画像上で時計回り）
+ * @param [out] id       : マーカーのID
+ * @param [out] rotation : 頂点 0 から数えた正しい頂点 0 の位置
+ *                         （RectangleMarker::RotateCorners(rotation) で向きを直せる）
+ *
+ * @return 辞書にあるIDが読めればtrue
+ */
+bool MarkerIdDecoder::Decode(const cv::Mat& gray, const double x[4], const double y[4],
+			     int& id, int& rotation) {
+  id = -1;
+  rotation = 0;
+  if (dictionary.empty()) return false;
+  float threshold;
+  if (!SampleCells(gray, x, y, threshold) || !IsBorderDark(threshold)) return false;
+
+  // 内側のビット列
+  const int cellsPerSide = patternCells;
+  uint64_t bits = 0;
+  for (int r = 0; r < gridSize; r++) {
+    for (int c = 0; c < gridSize; c++) {
+      float v = cells[(r + borderBits) * cellsPerSide + (c + borderBits)];
+      if (v > threshold) bits |= (uint64_t) 1 << (r * gridSize + c);
+    }
+  }
+
+  std::unordered_map<uint64_t, int>::const_iterator it = dictionary.find(bits);
+  if (it == dictionary.end()) return false;
+  id = it->second / 4;
+  // 読んだ頂点 0 は正しい頂点 k にあたるので，正しい頂点 0 は読んだ頂点 4 - k
+  rotation = (4 - it->second % 4) & 3;
+  return true;
+}
+
+/* ****************************************** End of marker_id_decoder.c *** */
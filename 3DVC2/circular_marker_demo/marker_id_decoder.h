@@ -0,0 +1,66 @@
+/* ************************************************* marker_id_decoder.h *** *
+ * 正方形マーカーのID判定クラス(ヘッダファイル)
+ * ************************************************************************* */
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+class MarkerIdDecoder
+{
+ public:
+  // コンストラクタ
+  MarkerIdDecoder();
+
+  // デストラクタ
+  ~MarkerIdDecoder();
+
+  // 辞書の登録（4方向の回転をすべて登録する）
+  bool AddCode(int id, uint64_t bits);
+  // 辞書の読み込み（1行に "ID ビット列" を書く．ビット列は行優先の 0/1, 白が 1）
+  bool LoadDictionary(const std::string& name);
+  void ClearDictionary(void);
+  bool Empty(void) const;
+
+  // ID の判定
+  bool Decode(const cv::Mat& gray, const double x[4], const double y[4],
+	      int& id, int& rotation);
+  // 黒い枠があるかどうかの判定（辞書は使わない）
+  bool CheckBorder(const cv::Mat& gray, const double x[4], const double y[4]);
+
+  // メンバ変数（変更したら ClearDictionary してから登録しなおす）
+  int    gridSize;     // 内側のビットの数（一辺）
+  int    borderBits;   // 黒い枠の幅（ビット単位）
+  int    subSamples;   // 1セルあたりの標本点の数（一辺）
+  double minContrast;  // 白と黒のセルの輝度差の最小値
+
+  // デフォルトパラメータ
+  const int    DEFAULT_GRID_SIZE    = 4;
+  const int    DEFAULT_BORDER_BITS  = 1;
+  const int    DEFAULT_SUB_SAMPLES  = 3;
+  const double DEFAULT_MIN_CONTRAST = 30.0;
+
+ private:
+  // ビット列を反時計回りに 90 度回転する関数
+  uint64_t Rotate(uint64_t bits) const;
+  // 標本点の配置を計算する関数
+  void BuildPattern(void);
+  // セルの平均輝度と白黒の閾値を求める関数
+  bool SampleCells(const cv::Mat& gray, const double x[4], const double y[4],
+		   float& threshold);
+  // 枠のセルがすべて黒いかどうか
+  bool IsBorderDark(float threshold) const;
+
+  std::unordered_map<uint64_t, int> dictionary; // ビット列 -> ID * 4 + 回転
+  int patternCells;               // 標本点を計算したときのセル数（一辺）
+  int patternSubSamples;
+  std::vector<float> sx, sy;      // 標本点の単位正方形内の座標
+  std::vector<float> px, py;      // 標本点の画像座標
+  std::vector<float> samples;     // 標本点の輝度
+  std::vector<float> cells;       // セルの平均輝度
+};
+
+/* ****************************************** End of marker_id_decoder.h *** */
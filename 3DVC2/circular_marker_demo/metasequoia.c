@@ -7,15 +7,17 @@
  * コンストラクタ
  */
 Metasequoia::Metasequoia() {
-  scale = 1.0;
+  scale  = 1.0;
+  layout = MQO_LAYOUT_FLOAT;
 }
 
 /*
  * コンストラクタ
  */
 Metasequoia::Metasequoia(char* filename) {
-  scale = 1.0;  
-  model = mqoCreateModel (filename, scale);
+  scale  = 1.0;
+  layout = MQO_LAYOUT_FLOAT;
+  model  = mqoCreateModelEx (filename, scale, layout);
 }
 
 /*
@@ -31,7 +33,7 @@ Metasequoia::~Metasequoia() {
  * @param [in] filename : ファイル名
  */
 void Metasequoia::OpenModel (char* filename) {
-  model = mqoCreateModel (filename, scale);
+  model = mqoCreateModelEx (filename, scale, layout);
 }
 
 /*
@@ -41,4 +43,15 @@ void Metasequoia::DrawModel (void) {
   mqoCallModel (model);
 }
 
+/*
+ * 3Dモデルを複数の位置に描画する関数
+ * （対応していればインスタンス描画でマテリアルごとに1回で描画する）
+ *
+ * @param [in] matrices : モデルビュー行列（16個ずつ）
+ * @param [in] count    : 描画する数
+ */
+void Metasequoia::DrawInstances (const float* matrices, int count) {
+  mqoCallModelInstanced (model, matrices, count);
+}
+
 /* ************************************************ End of metasequoia.c *** */
@@ -18,10 +18,13 @@ class Metasequoia {
   void OpenModel (char* filename);
   // モデルを描画する関数
   void DrawModel (void);
+  // モデルを複数の位置に描画する関数
+  void DrawInstances (const float* matrices, int count);
   
   // メンバ変数
   MQO_MODEL model;
   double    scale;
+  int       layout;   // 頂点データの形式（MQO_LAYOUT_FLOAT / MQO_LAYOUT_PACKED）
 
 };
 
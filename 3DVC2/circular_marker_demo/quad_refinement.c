@@ -0,0 +1,170 @@
+/* *************************************************** quad_refinement.c *** *
+ * 四角形の頂点のサブピクセル推定クラス
+ * ************************************************************************* */
+#include "quad_refinement.h"
+
+/*
+ * コンストラクタ
+ */
+QuadRefinement::QuadRefinement() {
+  samplesPerSide = DEFAULT_SAMPLES_PER_SIDE;
+  searchRadius   = DEFAULT_SEARCH_RADIUS;
+  cornerMargin   = DEFAULT_CORNER_MARGIN;
+  maxShift       = DEFAULT_MAX_SHIFT;
+}
+
+/*
+ * デストラクタ
+ */
+QuadRefinement::~QuadRefinement() {
+  ;
+}
+
+/*
+ * 1辺に直線を当てはめる関数
+ *
+ * 辺に沿って samplesPerSide 箇所で法線方向の輝度プロファイルを取り，
+ * 法線方向の微分の2乗を重みとして点を集め，重み付き主成分分析
+ * （全最小二乗法）で直線を求める．標本点の数は辺の長さによらず一定．
+ *
+ * @param [in] gray   : 濃淡画像
+ * @param [in] p0, p1 : 辺の端点
+ * @param [out] line  : 直線 (a, b, c)（a^2 + b^2 = 1）
+ *
+ * @return 直線が求まればtrue
+ */
+bool QuadRefinement::FitLine(const cv::Mat& gray,
+			     const cv::Point2f& p0, const cv::Point2f& p1,
+			     double line[3]) {
+  float dx = p1.x - p0.x, dy = p1.y - p0.y;
+  float length = sqrtf(dx * dx + dy * dy);
+  if (length < 4.0f) return false;
+  float tx = dx / length, ty = dy / length; // 辺の方向
+  float nx = -ty, ny = tx;                  // 辺の法線
+
+  // 法線方向に -R-1 .. R+1 の輝度を取る（微分は -R .. R で計算する）
+  const int S = std::max(samplesPerSide, 2);
+  const int R = std::max(searchRadius, 1);
+  const int P = 2 * R + 3;
+  const int count = S * P;
+  px.resize(count); py.resize(count); value.resize(count);
+  int m = S * (2 * R + 1);
+  wx.resize(m); wy.resize(m); weight.resize(m);
+
+  float t0 = (float) cornerMargin, t1 = (float) (1.0 - cornerMargin);
+  for (int s = 0; s < S; s++) {
+    float t = t0 + (t1 - t0) * s / (S - 1);
+    float cx = p0.x + t * dx, cy = p0.y + t * dy;
+    for (int d = 0; d < P; d++) {
+      float off = (float) (d - R - 1);
+      px[s * P + d] = cx + off * nx;
+      py[s * P + d] = cy + off * ny;
+    }
+  }
+
+  // 画像の外にかかる辺は当てはめない
+  const float xmax = (float) (gray.cols - 1.001), ymax = (float) (gray.rows - 1.001);
+  for (int s = 0; s < S; s++) {
+    int i0 = s * P, i1 = s * P + P - 1;
+    if (px[i0] < 0 || py[i0] < 0 || px[i0] > xmax || py[i0] > ymax ||
+	px[i1] < 0 || py[i1] < 0 || px[i1] > xmax || py[i1] > ymax) return false;
+  }
+
+  // 双線形補間
+  const size_t step = gray.step;
+  const unsigned char* data = gray.data;
+  for (int i = 0; i < count; i++) {
+    int   ix = (int) px[i];
+    int   iy = (int) py[i];
+    float fx = px[i] - ix;
+    float fy = py[i] - iy;
+    const unsigned char* p = data + iy * step + ix;
+    float top    = p[0]    + fx * (p[1]        - p[0]);
+    float bottom = p[step] + fx * (p[step + 1] - p[step]);
+    value[i] = top + fy * (bottom - top);
+  }
+
+  // 法線方向の微分の2乗を重みにする
+  for (int s = 0; s < S; s++) {
+    const float* v = &value[s * P];
+    for (int d = 0; d < 2 * R + 1; d++) {
+      float g = 0.5f * (v[d + 2] - v[d]);
+      int k = s * (2 * R + 1) + d;
+      weight[k] = g * g;
+      wx[k] = px[s * P + d + 1];
+      wy[k] = py[s * P + d + 1];
+    }
+  }
+
+  // 重み付きモーメントの累積（ベクトル化できるように単純なループにする）
+  float sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0;
+  const float* W  = &weight[0];
+  const float* X  = &wx[0];
+  const float* Y  = &wy[0];
+#pragma omp simd reduction(+:sw, sx, sy, sxx, sxy, syy)
+  for (int k = 0; k < m; k++) {
+    float w = W[k];
+    float x = X[k] - p0.x; // 桁落ちを避けるため p0 からの相対座標
+    float y = Y[k] - p0.y;
+    sw  += w;
+    sx  += w * x;
+    sy  += w * y;
+    sxx += w * x * x;
+    sxy += w * x * y;
+    syy += w * y * y;
+  }
+  if (sw <= 1e-6f) return false;
+
+  // 重み付き共分散行列の最小固有値の固有ベクトルが直線の法線
+  double mx = sx / sw, my = sy / sw;
+  double cxx = sxx / sw - mx * mx;
+  double cxy = sxy / sw - mx * my;
+  double cyy = syy / sw - my * my;
+  double theta = 0.5 * atan2(2.0 * cxy, cxx - cyy); // 主軸（直線の方向）
+  double a = -sin(theta), b = cos(theta);
+  line[0] = a;
+  line[1] = b;
+  line[2] = -(a * (mx + p0.x) + b * (my + p0.y));
+  return true;
+}
+
+/*
+ * 頂点のサブピクセル推定
+ *
+ * 4辺それぞれに直線を当てはめ，隣り合う直線の交点を頂点とする．
+ *
+ * @param [in] gray      : 濃淡画像
+ * @param [in,out] quad  : 四角形の頂点
+ *
+ * @return 4頂点とも推定できればtrue
+ */
+bool QuadRefinement::Refine(const cv::Mat& gray, std::vector<cv::Point2f>& quad) {
+  if (gray.empty() || gray.type() != CV_8UC1 || quad.size() != 4) return false;
+
+  double lines[4][3];
+  bool fitted[4];
+  for (int k = 0; k < 4; k++) {
+    fitted[k] = FitLine(gray, quad[k], quad[(k + 1) & 3], lines[k]);
+  }
+
+  // 頂点 k は辺 k-1 と辺 k の交点
+  bool all = true;
+  cv::Point2f refined[4];
+  for (int k = 0; k < 4; k++) {
+    refined[k] = quad[k];
+    const double* l0 = lines[(k + 3) & 3];
+    const double* l1 = lines[k];
+    if (!fitted[(k + 3) & 3] || !fitted[k]) { all = false; continue; }
+    double w = l0[0] * l1[1] - l0[1] * l1[0];
+    if (fabs(w) < 1e-6) { all = false; continue; }
+    double x = (l0[1] * l1[2] - l0[2] * l1[1]) / w;
+    double y = (l0[2] * l1[0] - l0[0] * l1[2]) / w;
+    double ex = x - quad[k].x, ey = y - quad[k].y;
+    if (ex * ex + ey * ey > maxShift * maxShift) { all = false; continue; }
+    refined[k] = cv::Point2f((float) x, (float) y);
+  }
+  for (int k = 0; k < 4; k++) quad[k] = refined[k];
+  return all;
+}
+
+/* ******************************************** End of quad_refinement.c *** */
@@ -0,0 +1,44 @@
+/* *************************************************** quad_refinement.h *** *
+ * 四角形の頂点のサブピクセル推定クラス(ヘッダファイル)
+ * ************************************************************************* */
+#pragma once
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+class QuadRefinement
+{
+ public:
+  // コンストラクタ
+  QuadRefinement();
+
+  // デストラクタ
+  ~QuadRefinement();
+
+  // 頂点のサブピクセル推定（失敗した頂点は元の位置のまま）
+  bool Refine (const cv::Mat& gray, std::vector<cv::Point2f>& quad);
+
+  // メンバ変数
+  int    samplesPerSide;     // 1辺あたりの標本数
+  int    searchRadius;       // 辺の法線方向の探索範囲 [画素]
+  double cornerMargin;       // 頂点付近で使わない辺の割合
+  double maxShift;           // 頂点の移動量の最大値 [画素]
+
+  // デフォルトパラメータ
+  const int    DEFAULT_SAMPLES_PER_SIDE = 24;
+  const int    DEFAULT_SEARCH_RADIUS    = 3;
+  const double DEFAULT_CORNER_MARGIN    = 0.1;
+  const double DEFAULT_MAX_SHIFT        = 3.0;
+
+ private:
+  // 1辺に直線を当てはめる関数（a x + b y + c = 0）
+  bool FitLine (const cv::Mat& gray, const cv::Point2f& p0, const cv::Point2f& p1,
+		double line[3]);
+
+  // 作業領域（1辺分）
+  std::vector<float> px, py;         // 標本点の画像座標
+  std::vector<float> value;          // 標本点の輝度
+  std::vector<float> wx, wy, weight; // 重み付きの点
+};
+
+/* ******************************************** End of quad_refinement.h *** */
@@ -0,0 +1,297 @@
+/*!
+ * @file	raw_frame_file.c
+ * @brief	無圧縮フレームファイル(.raw)の読み書きクラス
+ */
+#include "raw_frame_file.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*!
+ * @brief  コンストラクタ
+ */
+RawFrameReader::RawFrameReader ()
+{
+  memset (&header, 0, sizeof (header));
+  frameCount = 0;
+  mapped     = NULL;
+  mappedSize = 0;
+}
+
+/*!
+ * @brief  デストラクタ
+ */
+RawFrameReader::~RawFrameReader ()
+{
+  Close ();
+}
+
+/*!
+ * @brief  ファイルのオープン
+ *
+ * @param[in] name  入力ファイル名
+ *
+ * @retval  True or False
+ */
+bool RawFrameReader::Open (const std::string &name)
+{
+  Close ();
+
+  int fd = open (name.c_str (), O_RDONLY);
+  if (fd < 0) {
+    fprintf (stderr, "Cannot open %s\n", name.c_str ());
+    return false;
+  }
+  struct stat st;
+  if (fstat (fd, &st) != 0 || (size_t) st.st_size < sizeof (RawFrameHeader)) {
+    fprintf (stderr, "Invalid raw frame file %s\n", name.c_str ());
+    close (fd);
+    return false;
+  }
+  // 読み取り専用でマップする（書き換えたページが残ると，ループ再生で
+  // 同じフレームが前回の処理結果になってしまう）
+  mappedSize = (size_t) st.st_size;
+  void *addr = mmap (NULL, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (addr == MAP_FAILED) {
+    fprintf (stderr, "Cannot map %s\n", name.c_str ());
+    mappedSize = 0;
+    return false;
+  }
+  mapped = (unsigned char *) addr;
+
+  // ヘッダのチェック
+  memcpy (&header, mapped, sizeof (header));
+  if (memcmp (header.magic, RAW_FRAME_MAGIC, 4) != 0 ||
+      header.version != RAW_FRAME_VERSION ||
+      header.frameStride < RAW_FRAME_PIXEL_OFFSET +
+      (uint64_t) header.step * header.height) {
+    fprintf (stderr, "Invalid raw frame file %s\n", name.c_str ());
+    Close ();
+    return false;
+  }
+
+  // 書き込みが途中で終わったファイルでも，揃っているフレームだけは使う
+  // （ヘッダのフレーム数は Close で書かれるので，0 なら不明とみなして
+  //   ファイルの大きさから求めた数を使う）
+  frameCount = 0;
+  if (mappedSize > header.dataOffset) {
+    frameCount = (size_t) ((mappedSize - header.dataOffset) / header.frameStride);
+  }
+  if (header.frameCount > 0 && header.frameCount < frameCount) {
+    frameCount = (size_t) header.frameCount;
+  }
+
+  // 先頭から順に読むことをカーネルに伝えて先読みさせる
+  madvise (mapped, mappedSize, MADV_SEQUENTIAL);
+
+  return frameCount > 0;
+}
+
+/*!
+ * @brief  ファイルのクローズ
+ */
+void RawFrameReader::Close (void)
+{
+  if (mapped != NULL) {
+    munmap (mapped, mappedSize);
+  }
+  mapped     = NULL;
+  mappedSize = 0;
+  frameCount = 0;
+}
+
+/*!
+ * @brief  ファイルがオープンされているかどうか
+ */
+bool RawFrameReader::IsOpened (void) const
+{
+  return mapped != NULL;
+}
+
+/*!
+ * @brief  フレームの参照（コピーしない）
+ *
+ * @param[in] index  フレーム番号
+ *
+ * @return  マップした領域を指す画像（ファイルをクローズするまで有効．読み取り専用）
+ */
+cv::Mat RawFrameReader::Frame (size_t index) const
+{
+  if (mapped == NULL || index >= frameCount) return cv::Mat ();
+  unsigned char *frame = mapped + header.dataOffset + index * header.frameStride;
+  return cv::Mat ((int) header.height, (int) header.width, (int) header.type,
+		  frame + RAW_FRAME_PIXEL_OFFSET, header.step);
+}
+
+/*!
+ * @brief  フレームの撮影時刻
+ *
+ * @param[in] index  フレーム番号
+ *
+ * @return  撮影時刻 [マイクロ秒]
+ */
+int64_t RawFrameReader::Timestamp (size_t index) const
+{
+  if (mapped == NULL || index >= frameCount) return 0;
+  int64_t timestamp;
+  memcpy (&timestamp,
+	  mapped + header.dataOffset + index * header.frameStride,
+	  sizeof (timestamp));
+  return timestamp;
+}
+
+/*!
+ * @brief  コンストラクタ
+ */
+RawFrameWriter::RawFrameWriter ()
+{
+  memset (&header, 0, sizeof (header));
+  fd   = -1;
+  used = 0;
+}
+
+/*!
+ * @brief  デストラクタ
+ */
+RawFrameWriter::~RawFrameWriter ()
+{
+  Close ();
+}
+
+/*!
+ * @brief  ファイルのオープン
+ *
+ * @param[in] name    出力ファイル名
+ * @param[in] width   画像の幅
+ * @param[in] height  画像の高さ
+ * @param[in] type    画素の型（CV_8UC1 または CV_8UC3）
+ *
+ * @retval  True or False
+ */
+bool RawFrameWriter::Open (const std::string &name, int width, int height, int type)
+{
+  Close ();
+
+  if (type != CV_8UC1 && type != CV_8UC3) {
+    fprintf (stderr, "Unsupported pixel type for %s\n", name.c_str ());
+    return false;
+  }
+  fd = open (name.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    fprintf (stderr, "Cannot open %s\n", name.c_str ());
+    return false;
+  }
+
+  // ヘッダの作成（画素の行は詰めて格納し，フレームはページ境界に揃える）
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, RAW_FRAME_MAGIC, 4);
+  header.version = RAW_FRAME_VERSION;
+  header.width   = (uint32_t) width;
+  header.height  = (uint32_t) height;
+  header.type    = (uint32_t) type;
+  header.step    = (uint32_t) (width * CV_MAT_CN (type));
+  uint64_t frameBytes = RAW_FRAME_PIXEL_OFFSET + (uint64_t) header.step * height;
+  header.frameStride = (frameBytes + RAW_FRAME_ALIGNMENT - 1)
+    / RAW_FRAME_ALIGNMENT * RAW_FRAME_ALIGNMENT;
+  header.frameCount  = 0;
+  header.dataOffset  = RAW_FRAME_ALIGNMENT;
+
+  // バッファはフレーム単位で DEFAULT_CHUNK_SIZE 程度にする
+  size_t frames = DEFAULT_CHUNK_SIZE / header.frameStride;
+  if (frames < 1) frames = 1;
+  buffer.assign (frames * header.frameStride, 0);
+
+  // 先頭ページにヘッダを置く（フレーム数は Close で書き直す）
+  memcpy (&buffer[0], &header, sizeof (header));
+  used = header.dataOffset;
+  if (!Flush ()) {
+    Close ();
+    return false;
+  }
+  return true;
+}
+
+/*!
+ * @brief  ファイルのクローズ（残りのフレームとフレーム数を書き出す）
+ */
+void RawFrameWriter::Close (void)
+{
+  if (fd < 0) return;
+  Flush ();
+  if (pwrite (fd, &header, sizeof (header), 0) != (ssize_t) sizeof (header)) {
+    fprintf (stderr, "Cannot update raw frame header\n");
+  }
+  close (fd);
+  fd = -1;
+  buffer.clear ();
+  used = 0;
+}
+
+/*!
+ * @brief  ファイルがオープンされているかどうか
+ */
+bool RawFrameWriter::IsOpened (void) const
+{
+  return fd >= 0;
+}
+
+/*!
+ * @brief  フレームの書き込み
+ *
+ * @param[in] image      書き込む画像（オープン時と同じサイズと型）
+ * @param[in] timestamp  撮影時刻 [マイクロ秒]
+ *
+ * @retval  True or False
+ */
+bool RawFrameWriter::Write (const cv::Mat &image, int64_t timestamp)
+{
+  if (fd < 0) return false;
+  if (image.cols != (int) header.width || image.rows != (int) header.height ||
+      image.type () != (int) header.type) {
+    fprintf (stderr, "Frame size or type mismatch\n");
+    return false;
+  }
+  if (used + header.frameStride > buffer.size () && !Flush ()) {
+    return false;
+  }
+
+  unsigned char *frame = &buffer[used];
+  memcpy (frame, &timestamp, sizeof (timestamp));
+  unsigned char *pixels = frame + RAW_FRAME_PIXEL_OFFSET;
+  if (image.isContinuous ()) {
+    memcpy (pixels, image.data, (size_t) header.step * header.height);
+  } else {
+    for (int y = 0; y < image.rows; y++) {
+      memcpy (pixels + (size_t) y * header.step, image.ptr (y), header.step);
+    }
+  }
+  used += header.frameStride;
+  header.frameCount++;
+
+  return true;
+}
+
+/*!
+ * @brief  バッファの内容を書き出す
+ *
+ * @retval  True or False
+ */
+bool RawFrameWriter::Flush (void)
+{
+  size_t offset = 0;
+  while (offset < used) {
+    ssize_t n = write (fd, &buffer[offset], used - offset);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      fprintf (stderr, "Cannot write raw frames: %s\n", strerror (errno));
+      return false;
+    }
+    offset += (size_t) n;
+  }
+  used = 0;
+  return true;
+}
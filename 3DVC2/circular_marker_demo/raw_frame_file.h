@@ -0,0 +1,112 @@
+/*!
+ * @file	raw_frame_file.h
+ * @brief	無圧縮フレームファイル(.raw)の読み書きクラス
+ *
+ * ファイル構成:
+ *   [RawFrameHeader][フレーム0][フレーム1]...
+ * 各フレームは frameStride バイトの固定長で，先頭に撮影時刻（int64, マイクロ秒）,
+ * RAW_FRAME_PIXEL_OFFSET バイト目から height * step バイトの画素データを格納する．
+ * フレームの先頭はページ境界に揃えてあるので，mmap した領域をそのまま
+ * cv::Mat として参照できる．
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// ファイル識別子とバージョン
+#define RAW_FRAME_MAGIC         "RAWF"
+#define RAW_FRAME_VERSION       1
+// フレーム先頭から画素データまでのオフセット
+#define RAW_FRAME_PIXEL_OFFSET  64
+// フレームの境界（ページサイズ）
+#define RAW_FRAME_ALIGNMENT     4096
+
+/*!
+ * @brief  ファイルヘッダ（リトルエンディアン）
+ */
+typedef struct _RawFrameHeader {
+  char     magic[4];     // "RAWF"
+  uint32_t version;      // フォーマットのバージョン
+  uint32_t width;        // 画像の幅
+  uint32_t height;       // 画像の高さ
+  uint32_t type;         // 画素の型（CV_8UC1 または CV_8UC3）
+  uint32_t step;         // 1行のバイト数
+  uint64_t frameStride;  // 1フレームのバイト数（時刻と詰め物を含む）
+  uint64_t frameCount;   // フレーム数
+  uint64_t dataOffset;   // 先頭フレームのファイル内オフセット
+} RawFrameHeader;
+
+/*!
+ * @class  無圧縮フレームファイルの読み込みクラス
+ * @brief　ファイル全体を mmap し，フレームをコピーせずに参照する
+ */
+class RawFrameReader
+{
+ public:
+  // コンストラクタ
+  RawFrameReader ();
+
+  // デストラクタ
+  ~RawFrameReader ();
+
+  // ファイルのオープンとクローズ
+  bool Open (const std::string &name);
+  void Close (void);
+  bool IsOpened (void) const;
+
+  // フレームの参照
+  cv::Mat Frame (size_t index) const;
+  int64_t Timestamp (size_t index) const;
+
+  // メンバー
+  RawFrameHeader header;  // ファイルヘッダ
+  size_t   frameCount;    // 参照できるフレーム数
+
+ private:
+  unsigned char *mapped;  // mmap した領域の先頭
+  size_t   mappedSize;    // mmap した領域のサイズ
+
+  RawFrameReader (const RawFrameReader&);
+  RawFrameReader& operator= (const RawFrameReader&);
+};
+
+/*!
+ * @class  無圧縮フレームファイルの書き込みクラス
+ * @brief　フレームをバッファにためて大きな単位で順に書き出す
+ */
+class RawFrameWriter
+{
+ public:
+  // コンストラクタ
+  RawFrameWriter ();
+
+  // デストラクタ
+  ~RawFrameWriter ();
+
+  // ファイルのオープンとクローズ
+  bool Open (const std::string &name, int width, int height, int type);
+  void Close (void);
+  bool IsOpened (void) const;
+
+  // フレームの書き込み
+  bool Write (const cv::Mat &image, int64_t timestamp);
+
+  // 1回の書き込みの目安 [バイト]
+  static const size_t DEFAULT_CHUNK_SIZE = 8 << 20;
+
+  // メンバー
+  RawFrameHeader header;  // ファイルヘッダ
+
+ private:
+  bool Flush (void);
+
+  int    fd;                         // ファイルディスクリプタ
+  std::vector<unsigned char> buffer; // 書き込み待ちのフレーム
+  size_t used;                       // buffer の使用量
+
+  RawFrameWriter (const RawFrameWriter&);
+  RawFrameWriter& operator= (const RawFrameWriter&);
+};
@@ -1,7 +1,7 @@
 /* *********************************************************** Rectanglee.c *** *
  * 楕円クラス
  * ************************************************************************* */
-#include "Rectangle.h"
+#include "rectangle.h"
 #include <algorithm>
 #include <iterator>
 
@@ -135,62 +135,4 @@ bool Rectangle::CheckInner(double x, double y) {
   return retval;
 }
 
-void CircularMarker::ComputeCameraParam(void) {
-  // 指示平面の法線ベクトルとカメラから指示平面までの距離を計算
-  Eigen::VectorXd normalOuter(3), normalInner(3);
-  double distOuter = ComputeNormal (ellipseOuter.Q,
-				    normalOuter, radiusOuter, position);
-
-  // 世界座標系のＹ軸の計算
-  Eigen::Vector3d Y = normalOuter;
-
-  // カメラから支持平面までの距離の計算
-  double dist = distOuter;
-  
-  // 外側の円の中心を指すベクトルを計算
-  Eigen::VectorXd XcOuter = ellipseOuter.Q.inverse() * Y;
-  XcOuter(0) /= XcOuter(2);
-  XcOuter(1) /= XcOuter(2);
-  XcOuter(2) = 1.0;
-  Eigen::VectorXd RcOuter = -dist * XcOuter / Y.dot(XcOuter);
-
-  // 内側の円の中心を指すベクトルを計算
-  Eigen::VectorXd XcInner = ellipseInner.Q.inverse() * Y;
-  XcInner(0) /= XcInner(2);
-  XcInner(1) /= XcInner(2);
-  XcInner(2) = 1.0;
-  Eigen::VectorXd RcInner = -dist * XcInner / Y.dot(XcInner);
-
-  // カメラの並進ベクトルの生成
-  T = RcOuter;
-
-  // 世界座標系のＺ軸を計算（二つの円の中心を結んだ方向）
-  Eigen::MatrixXd I = Eigen::MatrixXd::Identity(3, 3);
-  Eigen::Vector3d Z = (((I - Y * Y.transpose())
-			* (RcInner - RcOuter)).normalized());
-
-  // 世界座標系のＸ軸を計算（Ｙ軸とＺ軸の外積として計算）
-  Eigen::Vector3d X = Y.cross(Z).normalized();
-
-  // カメラの回転行列を生成
-  R.col(0) = X;
-  R.col(1) = Y;
-  R.col(2) = Z;
-
-  // 座標系の変換行列
-  Eigen::MatrixXd R_ = Eigen::Matrix3d::Zero(3, 3);
-  R_(0, 1) = 1.0;
-  R_(1, 0) = 1.0;
-  R_(2, 2) = -1.0;
-
-  // 座標系の変換
-  R = R_ * R;
-  T = R_ * T;
-	   
-  // モデルビュー行列の生成
-  M[0] = R(0, 0); M[1] = R(1, 0); M[2]  = R(2, 0);
-  M[4] = R(0, 1); M[5] = R(1, 1); M[6]  = R(2, 1);
-  M[8] = R(0, 2); M[9] = R(1, 2); M[10] = R(2, 2);
-  M[12] = T(0); M[13] = T(1); M[14] = T(2);
-}
 /* **************************************************** End of Rectanglee.c *** */
@@ -0,0 +1,117 @@
+/* ************************************************ rectangle_benchmark.c *** *
+ * 矩形検出の処理時間の計測
+ *
+ * 使い方: rectangle_benchmark [フレーム数] [幅] [高さ]
+ *
+ * SyntheticMarkerSource で生成した画像をあらかじめメモリに用意しておき，
+ * 検出モードごとに（作業領域を確保し終えた）定常状態の1フレームあたりの
+ * 処理時間を計測する．画像の生成は計測に含めない．
+ * ************************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "frame_source.h"
+#include "rectangle_detection.h"
+#include "rectangle_tracker.h"
+
+// 用意する画像の枚数（計測中はこれを繰り返し使う）
+#define NUM_SOURCE_FRAMES 64
+// 計測前に空回しするフレーム数
+#define NUM_WARMUP_FRAMES 10
+
+/*
+ * 1つの検出方法の計測結果を表示する
+ */
+static void PrintResult(const char* name, int64_t ticks, int frames, size_t quads)
+{
+  double ms = 1000.0 * (double) ticks / cv::getTickFrequency() / frames;
+  printf("%-12s %8.3f ms/frame %8.1f fps %6.2f quads/frame\n",
+	 name, ms, 1000.0 / ms, (double) quads / frames);
+}
+
+/*
+ * 検出器の計測
+ */
+static void BenchmarkDetection(const char* name, RectangleDetection& detector,
+			       const std::vector<cv::Mat>& images, int frames)
+{
+  std::vector<std::vector<cv::Point> > rect_list;
+
+  for (int i = 0; i < NUM_WARMUP_FRAMES; i++) {
+    detector.Detect(images[i % images.size()], rect_list);
+  }
+
+  size_t quads = 0;
+  int64_t start = cv::getTickCount();
+  for (int i = 0; i < frames; i++) {
+    detector.Detect(images[i % images.size()], rect_list);
+    quads += rect_list.size();
+  }
+  PrintResult(name, cv::getTickCount() - start, frames, quads);
+}
+
+/*
+ * 追跡（一定フレームごとに高速モードで検出しなおす）の計測
+ */
+static void BenchmarkTracking(const char* name, RectangleDetection& detector,
+			      const std::vector<cv::Mat>& images, int frames)
+{
+  RectangleTracker tracker;
+  std::vector<std::vector<cv::Point2f> > quad_list;
+
+  for (int i = 0; i < NUM_WARMUP_FRAMES; i++) {
+    tracker.Track(images[i % images.size()], detector, quad_list);
+  }
+
+  // 空回しで追跡していた状態を捨て，検出から始める
+  tracker.Reset();
+  size_t quads = 0;
+  int64_t start = cv::getTickCount();
+  for (int i = 0; i < frames; i++) {
+    tracker.Track(images[i % images.size()], detector, quad_list);
+    quads += quad_list.size();
+  }
+  PrintResult(name, cv::getTickCount() - start, frames, quads);
+}
+
+int main(int argc, char** argv)
+{
+  int frames = (argc > 1) ? atoi(argv[1]) : 300;
+  int width  = (argc > 2) ? atoi(argv[2]) : 640;
+  int height = (argc > 3) ? atoi(argv[3]) : 480;
+  int channels;
+  if (frames < 1) frames = 1;
+
+  SyntheticMarkerSource source;
+  if (!source.Open(width, height, channels)) {
+    fprintf(stderr, "Cannot open synthetic source\n");
+    return 1;
+  }
+  std::vector<cv::Mat> images(NUM_SOURCE_FRAMES);
+  for (size_t i = 0; i < images.size(); i++) {
+    source.Grab(images[i]);
+  }
+  source.Close();
+
+  printf("%dx%d, %d frames, %d threads\n",
+	 width, height, frames, cv::getNumThreads());
+
+  RectangleDetection detector;
+  detector.mode = RectangleDetection::MODE_EXHAUSTIVE;
+  detector.fusedLevels = false;
+  BenchmarkDetection("per-level", detector, images, frames);
+
+  detector.fusedLevels = true;
+  BenchmarkDetection("fused", detector, images, frames);
+
+  detector.mode = RectangleDetection::MODE_FAST;
+  BenchmarkDetection("fast", detector, images, frames);
+
+  BenchmarkTracking("tracking", detector, images, frames);
+
+  return 0;
+}
+
+/* ***************************************** End of rectangle_benchmark.c *** */
@@ -1,27 +1,45 @@
-/* ************************************************* ellipse_detection.c *** *
- * 楕円検出クラス
+/* *********************************************** rectangle_detection.c *** *
+ * 矩形検出クラス
  * ************************************************************************* */
 #include <opencv2/features2d/features2d.hpp>
-#include "ellipse_detection.h"
-#include "ellipse_fitting.h"
-#include "ellipse.h"
+#include "rectangle_detection.h"
 #include <algorithm>
+#include <string.h>
 #include <iterator>
 
 /*
- * コンストラク
+ * コンストラクタ
  */
 RectangleDetection::RectangleDetection() {
-  minLength          = DEFAULT_MIN_LENGTH;
-  gaussianKernelSize = DEFAULT_GAUSSIAN_KERNEL_SIZE;
-  gaussianSigma      = DEFAULT_GAUSSIAN_SIGMA;
-  cannyParam[0]      = DEFAULT_CANNY_PARAM1;
-  cannyParam[1]      = DEFAULT_CANNY_PARAM2;
-  axisRatio          = DEFAULT_AXIS_RATIO;
-  axisLength         = DEFAULT_AXIS_LENGTH;
-  errorThreshold     = DEFAULT_ERROR_THRESHOLD;
-  drawEllipseCenter  = false;
-  ellipse_fitting.computeError = true;
+  Init(DEFAULT_LEVELS, DEFAULT_CANNY_THRESHOLD);
+}
+
+/*
+ * コンストラクタ
+ *
+ * @param [in] _levels         : 閾値のレベル数
+ * @param [in] _cannyThreshold : レベル0のCannyオペレータの上側閾値
+ */
+RectangleDetection::RectangleDetection(int _levels, int _cannyThreshold) {
+  Init(_levels, _cannyThreshold);
+}
+
+/*
+ * 初期化
+ */
+void RectangleDetection::Init(int _levels, int _cannyThreshold) {
+  levels             = _levels;
+  cannyThreshold     = _cannyThreshold;
+  minArea            = DEFAULT_MIN_AREA;
+  maxCosine          = DEFAULT_MAX_COSINE;
+  adaptiveBlockSize  = DEFAULT_ADAPTIVE_BLOCK_SIZE;
+  adaptiveOffset     = DEFAULT_ADAPTIVE_OFFSET;
+  minSolidity        = DEFAULT_MIN_SOLIDITY;
+  mergeDuplicates    = true;
+  mergeDistance      = DEFAULT_MERGE_DISTANCE;
+  mode               = MODE_EXHAUSTIVE;
+  fusedLevels        = true;
+  lutLevels          = 0;
 }
 
 /*
@@ -32,95 +50,549 @@ RectangleDetection::~RectangleDetection() {
 }
 
 /*
- * 楕円検出関数
+ * pt0->pt1 と pt0->pt2 のなす角の余弦
+ */
+static double angle(const cv::Point& pt1, const cv::Point& pt2, const cv::Point& pt0)
+{
+    double dx1 = pt1.x - pt0.x;
+    double dy1 = pt1.y - pt0.y;
+    double dx2 = pt2.x - pt0.x;
+    double dy2 = pt2.y - pt0.y;
+    return (dx1*dx2 + dy1*dy2)/sqrt((dx1*dx1 + dy1*dy1)*(dx2*dx2 + dy2*dy2) + 1e-10);
+}
+
+/*
+ * 矩形検出関数
  *
- * @param [in] image         : 入力画像
- * @param [out] ellipse_list : 検出した楕円のリスト
+ * 色プレーン×閾値レベルの探索はそれぞれ独立しているので，
+ * 別々の作業領域を使って並列に処理し，最後に決まった順番で結合する．
+ * （スレッド数によらず結果の順番は同じになる）
  *
- * @return 楕円が２つ以上検出された場合はtrue, そうでなければfalse
+ * @param [in] image      : 入力画像
+ * @param [out] rect_list : 検出した矩形のリスト
+ *
+ * @return 矩形が検出された場合はtrue, そうでなければfalse
  */
-bool RectangleDetection::Detect(const cv::Mat& image, 
-            vector<vector<cv::Point> >& rect_list)
+bool RectangleDetection::Detect(const cv::Mat& image,
+				std::vector<std::vector<cv::Point> >& rect_list)
+{
+    merged.clear();
+    quadScores.clear();
+    // 格子のセル自体は残して中身だけ空にする（次のフレームで確保しなおさない）
+    for (std::unordered_map<int64_t, std::vector<int> >::iterator it = grid.begin();
+         it != grid.end(); ++it) {
+      it->second.clear();
+    }
+
+    if (image.empty()) {
+      rect_list.clear();
+      return false;
+    }
+    if (mode == MODE_FAST) {
+      SearchFast(image);
+    } else if (levels > 0) {
+      SearchExhaustive(image);
+    }
+
+    // 要素の vector は使いまわし，数が増えたときだけ確保する
+    rect_list.resize(merged.size());
+    for (size_t n = 0; n < merged.size(); n++) {
+      rect_list[n].assign(merged[n].begin(), merged[n].end());
+    }
+
+    if (rect_list.size() > 0) return true;
+    else return false;
+}
+
+/*
+ * 全色プレーン×全閾値レベルの四角形の探索
+ *
+ * @param [in] image : 入力画像
+ */
+void RectangleDetection::SearchExhaustive(const cv::Mat& image)
 {
-    squares.clear();
-    
-    Mat pyr, timg, cv::gray0(image.size(), CV_8U), gray;
-    
     // down-scale and upscale the image to filter out the noise
     cv::pyrDown(image, pyr, cv::Size(image.cols/2, image.rows/2));
     cv::pyrUp(pyr, timg, image.size());
-    vector<vector<Point> > contours;
 
     // find squares in every color plane of the image
-    for( int c = 0; c < 3; c++ )
+    cv::split(timg, planes);
+    int numPlanes = std::min((int) planes.size(), 3);
+
+    if (fusedLevels && levels <= MAX_FUSED_LEVELS) {
+      // 色プレーンごとに Canny（レベル0）と全閾値レベルの2つの作業にする
+      if (lutLevels != levels) {
+        BuildLevelLut();
+      }
+      int numJobs = numPlanes * 2;
+      if ((int) jobs.size() < numJobs) jobs.resize(numJobs);
+
+      cv::parallel_for_(cv::Range(0, numJobs), [&](const cv::Range& range) {
+	  for (int j = range.start; j < range.end; j++) {
+	    if (j % 2 == 0) SearchLevel(planes[j / 2], 0, jobs[j]);
+	    else            SearchLevels(planes[j / 2], jobs[j]);
+	  }
+	});
+
+      for (int j = 0; j < numJobs; j++) {
+        MergeQuads(jobs[j].quads);
+      }
+      return;
+    }
+
+    int numJobs = numPlanes * levels;
+    if ((int) jobs.size() < numJobs) jobs.resize(numJobs);
+
+    cv::parallel_for_(cv::Range(0, numJobs), [&](const cv::Range& range) {
+	for (int j = range.start; j < range.end; j++) {
+	  SearchLevel(planes[j / levels], j % levels, jobs[j]);
+	}
+      });
+
+    // merge in job order so that the output is deterministic
+    for (int j = 0; j < numJobs; j++) {
+      MergeQuads(jobs[j].quads);
+    }
+}
+
+/*
+ * 1つの色プレーン・閾値レベルでの四角形の探索
+ *
+ * @param [in] gray0  : 色プレーン
+ * @param [in] l      : 閾値レベル
+ * @param [out] job   : 作業領域（見つかった四角形は job.quads に入る）
+ */
+void RectangleDetection::SearchLevel(const cv::Mat& gray0, int l,
+				     RectangleSearchJob& job)
+{
+    cv::Mat& gray = job.gray;
+
+    // hack: use Canny instead of zero threshold level.
+    // Canny helps to catch squares with gradient shading
+    if( l == 0 )
+    {
+        // apply Canny. Take the upper threshold from slider
+        // and set the lower to 0 (which forces edges merging)
+        cv::Canny(gray0, gray, 0, cannyThreshold, 5);
+        // dilate canny output to remove potential
+        // holes between edge segments
+        cv::dilate(gray, gray, cv::Mat(), cv::Point(-1,-1));
+    }
+    else
     {
-        int ch[] = {c, 0};
-        cv::mixChannels(&timg, 1, &gray0, 1, ch, 1);
+        // apply threshold if l!=0:
+        //     tgray(x,y) = gray(x,y) < (l+1)*255/N ? 255 : 0
+        cv::compare(gray0, cv::Scalar((l+1)*255/levels), gray, cv::CMP_GE);
+    }
 
-        // try several threshold levels
-        for( int l = 0; l < N; l++ )
-        {
-            // hack: use Canny instead of zero threshold level.
-            // Canny helps to catch squares with gradient shading
-            if( l == 0 )
-            {
-                // apply Canny. Take the upper threshold from slider
-                // and set the lower to 0 (which forces edges merging)
-                cv::Canny(gray0, gray, 0, thresh, 5);
-                // dilate canny output to remove potential
-                // holes between edge segments
-                cv::dilate(gray, gray, cv::Mat(), cv::Point(-1,-1));
+    TestContours(job);
+}
+
+/*
+ * ラベル画像の1つの閾値レベルの境界の追跡
+ *
+ * cv::findContours（RETR_LIST, CHAIN_APPROX_SIMPLE）の境界追跡と同じ手順で，
+ * 「ラベルが level 以上」の画素を前景として境界をたどる．2値画像に書き込む
+ * かわりに，追跡済みの印を閾値レベルごとのビットとして marks に付ける．
+ *
+ * @param [in] labels    : 縁を 0 で1画素広げたラベル画像
+ * @param [in,out] marks : 追跡済みの印（下位16ビットが追跡済み，上位16ビットが
+ *                         右隣の背景を調べた境界画素．ビット level-1 を使う）
+ * @param [in] step      : 1行の要素数
+ * @param [in] start     : 開始画素（labels の先頭からの要素数）
+ * @param [in] level     : 閾値レベル
+ * @param [in] hole      : 穴の境界かどうか
+ * @param [in] pt        : 開始画素の元の画像での座標
+ * @param [out] points   : 輪郭の点を追加するリスト
+ */
+static void traceLevelBorder(const uchar* labels, uint32_t* marks, int step,
+			     int start, int level, bool hole, cv::Point pt,
+			     std::vector<cv::Point>& points)
+{
+    static const int codeDx[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+    static const int codeDy[8] = { 0, -1, -1, -1, 0, 1, 1, 1 };
+    const int deltas[16] = {
+        1, 1 - step, -step, -step - 1, -1, step - 1, step, step + 1,
+        1, 1 - step, -step, -step - 1, -1, step - 1, step, step + 1
+    };
+    const uint32_t traced = 1u << (level - 1);
+    const uint32_t right  = traced << 16;
+    int i0 = start, i1, i3, i4 = 0;
+    int s, s_end, prev_s;
+
+    // 反時計回りに最初の前景の隣接画素を探す
+    s_end = s = hole ? 0 : 4;
+    do {
+        s = (s - 1) & 7;
+        i1 = i0 + deltas[s];
+    } while (labels[i1] < level && s != s_end);
+
+    if (s == s_end) {
+        // 孤立した1画素
+        marks[i0] |= traced | right;
+        points.push_back(pt);
+        return;
+    }
+
+    i3 = i0;
+    prev_s = s ^ 4;
+    for (;;) {
+        // 時計回りに次の前景の隣接画素を探す
+        s_end = s;
+        while (s < 15) {
+            i4 = i3 + deltas[++s];
+            if (labels[i4] >= level) break;
+        }
+        s &= 7;
+
+        // 右隣の背景を調べた画素からは穴の境界を追跡しない
+        if ((unsigned) (s - 1) < (unsigned) s_end) marks[i3] |= traced | right;
+        else marks[i3] |= traced;
+
+        // 向きが変わる点だけを残す（CHAIN_APPROX_SIMPLE）
+        if (s != prev_s) {
+            points.push_back(pt);
+            prev_s = s;
+        }
+        pt.x += codeDx[s];
+        pt.y += codeDy[s];
+
+        if (i4 == i0 && i3 == i1) break;
+        i3 = i4;
+        s = (s + 4) & 7;
+    }
+}
+
+/*
+ * 1つの色プレーンでの全閾値レベル（レベル1〜levels-1）の四角形の探索
+ *
+ * 閾値レベルごとに2値化して輪郭を抽出するかわりに，
+ * 1回の参照表の変換で各画素を「何番目の閾値まで越えているか」のラベルにし，
+ * ラベル画像を1回だけ走査する．レベル l の2値画像は「ラベルが l 以上」なので，
+ * 横に隣り合う画素のラベルが a から c に変わる所で，その間のレベルの境界の
+ * 開始点が見つかる．見つけた境界は findContours と同じ手順でたどり，
+ * 追跡済みの印をレベルごとのビットに付ける．
+ *
+ * 走査の順番と追跡の手順が findContours と同じなので，レベルごとの輪郭
+ * （点列と順番）はレベルごとの探索と一致する．画像の走査はレベル数に
+ * よらず1回で，レベル数に比例するのは境界の長さの分だけになる．
+ *
+ * @param [in] gray0  : 色プレーン
+ * @param [out] job   : 作業領域（見つかった四角形は job.quads に入る）
+ */
+void RectangleDetection::SearchLevels(const cv::Mat& gray0,
+				      RectangleSearchJob& job)
+{
+    cv::Mat& labels = job.labels;
+    cv::Mat& marks = job.marks;
+    std::vector<cv::Point>& points = job.points;
+    std::vector<cv::Vec3i>& spans = job.spans;
+
+    job.quads.clear();
+    points.clear();
+    spans.clear();
+    if (levels < 2 || gray0.empty()) return;
+
+    // 閾値レベルのラベルに変換（findContours と同じく縁を 0 で1画素広げる）
+    const int rows = gray0.rows, cols = gray0.cols;
+    const int step = cols + 2;
+    labels.create(rows + 2, step, CV_8UC1);
+    cv::Mat inner = labels(cv::Rect(1, 1, cols, rows));
+    cv::LUT(gray0, levelLut, inner);
+    memset(labels.ptr(0), 0, step);
+    memset(labels.ptr(rows + 1), 0, step);
+    for (int y = 1; y <= rows; y++) {
+        uchar* row = labels.ptr(y);
+        row[0] = row[cols + 1] = 0;
+    }
+    marks.create(labels.size(), CV_32SC1);
+    marks.setTo(cv::Scalar(0));
+
+    // 境界の開始点の走査（findContours と同じく行ごとに左から）
+    const uchar* lab = labels.ptr(0);
+    uint32_t* mk = (uint32_t*) marks.ptr(0);
+    for (int y = 1; y <= rows; y++) {
+        const uchar* row = labels.ptr(y);
+        for (int x = 1; x <= cols; x++) {
+            int a = row[x - 1], c = row[x];
+            if (a == c) continue;
+            int i = y * step + x;
+            if (c > a) {
+                // レベル a+1〜c の外側の境界（左隣が背景）
+                for (int l = a + 1; l <= c; l++) {
+                    if (mk[i] & (1u << (l - 1))) continue;
+                    int first = (int) points.size();
+                    traceLevelBorder(lab, mk, step, i, l, false, cv::Point(x - 1, y - 1), points);
+                    spans.push_back(cv::Vec3i(l, first, (int) points.size() - first));
+                }
+            } else {
+                // レベル c+1〜a の穴の境界（左隣が前景で，右隣は背景）
+                for (int l = c + 1; l <= a; l++) {
+                    if (mk[i - 1] & (1u << (l + 15))) continue;
+                    int first = (int) points.size();
+                    traceLevelBorder(lab, mk, step, i - 1, l, true, cv::Point(x - 2, y - 1), points);
+                    spans.push_back(cv::Vec3i(l, first, (int) points.size() - first));
+                }
             }
-            else
-            {
-                // apply threshold if l!=0:
-                //     tgray(x,y) = gray(x,y) < (l+1)*255/N ? 255 : 0
-                gray = gray0 >= (l+1)*255/N;
+        }
+    }
+
+    // レベルの順に，findContours と同じく見つけた順の逆に四角形を調べる
+    std::vector<cv::Point>& approx = job.approx;
+    for (int l = 1; l < levels; l++) {
+        for (int n = (int) spans.size() - 1; n >= 0; n--) {
+            if (spans[n][0] != l) continue;
+            cv::Mat curve(spans[n][2], 1, CV_32SC2, &points[spans[n][1]]);
+            cv::approxPolyDP(curve, approx, cv::arcLength(curve, true)*0.02, true);
+            TestQuad(approx, job.quads);
+        }
+    }
+}
+
+/*
+ * 閾値レベルのラベルの参照表を作る
+ *
+ * ラベルは gray >= (l+1)*255/levels となる閾値レベル l (1〜levels-1) の数．
+ */
+void RectangleDetection::BuildLevelLut(void)
+{
+    levelLut.create(1, 256, CV_8UC1);
+    uchar* lut = levelLut.ptr(0);
+    for (int v = 0; v < 256; v++) {
+        int label = 0;
+        for (int l = 1; l < levels; l++) {
+            if (v >= (l+1)*255/levels) label++;
+        }
+        lut[v] = (uchar) std::min(label, 255);
+    }
+    lutLevels = levels;
+}
+
+/*
+ * 2値画像（job.gray）の輪郭から四角形を探す
+ *
+ * @param [in,out] job : 作業領域（見つかった四角形は job.quads に入る）
+ */
+void RectangleDetection::TestContours(RectangleSearchJob& job) const
+{
+    std::vector<std::vector<cv::Point> >& contours = job.contours;
+    std::vector<cv::Point>& approx = job.approx;
+    job.quads.clear();
+
+    // find contours and store them all as a list
+    cv::findContours(job.gray, contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+
+    // test each contour
+    for( size_t i = 0; i < contours.size(); i++ )
+    {
+        // approximate contour with accuracy proportional
+        // to the contour perimeter
+        cv::approxPolyDP(contours[i], approx, cv::arcLength(contours[i], true)*0.02, true);
+
+        TestQuad(approx, job.quads);
+    }
+}
+
+/*
+ * 四角形かどうかの判定
+ *
+ * @param [in] approx  : 多角形近似した輪郭
+ * @param [out] quads  : 四角形であれば追加するリスト
+ */
+void RectangleDetection::TestQuad(const std::vector<cv::Point>& approx,
+				  std::vector<RectangleQuad>& quads) const
+{
+    // square contours should have 4 vertices after approximation
+    // relatively large area (to filter out noisy contours)
+    // and be convex.
+    // Note: absolute value of an area is used because
+    // area may be positive or negative - in accordance with the
+    // contour orientation
+    if( approx.size() == 4 &&
+        fabs(cv::contourArea(approx)) > minArea &&
+        cv::isContourConvex(approx) )
+    {
+        double cosMax = 0;
+
+        for( int j = 2; j < 5; j++ )
+        {
+            // find the maximum cosine of the angle between joint edges
+            double cosine = fabs(angle(approx[j%4], approx[j-2], approx[j-1]));
+            cosMax = MAX(cosMax, cosine);
+        }
+
+        // if cosines of all angles are small
+        // (all angles are ~90 degree) then write quandrange
+        // vertices to resultant sequence
+        if( cosMax < maxCosine )
+        {
+            RectangleQuad quad = {{ approx[0], approx[1], approx[2], approx[3] }};
+            quads.push_back(quad);
+        }
+    }
+}
+
+/*
+ * 四角形の評価値（角の余弦の最大値, 面積）
+ */
+static cv::Vec2d quadScore(const RectangleQuad& quad)
+{
+    double cosMax = 0;
+    for( int j = 2; j < 5; j++ )
+    {
+        double cosine = fabs(angle(quad[j%4], quad[j-2], quad[j-1]));
+        cosMax = MAX(cosMax, cosine);
+    }
+    // 4頂点の多角形の面積（靴紐公式）
+    double area = 0.0;
+    for (int k = 0; k < 4; k++) {
+        const cv::Point& p = quad[k];
+        const cv::Point& q = quad[(k + 1) % 4];
+        area += (double) p.x * q.y - (double) q.x * p.y;
+    }
+    return cv::Vec2d(cosMax, fabs(area) * 0.5);
+}
+
+/*
+ * 2つの四角形の頂点が（向きと始点の違いを除いて）すべて近いかどうか
+ */
+static bool sameQuad(const RectangleQuad& a, const RectangleQuad& b,
+		     double distance)
+{
+    double d2 = distance * distance;
+    for (int dir = 1; dir >= -1; dir -= 2) {
+        for (int r = 0; r < 4; r++) {
+            bool match = true;
+            for (int k = 0; k < 4 && match; k++) {
+                const cv::Point& p = a[k];
+                const cv::Point& q = b[(r + dir * k + 4) % 4];
+                double dx = p.x - q.x, dy = p.y - q.y;
+                match = (dx*dx + dy*dy <= d2);
             }
+            if (match) return true;
+        }
+    }
+    return false;
+}
 
-            // find contours and store them all as a list
-            cv::findContours(gray, contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
-
-            vector<Point> approx;
-
-            // test each contour
-            for( size_t i = 0; i < contours.size(); i++ )
-            {
-                // approximate contour with accuracy proportional
-                // to the contour perimeter
-                cv::approxPolyDP(contours[i], approx, cv::arcLength(contours[i], true)*0.02, true);
-
-                // square contours should have 4 vertices after approximation
-                // relatively large area (to filter out noisy contours)
-                // and be convex.
-                // Note: absolute value of an area is used because
-                // area may be positive or negative - in accordance with the
-                // contour orientation
-                if( approx.size() == 4 &&
-                    cv::fabs(cv::contourArea(approx)) > 1000 &&
-                    cv::isContourConvex(approx) )
-                {
-                    double maxCosine = 0;
-
-                    for( int j = 2; j < 5; j++ )
-                    {
-                        // find the maximum cosine of the angle between joint edges
-                        double cosine = cv::fabs(cv::angle(approx[j%4], approx[j-2], approx[j-1]));
-                        maxCosine = MAX(maxCosine, cosine);
-                    }
+/*
+ * 重複を除きながら四角形を merged に加える
+ *
+ * 重心を mergeDistance 間隔の格子に登録しておき，近傍9セルの四角形とだけ
+ * 頂点を比較する．同じ四角形が見つかった場合は，角の余弦の最大値が小さい方，
+ * 同じなら面積が大きい方を残す．入れ替えた時は新しい重心のセルに登録しなおす
+ * （古い重心のセルのままだと，新しい重心の近くの重複を見落とす）．
+ *
+ * @param [in] quads : 加える四角形
+ */
+void RectangleDetection::MergeQuads(const std::vector<RectangleQuad>& quads)
+{
+    if (!mergeDuplicates) {
+        merged.insert(merged.end(), quads.begin(), quads.end());
+        return;
+    }
+    double cell = std::max(mergeDistance, 1.0);
 
-                    // if cosines of all angles are small
-                    // (all angles are ~90 degree) then write quandrange
-                    // vertices to resultant sequence
-                    if( maxCosine < 0.3 )
-                        squares.push_back(approx);
+    for (size_t i = 0; i < quads.size(); i++) {
+        const RectangleQuad& quad = quads[i];
+        double cx = 0.25 * (quad[0].x + quad[1].x + quad[2].x + quad[3].x);
+        double cy = 0.25 * (quad[0].y + quad[1].y + quad[2].y + quad[3].y);
+        int gx = (int) floor(cx / cell);
+        int gy = (int) floor(cy / cell);
+        cv::Vec2d score = quadScore(quad);
+
+        // 頂点がすべて mergeDistance 以内なら重心も mergeDistance 以内にある
+        int found = -1;
+        for (int dy = -1; dy <= 1 && found < 0; dy++) {
+            for (int dx = -1; dx <= 1 && found < 0; dx++) {
+                int64_t key = ((int64_t) (gx + dx) << 32) | (uint32_t) (gy + dy);
+                std::unordered_map<int64_t, std::vector<int> >::const_iterator it = grid.find(key);
+                if (it == grid.end()) continue;
+                for (size_t k = 0; k < it->second.size(); k++) {
+                    if (sameQuad(merged[it->second[k]], quad, mergeDistance)) {
+                        found = it->second[k];
+                        break;
+                    }
                 }
             }
         }
+
+        if (found < 0) {
+            int64_t key = ((int64_t) gx << 32) | (uint32_t) gy;
+            grid[key].push_back((int) merged.size());
+            merged.push_back(quad);
+            quadScores.push_back(score);
+        } else if (score[0] < quadScores[found][0] ||
+                   (score[0] == quadScores[found][0] && score[1] > quadScores[found][1])) {
+            const RectangleQuad& old = merged[found];
+            double ox = 0.25 * (old[0].x + old[1].x + old[2].x + old[3].x);
+            double oy = 0.25 * (old[0].y + old[1].y + old[2].y + old[3].y);
+            int ogx = (int) floor(ox / cell);
+            int ogy = (int) floor(oy / cell);
+            if (ogx != gx || ogy != gy) {
+                std::vector<int>& oldCell = grid[((int64_t) ogx << 32) | (uint32_t) ogy];
+                oldCell.erase(std::find(oldCell.begin(), oldCell.end(), found));
+                grid[((int64_t) gx << 32) | (uint32_t) gy].push_back(found);
+            }
+            merged[found]      = quad;
+            quadScores[found]  = score;
+        }
     }
-    if (squares.size() > 0) return true;
-    else return false;
+}
+
+/*
+ * 高速モードの四角形の探索
+ *
+ * 白地に黒い正方形のマーカーを想定し，濃淡画像を1回だけ適応的閾値処理
+ * （積分画像による平均）して輪郭を1回だけ抽出する．近似の前に
+ * 外接矩形・面積・凸包との面積比で明らかに四角形でない輪郭を除く．
+ *
+ * @param [in] image : 入力画像
+ */
+void RectangleDetection::SearchFast(const cv::Mat& image)
+{
+    if (image.channels() == 3) {
+        cv::cvtColor(image, fastGray, cv::COLOR_BGR2GRAY);
+    } else {
+        fastGray = image;
+    }
+
+    // 暗い領域を前景にする（ADAPTIVE_THRESH_MEAN_C は積分画像で計算される）
+    int blockSize = adaptiveBlockSize | 1;
+    cv::adaptiveThreshold(fastGray, fastJob.gray, 255,
+			  cv::ADAPTIVE_THRESH_MEAN_C, cv::THRESH_BINARY_INV,
+			  blockSize, adaptiveOffset);
+
+    std::vector<std::vector<cv::Point> >& contours = fastJob.contours;
+    fastJob.quads.clear();
+    cv::findContours(fastJob.gray, contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+
+    for (size_t i = 0; i < contours.size(); i++) {
+        const std::vector<cv::Point>& contour = contours[i];
+        if (contour.size() < 4) continue;
+
+        // 外接矩形が小さいものは面積を計算するまでもない
+        cv::Rect box = cv::boundingRect(contour);
+        if ((double) box.width * box.height <= minArea) continue;
+        double area = fabs(cv::contourArea(contour));
+        if (area <= minArea) continue;
+
+        // 凸包との面積比が小さいもの（凹んだ輪郭）を除く
+        cv::convexHull(contour, hull, false, false);
+        double hullArea = 0.0;
+        for (size_t k = 0, n = hull.size(); k < n; k++) {
+            const cv::Point& p = contour[hull[k]];
+            const cv::Point& q = contour[hull[(k + 1) % n]];
+            hullArea += (double) p.x * q.y - (double) q.x * p.y;
+        }
+        hullArea = fabs(hullArea) * 0.5;
+        if (area < minSolidity * hullArea) continue;
+
+        cv::approxPolyDP(contour, fastJob.approx, cv::arcLength(contour, true)*0.02, true);
+        TestQuad(fastJob.approx, fastJob.quads);
+    }
+    MergeQuads(fastJob.quads);
 }
 
 
-/* ****************************************** End of ellipse_detection.c *** */
+/* **************************************** End of rectangle_detection.c *** */
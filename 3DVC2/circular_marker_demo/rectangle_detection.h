@@ -1,5 +1,5 @@
-/* ************************************************* ellipse_detection.h *** *
- * 楕円検出クラス(ヘッダファイル)
+/* *********************************************** rectangle_detection.h *** *
+ * 矩形検出クラス(ヘッダファイル)
  * ************************************************************************* */
 #pragma once
 
@@ -7,6 +7,28 @@
 #include <Eigen/Dense>
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <stdint.h>
+#include <array>
+#include <vector>
+#include <unordered_map>
+
+// 四角形の4頂点（要素ごとにメモリを確保しないように固定長にする）
+typedef std::array<cv::Point, 4> RectangleQuad;
+
+/*
+ * 1つの色プレーン・閾値レベルの探索に使う作業領域
+ * （スレッドごとに別の領域を使うので排他制御は不要）
+ */
+typedef struct _RectangleSearchJob {
+  cv::Mat gray;                                  // 2値画像
+  cv::Mat labels;                                // 閾値レベルのラベル（縁を 0 で1画素広げる）
+  cv::Mat marks;                                 // 閾値レベルごとの境界追跡の印
+  std::vector<cv::Point> points;                 // 全閾値レベルの輪郭の点
+  std::vector<cv::Vec3i> spans;                  // 輪郭ごとの (閾値レベル, points の先頭, 点の数)
+  std::vector<std::vector<cv::Point> > contours; // 輪郭のリスト
+  std::vector<cv::Point> approx;                 // 多角形近似した輪郭
+  std::vector<RectangleQuad> quads;              // 見つかった四角形
+} RectangleSearchJob;
 
 class RectangleDetection
 {
@@ -14,35 +36,79 @@ class RectangleDetection
  public:
   // コンストラクタ
   RectangleDetection();
+  RectangleDetection(int _levels, int _cannyThreshold);
 
   // デストラクタ
   ~RectangleDetection();
 
-  // 楕円検出
-  bool Detect (cv::Mat& input, std::vector<vector<Point>>& rect_list);
+  // 矩形検出
+  bool Detect (const cv::Mat& input,
+	       std::vector<std::vector<cv::Point> >& rect_list);
 
   // メンバ変数
-  int    minLength;          // エッジ点列の最小点数  
-  double cannyParam[2];      // Cannyオペレータのパラメータ
-  int    gaussianKernelSize; // ガウシアンフィルタのパラメータ
-  double gaussianSigma;
-  double axisRatio;          // 楕円を判定するためのパラメータ
-  double axisLength;
-  double errorThreshold;
-  std::vector<vector<Point>> rect_list; // 検出した楕円のリスト
-  bool drawRectCenter;            // 描画フラグ
+  int    mode;               // 検出モード（MODE_EXHAUSTIVE または MODE_FAST）
+  int    levels;             // 閾値のレベル数（レベル0はCanny）
+  int    cannyThreshold;     // レベル0のCannyオペレータの上側閾値
+  bool   fusedLevels;        // レベル1以降を1回の走査で探索するかどうか（levels が MAX_FUSED_LEVELS 以下の場合）
+  double minArea;            // 四角形の最小面積 [画素^2]
+  double maxCosine;          // 四角形の角の余弦の最大値
+  int    adaptiveBlockSize;  // 高速モードの適応的閾値処理の窓サイズ（奇数）
+  double adaptiveOffset;     // 高速モードの適応的閾値処理のオフセット
+  double minSolidity;        // 高速モードの輪郭面積/凸包面積の最小値
+  bool   mergeDuplicates;    // 同じ四角形の重複を除くかどうか
+  double mergeDistance;      // 同じ四角形とみなす頂点間の距離の最大値 [画素]
+
+  // 作業領域（フレームごとに確保しなおさないようにメンバーとして持つ）
+  cv::Mat pyr, timg;                    // ノイズ除去用の縮小・拡大画像
+  std::vector<cv::Mat> planes;          // 色プレーン
+  std::vector<RectangleSearchJob> jobs; // 色プレーン×閾値レベルの作業領域
+  cv::Mat levelLut;                     // 濃淡値 -> 閾値レベルのラベルの参照表
+  int lutLevels;                        // levelLut を作ったときのレベル数
+  cv::Mat fastGray;                     // 高速モードの濃淡画像
+  RectangleSearchJob fastJob;           // 高速モードの作業領域
+  std::vector<int> hull;                // 高速モードの凸包
+  std::vector<RectangleQuad> merged;    // 重複を除いた四角形
+  std::vector<cv::Vec2d> quadScores;    // merged の各四角形の (角の余弦の最大値, 面積)
+  std::unordered_map<int64_t, std::vector<int> > grid; // 重心の格子 -> merged の番号
 
+  // 検出モード
+  static const int MODE_EXHAUSTIVE = 0; // 全色プレーン×全閾値レベルを探索
+  static const int MODE_FAST       = 1; // 濃淡画像の適応的閾値処理のみ（黒い正方形マーカー用）
+
+  // fusedLevels で扱える閾値のレベル数の最大値（境界追跡の印のビット数で決まる）
+  static const int MAX_FUSED_LEVELS = 17;
 
 
   // デフォルトパラメータ
-  const int    DEFAULT_MIN_LENGTH           = 50;
-  const int    DEFAULT_GAUSSIAN_KERNEL_SIZE = 5;
-  const double DEFAULT_GAUSSIAN_SIGMA       = 1.0;
-  const int    DEFAULT_CANNY_PARAM1         = 50;
-  const int    DEFAULT_CANNY_PARAM2         = 200;
-  const double DEFAULT_AXIS_RATIO           = 0.3;
-  const double DEFAULT_AXIS_LENGTH          = 20.0;
-  const double DEFAULT_ERROR_THRESHOLD      = 1.4;
+  const int    DEFAULT_LEVELS               = 11;
+  const int    DEFAULT_CANNY_THRESHOLD      = 50;
+  const double DEFAULT_MIN_AREA             = 1000.0;
+  const double DEFAULT_MAX_COSINE           = 0.3;
+  const int    DEFAULT_ADAPTIVE_BLOCK_SIZE  = 31;
+  const double DEFAULT_ADAPTIVE_OFFSET      = 7.0;
+  const double DEFAULT_MIN_SOLIDITY         = 0.9;
+  const double DEFAULT_MERGE_DISTANCE       = 8.0;
+
+ private:
+  // 1つの色プレーン・閾値レベルでの四角形の探索
+  void SearchLevel (const cv::Mat& plane, int level, RectangleSearchJob& job);
+  // 1つの色プレーンでの全閾値レベルの四角形の探索
+  void SearchLevels (const cv::Mat& plane, RectangleSearchJob& job);
+  // 閾値レベルのラベルの参照表を作る
+  void BuildLevelLut (void);
+  // 2値画像の輪郭から四角形を探す
+  void TestContours (RectangleSearchJob& job) const;
+  // 全色プレーン×全閾値レベルの四角形の探索
+  void SearchExhaustive (const cv::Mat& input);
+  // 高速モードの四角形の探索
+  void SearchFast (const cv::Mat& input);
+  // 四角形かどうかの判定（四角形なら quads に追加する）
+  void TestQuad (const std::vector<cv::Point>& approx,
+		 std::vector<RectangleQuad>& quads) const;
+  // 重複を除きながら四角形を merged に加える
+  void MergeQuads (const std::vector<RectangleQuad>& quads);
+  // 初期化
+  void Init (int _levels, int _cannyThreshold);
 };
 
-/* ****************************************** End of ellipse_detection.h *** */
+/* **************************************** End of rectangle_detection.h *** */
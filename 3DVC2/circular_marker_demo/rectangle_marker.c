@@ -0,0 +1,208 @@
+/* **************************************************** rectangle_marker.c *** *
+ * 正方形マーカークラス
+ * ************************************************************************* */
+#include "rectangle_marker.h"
+
+/*
+ * コンストラクタ
+ */
+RectangleMarker::RectangleMarker()
+{
+  for (int n = 0; n < 4; n++) x[n] = y[n] = 0;
+  size = 0;
+  id   = -1;
+  H = Eigen::Matrix3d::Identity();
+  R = Eigen::Matrix3d::Identity();
+  T = Eigen::Vector3d::Zero();
+  for (int n = 0; n < 16; n++) M[n] = 0;
+  M[15] = 1;
+}
+
+/*
+ * コンストラクタ
+ *
+ * @param [in] _quad : 四角形の頂点（RectangleDetection の出力）
+ * @param [in] _size : マーカーの一辺の長さ
+ */
+RectangleMarker::RectangleMarker(const std::vector<cv::Point>& _quad,
+				 double _size)
+{
+  cv::Point2d corners[4];
+  for (int n = 0; n < 4; n++) corners[n] = _quad[n];
+  SetCorners(corners);
+  size = _size;
+  id   = -1;
+
+  H = Eigen::Matrix3d::Identity();
+  R = Eigen::Matrix3d::Identity();
+  T = Eigen::Vector3d::Zero();
+  for (int n = 0; n < 16; n++) M[n] = 0;
+  M[15] = 1;
+}
+
+/*
+ * コンストラクタ
+ *
+ * @param [in] _quad : 四角形の頂点（小数精度）
+ * @param [in] _size : マーカーの一辺の長さ
+ */
+RectangleMarker::RectangleMarker(const std::vector<cv::Point2f>& _quad,
+				 double _size)
+{
+  cv::Point2d corners[4];
+  for (int n = 0; n < 4; n++) corners[n] = _quad[n];
+  SetCorners(corners);
+  size = _size;
+  id   = -1;
+
+  H = Eigen::Matrix3d::Identity();
+  R = Eigen::Matrix3d::Identity();
+  T = Eigen::Vector3d::Zero();
+  for (int n = 0; n < 16; n++) M[n] = 0;
+  M[15] = 1;
+}
+
+/*
+ * デストラクタ
+ */
+RectangleMarker::~RectangleMarker() {
+  ;
+}
+
+/*
+ * 頂点を登録する関数
+ *
+ * 頂点 0, 1, 2, 3 をマーカー座標系の (-s/2, -s/2), (s/2, -s/2), (s/2, s/2),
+ * (-s/2, s/2) （X-Z 平面）に対応させるので，画像上で時計回りに並べる．
+ *
+ * @param [in] _corners : 四角形の頂点
+ */
+void RectangleMarker::SetCorners(const cv::Point2d _corners[4])
+{
+  // 画像座標系（y 軸が下向き）での符号付き面積
+  double area = 0;
+  for (int n = 0; n < 4; n++) {
+    const cv::Point2d& p = _corners[n];
+    const cv::Point2d& q = _corners[(n + 1) % 4];
+    area += p.x * q.y - q.x * p.y;
+  }
+  for (int n = 0; n < 4; n++) {
+    int k = (area >= 0) ? n : (4 - n) % 4;
+    x[n] = _corners[k].x;
+    y[n] = _corners[k].y;
+  }
+}
+
+/*
+ * 頂点の始点をずらす関数
+ *
+ * @param [in] k : 新しい頂点 0 にする頂点の番号（新しい頂点 j は元の頂点 j + k）
+ */
+void RectangleMarker::RotateCorners(int k)
+{
+  double x_[4], y_[4];
+  for (int n = 0; n < 4; n++) {
+    x_[n] = x[(n + k) & 3];
+    y_[n] = y[(n + k) & 3];
+  }
+  for (int n = 0; n < 4; n++) {
+    x[n] = x_[n];
+    y[n] = y_[n];
+  }
+}
+
+/*
+ * @brief 4点からホモグラフィを計算する関数（h33 = 1 とした 8x8 の連立方程式）
+ *
+ * @param [in] X, Z : 変換元の座標
+ * @param [in] u, v : 変換先の座標
+ * @param [out] H   : ホモグラフィ
+ *
+ * @retval 解が求まればtrue
+ */
+bool
+ComputeHomography(const double X[4], const double Z[4],
+		  const double u[4], const double v[4],
+		  Eigen::Matrix3d& H) {
+  Eigen::Matrix<double, 8, 8> L;
+  Eigen::Matrix<double, 8, 1> b;
+  for (int n = 0; n < 4; n++) {
+    L.row(2 * n)     << X[n], Z[n], 1, 0, 0, 0, -u[n] * X[n], -u[n] * Z[n];
+    L.row(2 * n + 1) << 0, 0, 0, X[n], Z[n], 1, -v[n] * X[n], -v[n] * Z[n];
+    b(2 * n)     = u[n];
+    b(2 * n + 1) = v[n];
+  }
+  Eigen::FullPivLU<Eigen::Matrix<double, 8, 8> > lu(L);
+  if (!lu.isInvertible()) return false;
+  Eigen::Matrix<double, 8, 1> h = lu.solve(b);
+
+  H << h(0), h(1), h(2),
+       h(3), h(4), h(5),
+       h(6), h(7), 1.0;
+  return true;
+}
+
+/*
+ * @brief カメラの位置姿勢を計算する関数
+ *
+ * マーカー平面（世界座標系の X-Z 平面, Y 軸がカメラ側）から正規化画像座標への
+ * ホモグラフィ H = [r1 r3 t] を求め，回転行列と並進ベクトルに分解する．
+ *
+ * @param [in] Ainv : 座標系の変換行列の逆行列
+ *
+ * @retval 位置姿勢が求まればtrue
+ */
+bool RectangleMarker::ComputeCameraParam(const Eigen::Matrix3d& Ainv) {
+  // 頂点を正規化画像座標に変換
+  double u[4], v[4];
+  for (int n = 0; n < 4; n++) {
+    Eigen::Vector3d m = Ainv * Eigen::Vector3d(x[n], y[n], 1.0);
+    u[n] = m(0) / m(2);
+    v[n] = m(1) / m(2);
+  }
+  double h = size / 2.0;
+  const double X[4] = {-h,  h, h, -h};
+  const double Z[4] = {-h, -h, h,  h};
+  if (!ComputeHomography(X, Z, u, v, H)) return false;
+
+  // スケールを決める（マーカーがカメラの前方にあるように符号を選ぶ）
+  Eigen::Vector3d h1 = H.col(0);
+  Eigen::Vector3d h2 = H.col(1);
+  Eigen::Vector3d h3 = H.col(2);
+  double lambda = 2.0 / (h1.norm() + h2.norm());
+  if (h3(2) < 0) lambda = -lambda;
+
+  // 世界座標系の X 軸，Z 軸，Y 軸（Z 軸と X 軸の外積）
+  Eigen::Vector3d X_ = lambda * h1;
+  Eigen::Vector3d Z_ = lambda * h2;
+  Eigen::Vector3d Y_ = Z_.cross(X_);
+  Eigen::Matrix3d Rm;
+  Rm.col(0) = X_;
+  Rm.col(1) = Y_;
+  Rm.col(2) = Z_;
+
+  // 雑音で直交しない回転行列を最も近い回転行列に直す
+  Eigen::JacobiSVD<Eigen::Matrix3d> svd(Rm, Eigen::ComputeFullU | Eigen::ComputeFullV);
+  R = svd.matrixU() * svd.matrixV().transpose();
+  if (R.determinant() < 0) return false;
+  T = lambda * h3;
+
+  // 座標系の変換行列
+  Eigen::Matrix3d R_ = Eigen::Matrix3d::Zero();
+  R_(0, 1) = 1.0;
+  R_(1, 0) = 1.0;
+  R_(2, 2) = -1.0;
+
+  // 座標系の変換
+  R = R_ * R;
+  T = R_ * T;
+
+  // モデルビュー行列の生成
+  M[0] = R(0, 0); M[1] = R(1, 0); M[2]  = R(2, 0);
+  M[4] = R(0, 1); M[5] = R(1, 1); M[6]  = R(2, 1);
+  M[8] = R(0, 2); M[9] = R(1, 2); M[10] = R(2, 2);
+  M[12] = T(0); M[13] = T(1); M[14] = T(2);
+  return true;
+}
+
+/* ********************************************* End of rectangle_marker.c *** */
@@ -0,0 +1,45 @@
+/* **************************************************** rectangle_marker.h *** *
+ * 正方形マーカークラス(ヘッダファイル)
+ * ************************************************************************* */
+#pragma once
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <Eigen/Dense>
+
+class RectangleMarker
+{
+ public:
+  // コンストラクタ
+  RectangleMarker();
+  RectangleMarker(const std::vector<cv::Point>& _quad, double _size);
+  RectangleMarker(const std::vector<cv::Point2f>& _quad, double _size);
+
+  // デストラクタ
+  ~RectangleMarker();
+
+  // 頂点を登録する関数（画像上で時計回りになるように並べ替える）
+  void SetCorners(const cv::Point2d _corners[4]);
+  // 頂点の始点をずらす関数（ID から決まる向きに合わせる）
+  void RotateCorners(int k);
+
+  // カメラの位置姿勢を計算する関数
+  bool ComputeCameraParam(const Eigen::Matrix3d& Ainv);
+
+  // メンバ変数
+  double x[4];           // 頂点の画像座標(x, y)
+  double y[4];
+  double size;           // マーカーの一辺の長さ
+  int    id;             // マーカーのID（判定していない場合は -1）
+  Eigen::Matrix3d H;     // マーカー平面から正規化画像座標へのホモグラフィ
+  Eigen::Matrix3d R;     // カメラの回転行列
+  Eigen::Vector3d T;     // カメラの併進ベクトル
+  float           M[16]; // モデルビュー行列（OpenGLで使用）
+};
+
+// 4点からホモグラフィを計算する関数 (X[n], Z[n]) -> (u[n], v[n])
+bool ComputeHomography(const double X[4], const double Z[4],
+		       const double u[4], const double v[4],
+		       Eigen::Matrix3d& H);
+
+/* ********************************************* End of rectangle_marker.h *** */
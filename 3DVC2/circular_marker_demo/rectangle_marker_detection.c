@@ -0,0 +1,162 @@
+/* ****************************************** rectangle_marker_detection.c *** *
+ * 正方形マーカーの検出クラス
+ * ************************************************************************* */
+#include "rectangle_marker_detection.h"
+
+/*
+ * コンストラクタ
+ */
+RectangleMarkerDetection::RectangleMarkerDetection() {
+  markerSize = 80.0;
+  drawMarker = false;
+  refineCorners = true;
+  A = Eigen::MatrixXd::Identity(3, 3);
+}
+
+/*
+ * デストラクタ
+ */
+RectangleMarkerDetection::~RectangleMarkerDetection() {
+  ;
+}
+
+/*
+ * 四角形 inner の4頂点がすべて凸四角形 outer の内側（辺上を含む）にあるかどうか
+ */
+static bool InsideQuad (const RectangleMarker& outer, const RectangleMarker& inner)
+{
+  for (int i = 0; i < 4; i++) {
+    int sign = 0;
+    for (int k = 0; k < 4; k++) {
+      int j = (k + 1) % 4;
+      double cross = (outer.x[j] - outer.x[k]) * (inner.y[i] - outer.y[k])
+	- (outer.y[j] - outer.y[k]) * (inner.x[i] - outer.x[k]);
+      int s = (cross > 0.0) - (cross < 0.0);
+      if (s == 0) continue;
+      if (sign == 0) sign = s;
+      else if (s != sign) return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * 正方形マーカーを検出する関数（位置姿勢も計算する）
+ *
+ * ID の辞書が登録されている場合は，辞書にある ID が読めた四角形だけを
+ * マーカーとし，頂点の順番を ID から決まる向きに合わせる．
+ * 辞書がない場合は，枠が黒い四角形のうち，他の四角形の内側にないもの
+ * だけをマーカーとする（マーカーの内側の模様を除くため）．
+ *
+ * @param [in] rect_list    : 四角形のリスト
+ * @param [in] image        : 画像
+ * @param [out] marker_list : マーカーのリスト
+ *
+ * @return マーカーが検出されればtrue, そうでなければfalse
+ */
+bool RectangleMarkerDetection::Detect (const std::vector<std::vector<cv::Point> >& rect_list,
+				       cv::Mat&              image,
+				       std::vector<RectangleMarker>& marker_list)
+{
+  quads.resize(rect_list.size());
+  for (int n = 0; n < (int) rect_list.size(); n++) {
+    quads[n].resize(rect_list[n].size());
+    for (int k = 0; k < (int) rect_list[n].size(); k++) {
+      quads[n][k] = cv::Point2f((float) rect_list[n][k].x, (float) rect_list[n][k].y);
+    }
+  }
+  return Detect(quads, image, marker_list);
+}
+
+/*
+ * 正方形マーカーを検出する関数（頂点が小数精度の場合）
+ *
+ * @param [in] rect_list    : 四角形のリスト
+ * @param [in] image        : 画像
+ * @param [out] marker_list : マーカーのリスト
+ *
+ * @return マーカーが検出されればtrue, そうでなければfalse
+ */
+bool RectangleMarkerDetection::Detect (const std::vector<std::vector<cv::Point2f> >& rect_list,
+				       cv::Mat&              image,
+				       std::vector<RectangleMarker>& marker_list)
+{
+  // リストのクリア
+  marker_list.clear();
+
+  Eigen::Matrix3d Ainv = Eigen::Matrix3d(A).inverse();
+  bool decode = !decoder.Empty();
+  if (image.channels() == 3) cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+  else gray = image;
+
+  candidates.clear();
+  for (int n = 0; n < (int) rect_list.size(); n++) {
+    if (rect_list[n].size() != 4) continue;
+    corners = rect_list[n];
+    if (refineCorners) refiner.Refine(gray, corners);
+    RectangleMarker marker(corners, markerSize);
+    if (decode) {
+      int id, rotation;
+      if (!decoder.Decode(gray, marker.x, marker.y, id, rotation)) continue;
+      marker.id = id;
+      marker.RotateCorners(rotation);
+    } else {
+      if (!decoder.CheckBorder(gray, marker.x, marker.y)) continue;
+    }
+    candidates.push_back(marker);
+  }
+
+  for (int n = 0; n < (int) candidates.size(); n++) {
+    RectangleMarker& marker = candidates[n];
+    if (!decode) {
+      // 4頂点とも他の四角形の内側にあれば，その四角形の内側の模様とみなす
+      // （互いに内側にある同じ四角形は先のものを残す）
+      bool nested = false;
+      for (int m = 0; m < (int) candidates.size() && !nested; m++) {
+	if (m == n) continue;
+	nested = InsideQuad(candidates[m], marker);
+	if (nested && m > n) nested = !InsideQuad(marker, candidates[m]);
+      }
+      if (nested) continue;
+    }
+    if (marker.ComputeCameraParam(Ainv)) {
+      marker_list.push_back(marker);
+    }
+  }
+  if (marker_list.size() == 0) return false;
+  return true;
+}
+
+/*
+ * 検出したマーカーを描画する関数（drawMarker が true の場合）
+ *
+ * 他の方式の検出に描画が混ざらないように，Detect とは分けて
+ * すべての検出が終わってから呼ぶ．
+ *
+ * @param [out] image      : 描画する画像
+ * @param [in] marker_list : マーカーのリスト
+ */
+void RectangleMarkerDetection::Draw (cv::Mat& image,
+				     const std::vector<RectangleMarker>& marker_list) const
+{
+  if (!drawMarker) return;
+  for (int n = 0; n < (int) marker_list.size(); n++) {
+    const RectangleMarker& marker = marker_list[n];
+    for (int k = 0; k < 4; k++) {
+      cv::Point p(cvRound(marker.x[k]), cvRound(marker.y[k]));
+      cv::Point q(cvRound(marker.x[(k + 1) % 4]), cvRound(marker.y[(k + 1) % 4]));
+      cv::line(image, p, q, cv::Scalar(0, 0, 255), 1, 1);
+    }
+    cv::circle(image, cv::Point(cvRound(marker.x[0]), cvRound(marker.y[0])),
+	       5, cv::Scalar(0, 0, 255), 1, 1);
+    if (marker.id >= 0) {
+      char text[32];
+      sprintf(text, "%d", marker.id);
+      cv::putText(image, text,
+		  cv::Point(cvRound(marker.x[0]) + 6, cvRound(marker.y[0]) - 6),
+		  cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 0, 255), 1);
+    }
+  }
+}
+
+/* *********************************** End of rectangle_marker_detection.c *** */
@@ -0,0 +1,46 @@
+/* ****************************************** rectangle_marker_detection.h *** *
+ * 正方形マーカーの検出クラス(ヘッダファイル)
+ * ************************************************************************* */
+#pragma once
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <Eigen/Dense>
+#include "rectangle_marker.h"
+#include "marker_id_decoder.h"
+#include "quad_refinement.h"
+
+class RectangleMarkerDetection
+{
+ public:
+  // コンストラクタ
+  RectangleMarkerDetection ();
+
+  // デストラクタ
+  ~RectangleMarkerDetection ();
+
+  // マーカー検出関数
+  bool Detect(const std::vector<std::vector<cv::Point> >&	rect_list,
+	      cv::Mat& 					image,
+	      std::vector<RectangleMarker>&		marker_list);
+  bool Detect(const std::vector<std::vector<cv::Point2f> >&	rect_list,
+	      cv::Mat& 					image,
+	      std::vector<RectangleMarker>&		marker_list);
+
+  // 検出したマーカーの描画関数
+  void Draw(cv::Mat& image, const std::vector<RectangleMarker>& marker_list) const;
+
+  // メンバ変数
+  Eigen::MatrixXd A;  // 座標系の変換行列
+  double markerSize;  // マーカーの一辺の長さ
+  bool   drawMarker;  // 検出したマーカーを描画するかどうか
+  MarkerIdDecoder decoder; // ID判定クラス（辞書が空ならIDを判定しない）
+  QuadRefinement  refiner; // 頂点のサブピクセル推定クラス
+  bool   refineCorners;    // 頂点をサブピクセル推定するかどうか
+  cv::Mat gray;       // ID判定用の濃淡画像
+  std::vector<std::vector<cv::Point2f> > quads; // 小数精度に変換した四角形
+  std::vector<cv::Point2f> corners;             // サブピクセル推定した頂点
+  std::vector<RectangleMarker> candidates;      // 枠を確認した四角形（辞書がない場合）
+};
+
+/* *********************************** End of rectangle_marker_detection.h *** */
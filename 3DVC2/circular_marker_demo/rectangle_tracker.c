@@ -0,0 +1,134 @@
+/* ************************************************* rectangle_tracker.c *** *
+ * 四角形の追跡クラス
+ * ************************************************************************* */
+#include "rectangle_tracker.h"
+
+/*
+ * コンストラクタ
+ */
+RectangleTracker::RectangleTracker() {
+  redetectInterval  = DEFAULT_REDETECT_INTERVAL;
+  windowSize        = DEFAULT_WINDOW_SIZE;
+  pyramidLevel      = DEFAULT_PYRAMID_LEVEL;
+  maxError          = DEFAULT_MAX_ERROR;
+  redetected        = false;
+  framesSinceDetect = 0;
+}
+
+/*
+ * デストラクタ
+ */
+RectangleTracker::~RectangleTracker() {
+  ;
+}
+
+/*
+ * 追跡のリセット
+ */
+void RectangleTracker::Reset(void) {
+  prevPoints.clear();
+  framesSinceDetect = 0;
+}
+
+/*
+ * 四角形の形のチェック（RectangleDetection と同じ条件）
+ *
+ * @param [in] quad     : 四角形の頂点
+ * @param [in] detector : 条件を持つ検出クラス
+ *
+ * @return 四角形として正しければtrue
+ */
+bool RectangleTracker::CheckQuad(const cv::Point2f* quad,
+				 const RectangleDetection& detector) const {
+  // 凸性（隣り合う辺の外積の符号がすべて同じ）と面積
+  double area = 0.0;
+  int positive = 0, negative = 0;
+  for (int k = 0; k < 4; k++) {
+    const cv::Point2f& p0 = quad[k];
+    const cv::Point2f& p1 = quad[(k + 1) & 3];
+    const cv::Point2f& p2 = quad[(k + 2) & 3];
+    double cross = (double) (p1.x - p0.x) * (p2.y - p1.y)
+      - (double) (p1.y - p0.y) * (p2.x - p1.x);
+    if (cross > 0) positive++;
+    else if (cross < 0) negative++;
+    area += (double) p0.x * p1.y - (double) p1.x * p0.y;
+  }
+  if (positive != 4 && negative != 4) return false;
+  if (fabs(area) * 0.5 <= detector.minArea) return false;
+
+  // 角の余弦
+  for (int k = 0; k < 4; k++) {
+    const cv::Point2f& p0 = quad[k];
+    const cv::Point2f& p1 = quad[(k + 1) & 3];
+    const cv::Point2f& p2 = quad[(k + 3) & 3];
+    double dx1 = p1.x - p0.x, dy1 = p1.y - p0.y;
+    double dx2 = p2.x - p0.x, dy2 = p2.y - p0.y;
+    double cosine = (dx1*dx2 + dy1*dy2)
+      / sqrt((dx1*dx1 + dy1*dy1)*(dx2*dx2 + dy2*dy2) + 1e-10);
+    if (fabs(cosine) >= detector.maxCosine) return false;
+  }
+  return true;
+}
+
+/*
+ * 四角形の追跡
+ *
+ * 前のフレームの四角形の頂点をピラミッド Lucas-Kanade 法で追跡する
+ * （各頂点の周りの小さな窓だけを処理する）．頂点を見失った場合，
+ * 四角形の形が崩れた場合，redetectInterval フレームごと，追跡中の
+ * 四角形がない場合は detector で画像全体から検出しなおす．
+ *
+ * @param [in] image      : 入力画像
+ * @param [in] detector   : 検出しなおすときに使う検出クラス
+ * @param [out] quad_list : 四角形のリスト
+ *
+ * @return 四角形があればtrue, そうでなければfalse
+ */
+bool RectangleTracker::Track(const cv::Mat& image, RectangleDetection& detector,
+			     std::vector<std::vector<cv::Point2f> >& quad_list) {
+  if (image.channels() == 3) cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+  else image.copyTo(gray);
+
+  bool lost = prevPoints.empty() || prevGray.size() != gray.size()
+    || ++framesSinceDetect >= redetectInterval;
+
+  if (!lost) {
+    cv::calcOpticalFlowPyrLK(prevGray, gray, prevPoints, nextPoints,
+			     status, error, cv::Size(windowSize, windowSize),
+			     pyramidLevel,
+			     cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS,
+					      10, 0.03));
+    for (size_t i = 0; i < nextPoints.size() && !lost; i++) {
+      if (!status[i] || error[i] > maxError) lost = true;
+    }
+    for (size_t i = 0; i + 3 < nextPoints.size() && !lost; i += 4) {
+      if (!CheckQuad(&nextPoints[i], detector)) lost = true;
+    }
+  }
+
+  redetected = lost;
+  if (lost) {
+    detector.Detect(image, rect_list);
+    nextPoints.clear();
+    for (size_t n = 0; n < rect_list.size(); n++) {
+      for (int k = 0; k < 4; k++) {
+	nextPoints.push_back(cv::Point2f((float) rect_list[n][k].x,
+					 (float) rect_list[n][k].y));
+      }
+    }
+    framesSinceDetect = 0;
+  }
+
+  quad_list.resize(nextPoints.size() / 4);
+  for (size_t n = 0; n < quad_list.size(); n++) {
+    quad_list[n].assign(nextPoints.begin() + 4 * n, nextPoints.begin() + 4 * n + 4);
+  }
+
+  // 次のフレームのために保存（確保しなおさないように入れ替える）
+  cv::swap(prevGray, gray);
+  prevPoints.swap(nextPoints);
+
+  return !quad_list.empty();
+}
+
+/* ****************************************** End of rectangle_tracker.c *** */
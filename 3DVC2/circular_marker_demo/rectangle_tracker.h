@@ -0,0 +1,52 @@
+/* ************************************************* rectangle_tracker.h *** *
+ * 四角形の追跡クラス(ヘッダファイル)
+ * ************************************************************************* */
+#pragma once
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "rectangle_detection.h"
+
+class RectangleTracker
+{
+ public:
+  // コンストラクタ
+  RectangleTracker();
+
+  // デストラクタ
+  ~RectangleTracker();
+
+  // 四角形の追跡（失敗した場合と一定フレームごとに detector で検出しなおす）
+  bool Track (const cv::Mat& image, RectangleDetection& detector,
+	      std::vector<std::vector<cv::Point2f> >& quad_list);
+
+  // 追跡のリセット（次のフレームで検出しなおす）
+  void Reset (void);
+
+  // メンバ変数
+  int    redetectInterval;   // 検出しなおすまでのフレーム数
+  int    windowSize;         // Lucas-Kanade 法の窓サイズ
+  int    pyramidLevel;       // Lucas-Kanade 法のピラミッドの段数
+  double maxError;           // 追跡の誤差の最大値
+  bool   redetected;         // 直前のフレームで検出しなおしたかどうか
+
+  // デフォルトパラメータ
+  const int    DEFAULT_REDETECT_INTERVAL = 15;
+  const int    DEFAULT_WINDOW_SIZE       = 9;
+  const int    DEFAULT_PYRAMID_LEVEL     = 2;
+  const double DEFAULT_MAX_ERROR         = 20.0;
+
+ private:
+  // 四角形の形のチェック
+  bool CheckQuad (const cv::Point2f* quad, const RectangleDetection& detector) const;
+
+  cv::Mat prevGray, gray;              // 前のフレームと現在のフレームの濃淡画像
+  std::vector<cv::Point2f> prevPoints; // 追跡中の頂点（4点ずつ）
+  std::vector<cv::Point2f> nextPoints;
+  std::vector<unsigned char> status;
+  std::vector<float> error;
+  std::vector<std::vector<cv::Point> > rect_list; // 検出した四角形
+  int framesSinceDetect;               // 最後に検出してからのフレーム数
+};
+
+/* ****************************************** End of rectangle_tracker.h *** */
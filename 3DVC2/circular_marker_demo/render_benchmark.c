@@ -0,0 +1,163 @@
+/* *************************************************** render_benchmark.c *** *
+ * CPU による3次元モデルの描画（合成）の処理時間の計測
+ *
+ * 使い方: render_benchmark [モデル数] [フレーム数] [幅] [高さ] [MQOファイル]
+ *
+ * OpenGL のコンテキストを作らずにモデルを読み込み，SyntheticMarkerSource で
+ * 生成した画像を背景として，格子状に並べたモデルを SoftwareRenderer で
+ * 描く．背景のコピーを含めた1フレームあたりの処理時間を計測し，
+ * 最後に描いた画像を render_benchmark.png に保存する．
+ * ************************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <opencv2/opencv.hpp>
+#include "frame_source.h"
+#include "GLMetaseq.h"
+#include "software_renderer.h"
+
+// 用意する画像と姿勢の数（計測中はこれを繰り返し使う）
+#define NUM_SOURCE_FRAMES 64
+// 計測前に空回しするフレーム数
+#define NUM_WARMUP_FRAMES 10
+// 視錐台（settings.txt の焦点距離と Application の係数に合わせる）
+#define FOCUS       700.0
+#define PROJ_SCALE  0.005
+#define FAR_SCALE   1.0e+6
+
+/*
+ * 1つの描画方法の計測結果を表示する
+ */
+static void PrintResult(const char* name, int64_t ticks, int frames, size_t triangles)
+{
+  double ms = 1000.0 * (double) ticks / cv::getTickFrequency() / frames;
+  printf("%-12s %8.3f ms/frame %8.1f fps %9.0f triangles/frame\n",
+	 name, ms, 1000.0 / ms, (double) triangles / frames);
+}
+
+/*
+ * 格子状に並べたモデルのモデルビュー行列（列優先）を作る
+ * （フレームごとに縦軸まわりに回す）
+ */
+static void MakePoses(MQO_MODEL model, int count, int frame, double horiz, double vert,
+		      double nearDist, std::vector<float>& matrices)
+{
+  int cols = (int) ceil(sqrt((double) count));
+  int rows = (count + cols - 1) / cols;
+  double cell = 2.2 * model->bounds.radius;
+  // 格子全体が視野に入る距離
+  double dist = std::max(cols * cell * nearDist / (2.0 * horiz),
+			 rows * cell * nearDist / (2.0 * vert));
+  const float* c = model->bounds.center;
+
+  matrices.resize(16 * count);
+  for (int i = 0; i < count; i++) {
+    double x = ((i % cols) - (cols - 1) * 0.5) * cell;
+    double y = ((rows - 1) * 0.5 - (i / cols)) * cell;
+    double angle = 0.05 * frame + 0.7 * i;
+    float cs = (float) cos(angle), sn = (float) sin(angle);
+    float* M = &matrices[16 * i];
+    // M = T(x, y, -dist) * Ry(angle) * T(-center)
+    M[0] = cs;   M[4] = 0.0f; M[8]  = sn;   M[12] = 0.0f;
+    M[1] = 0.0f; M[5] = 1.0f; M[9]  = 0.0f; M[13] = 0.0f;
+    M[2] = -sn;  M[6] = 0.0f; M[10] = cs;   M[14] = 0.0f;
+    M[3] = 0.0f; M[7] = 0.0f; M[11] = 0.0f; M[15] = 1.0f;
+    for (int k = 0; k < 3; k++) {
+      M[12 + k] = -(M[k] * c[0] + M[4 + k] * c[1] + M[8 + k] * c[2]);
+    }
+    M[12] += (float) x;
+    M[13] += (float) y;
+    M[14] -= (float) dist;
+  }
+}
+
+/*
+ * 描画器の計測
+ */
+static void BenchmarkRender(const char* name, SoftwareRenderer& renderer, MQO_MODEL model,
+			    const std::vector<cv::Mat>& images,
+			    const std::vector<std::vector<float> >& poses,
+			    int count, int frames, cv::Mat& frame)
+{
+  for (int i = 0; i < NUM_WARMUP_FRAMES; i++) {
+    images[i % images.size()].copyTo(frame);
+    renderer.Render(model, poses[i % poses.size()].data(), count, frame);
+  }
+
+  size_t triangles = 0;
+  int64_t start = cv::getTickCount();
+  for (int i = 0; i < frames; i++) {
+    images[i % images.size()].copyTo(frame);
+    renderer.Render(model, poses[i % poses.size()].data(), count, frame);
+    triangles += renderer.triangleCount;
+  }
+  PrintResult(name, cv::getTickCount() - start, frames, triangles);
+}
+
+int main(int argc, char** argv)
+{
+  int count  = (argc > 1) ? atoi(argv[1]) : 4;
+  int frames = (argc > 2) ? atoi(argv[2]) : 300;
+  int width  = (argc > 3) ? atoi(argv[3]) : 640;
+  int height = (argc > 4) ? atoi(argv[4]) : 480;
+  char* filename = (argc > 5) ? argv[5] : (char*) "./mqo/ninja/ninja_motion_katana.mqo";
+  int channels;
+  if (count < 1) count = 1;
+  if (frames < 1) frames = 1;
+
+  SyntheticMarkerSource source;
+  if (!source.Open(width, height, channels)) {
+    fprintf(stderr, "Cannot open synthetic source\n");
+    return 1;
+  }
+  std::vector<cv::Mat> images(NUM_SOURCE_FRAMES);
+  for (size_t i = 0; i < images.size(); i++) {
+    source.Grab(images[i]);
+  }
+  source.Close();
+
+  // GL のコンテキストなしで初期化するとテクスチャの画像が残る
+  mqoInit();
+  mqoSetLoadReport(1);
+  MQO_MODEL model = mqoCreateModel(filename, 0.3);
+  if (model == NULL) {
+    fprintf(stderr, "Cannot open model: %s\n", filename);
+    return 1;
+  }
+
+  double horiz    = (width  / 2.0) * PROJ_SCALE;
+  double vert     = (height / 2.0) * PROJ_SCALE;
+  double nearDist = FOCUS * PROJ_SCALE;
+  SoftwareRenderer renderer;
+  renderer.SetFrustum(-horiz, horiz, -vert, vert, nearDist, nearDist * FAR_SCALE);
+
+  std::vector<std::vector<float> > poses(NUM_SOURCE_FRAMES);
+  for (size_t i = 0; i < poses.size(); i++) {
+    MakePoses(model, count, (int) i, horiz, vert, nearDist, poses[i]);
+  }
+
+  printf("%dx%d, %d models, %d frames, %d threads\n",
+	 width, height, count, frames, cv::getNumThreads());
+
+  cv::Mat frame;
+  renderer.tileSize = 64;
+  BenchmarkRender("unlit", renderer, model, images, poses, count, frames, frame);
+
+  renderer.tileSize = 32;
+  BenchmarkRender("unlit/32", renderer, model, images, poses, count, frames, frame);
+
+  renderer.tileSize = 64;
+  renderer.lighting = true;
+  BenchmarkRender("lit", renderer, model, images, poses, count, frames, frame);
+
+  cv::imwrite("render_benchmark.png", frame);
+
+  mqoDeleteModel(model);
+  mqoCleanup();
+  return 0;
+}
+
+/* ******************************************** End of render_benchmark.c *** */
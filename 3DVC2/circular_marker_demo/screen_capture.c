@@ -0,0 +1,196 @@
+/*!
+ * @file	screen_capture.c
+ * @brief	画面の保存クラス
+ */
+#include "screen_capture.h"
+#include <stdio.h>
+#include <string.h>
+
+/*!
+ * @brief  コンストラクタ
+ */
+ScreenCapture::ScreenCapture ()
+{
+  prefix     = "output";
+  count      = 0;
+  continuous = false;
+  usePBO     = false;
+  pbo[0]     = pbo[1] = 0;
+  index      = 0;
+  pboWidth   = pboHeight = 0;
+  requested  = false;
+  pending    = false;
+  pendingWidth = pendingHeight = 0;
+}
+
+/*!
+ * @brief  デストラクタ
+ */
+ScreenCapture::~ScreenCapture ()
+{
+  writer.Stop ();
+}
+
+/*!
+ * @brief  初期化
+ *
+ * @retval  True or False
+ */
+bool ScreenCapture::Init (void)
+{
+  // ピクセルバッファオブジェクトは OpenGL 2.1 以降または拡張機能で使える
+  int major = 0, minor = 0;
+  const char *version    = (const char *) glGetString (GL_VERSION);
+  const char *extensions = (const char *) glGetString (GL_EXTENSIONS);
+  if (version != NULL) sscanf (version, "%d.%d", &major, &minor);
+  usePBO = (major > 2 || (major == 2 && minor >= 1)) ||
+    (extensions != NULL && strstr (extensions, "GL_ARB_pixel_buffer_object") != NULL);
+  if (usePBO) {
+    glGenBuffers (2, pbo);
+  }
+
+  writer.capacity = 4;
+  writer.policy   = AsyncFrameWriter::POLICY_DROP_OLDEST;
+  return writer.Start ([this] (const cv::Mat &img, int64_t,
+			       const std::string &name) {
+			 // 連続保存に追いつくように圧縮率より速度を優先する
+			 std::vector<int> params;
+			 params.push_back (cv::IMWRITE_PNG_COMPRESSION);
+			 params.push_back (1);
+			 cv::flip (img, flipped, 0);
+			 cv::imwrite (name, flipped, params);
+		       });
+}
+
+/*!
+ * @brief  終了（読み出し中の画面と保存待ちの画像はすべて保存する）
+ */
+void ScreenCapture::Release (void)
+{
+  Retrieve ();
+  writer.Stop ();
+  if (usePBO && pbo[0] != 0) {
+    glDeleteBuffers (2, pbo);
+    pbo[0] = pbo[1] = 0;
+  }
+  pboWidth = pboHeight = 0;
+}
+
+/*!
+ * @brief  次のフレームを保存する
+ */
+void ScreenCapture::Request (void)
+{
+  requested = true;
+}
+
+/*!
+ * @brief  毎フレームの保存の開始と終了
+ *
+ * @param[in] flag  true で開始，false で終了
+ */
+void ScreenCapture::SetContinuous (bool flag)
+{
+  if (continuous && !flag) {
+    fprintf (stderr, "Saved %llu frames, dropped %llu frames\n",
+	     (unsigned long long) writer.encodedFrames,
+	     (unsigned long long) writer.droppedFrames);
+  }
+  continuous = flag;
+}
+
+/*!
+ * @brief  フレームの描画後（バッファの入れ替え前）に呼び出す
+ *
+ * 前のフレームで読み出しを始めたバッファを保存スレッドに渡し，
+ * 保存の要求があれば今のフレームの読み出しを始める．
+ *
+ * @param[in] window  保存するウィンドウ
+ */
+void ScreenCapture::Update (GLFWwindow *window)
+{
+  Retrieve ();
+
+  if (!requested && !continuous) return;
+  requested = false;
+
+  // ウィンドウの実際のサイズ（高解像度ディスプレイではウィンドウサイズと異なる）
+  int width, height;
+  glfwGetFramebufferSize (window, &width, &height);
+  if (width <= 0 || height <= 0) return;
+  ReadBack (width, height);
+}
+
+/*!
+ * @brief  画面の読み出しを始める
+ *
+ * @param[in] width   画面の幅
+ * @param[in] height  画面の高さ
+ */
+void ScreenCapture::ReadBack (int width, int height)
+{
+  glReadBuffer (GL_BACK);
+  glPixelStorei (GL_PACK_ALIGNMENT, 4);
+
+  if (!usePBO) {
+    // ピクセルバッファオブジェクトが使えない場合は同期して読み出す
+    image.create (height, width, CV_8UC4);
+    glReadPixels (0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, image.data);
+    writer.Push (image, 0, NextName ());
+    return;
+  }
+
+  glBindBuffer (GL_PIXEL_PACK_BUFFER, pbo[index]);
+  if (width != pboWidth || height != pboHeight) {
+    // 画面サイズが変わったら両方のバッファを確保しなおす
+    for (int i = 0; i < 2; i++) {
+      glBindBuffer (GL_PIXEL_PACK_BUFFER, pbo[i]);
+      glBufferData (GL_PIXEL_PACK_BUFFER, (GLsizeiptr) width * height * 4,
+		    NULL, GL_STREAM_READ);
+    }
+    glBindBuffer (GL_PIXEL_PACK_BUFFER, pbo[index]);
+    pboWidth  = width;
+    pboHeight = height;
+  }
+  // バッファへの読み出しはすぐに戻る（転送は GPU が非同期に行う）
+  glReadPixels (0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, 0);
+  glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+
+  pending       = true;
+  pendingWidth  = width;
+  pendingHeight = height;
+  pendingName   = NextName ();
+  index = 1 - index;
+}
+
+/*!
+ * @brief  前のフレームで読み出したバッファを保存スレッドに渡す
+ */
+void ScreenCapture::Retrieve (void)
+{
+  if (!pending) return;
+  pending = false;
+
+  int last = 1 - index;
+  glBindBuffer (GL_PIXEL_PACK_BUFFER, pbo[last]);
+  void *pixels = glMapBuffer (GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+  if (pixels != NULL) {
+    // Push はプールしたバッファにコピーするので，すぐにアンマップできる
+    cv::Mat mapped (pendingHeight, pendingWidth, CV_8UC4, pixels);
+    writer.Push (mapped, 0, pendingName);
+    glUnmapBuffer (GL_PIXEL_PACK_BUFFER);
+  } else {
+    fprintf (stderr, "Cannot map pixel buffer\n");
+  }
+  glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+}
+
+/*!
+ * @brief  次の出力ファイル名
+ */
+std::string ScreenCapture::NextName (void)
+{
+  char name[1024];
+  sprintf (name, "%s-%03d.png", prefix.c_str (), count++);
+  return std::string (name);
+}
@@ -0,0 +1,64 @@
+/*!
+ * @file	screen_capture.h
+ * @brief	画面の保存クラス
+ */
+#pragma once
+
+#include <string>
+#include <opencv2/opencv.hpp>
+#include <GLFW/glfw3.h>
+#include <GL/glext.h>
+#include "async_frame_writer.h"
+
+/*!
+ * @class  画面の保存クラス
+ * @brief　2つのピクセルバッファオブジェクトを交互に使って読み出しを
+ *         1フレーム遅らせ，GPU の完了待ちをなくす．上下反転と PNG への
+ *         エンコードは AsyncFrameWriter のスレッドで行う．
+ */
+class ScreenCapture
+{
+ public:
+  // コンストラクタ
+  ScreenCapture ();
+
+  // デストラクタ
+  ~ScreenCapture ();
+
+  // 初期化と終了（GL のコンテキストを作成した後に呼び出す）
+  bool Init (void);
+  void Release (void);
+
+  // 次のフレームを保存する
+  void Request (void);
+
+  // 毎フレームの保存の開始と終了
+  void SetContinuous (bool flag);
+
+  // フレームの描画後（バッファの入れ替え前）に呼び出す
+  void Update (GLFWwindow *window);
+
+  // メンバー
+  std::string      prefix;     // 出力ファイル名の接頭辞
+  int              count;      // 次の出力ファイル番号
+  bool             continuous; // 毎フレーム保存するかどうか
+  AsyncFrameWriter writer;     // 保存スレッド
+
+ private:
+  void ReadBack (int width, int height);
+  void Retrieve (void);
+  std::string NextName (void);
+
+  bool        usePBO;          // ピクセルバッファオブジェクトが使えるかどうか
+  GLuint      pbo[2];          // 読み出し先のバッファ
+  int         index;           // 次に読み出すバッファ
+  int         pboWidth;        // バッファを確保したときの画面サイズ
+  int         pboHeight;
+  bool        requested;       // 保存の要求があるかどうか
+  bool        pending;         // 読み出し中のバッファがあるかどうか
+  int         pendingWidth;    // 読み出し中の画面サイズ
+  int         pendingHeight;
+  std::string pendingName;     // 読み出し中の画面の出力ファイル名
+  cv::Mat     image;           // PBO が使えない場合の読み出し先
+  cv::Mat     flipped;         // 上下反転した画像（保存スレッドのみが使う）
+};
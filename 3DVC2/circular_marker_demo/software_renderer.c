@@ -0,0 +1,454 @@
+/*!
+ * @file	software_renderer.c
+ * @brief	Metasequoia モデルの CPU による描画クラス
+ */
+#include "software_renderer.h"
+#include <math.h>
+#include <algorithm>
+
+// 頂点の座標を丸める細かさ（GL と同じく画素の 1/16）
+#define SUBPIXEL_SCALE 16.0f
+
+/*!
+ * @brief  半精度浮動小数点数を単精度に戻す
+ */
+static float HalfToFloat (GLushort h)
+{
+  int e = (h >> 10) & 0x1f;
+  int m = h & 0x3ff;
+  float f;
+  if (e == 0) {
+    f = ldexpf ((float) m, -24);
+  } else if (e == 31) {
+    f = (m != 0) ? NAN : INFINITY;
+  } else {
+    f = ldexpf ((float) (m | 0x400), e - 25);
+  }
+  return (h & 0x8000) ? -f : f;
+}
+
+/*!
+ * @brief  頂点配列から座標・法線・UV を取り出す（量子化した配列も元に戻す）
+ */
+static void DecodeVertex (const MQO_MATERIAL *mat, int i, float p[3], float n[3], float uv[2])
+{
+  uv[0] = uv[1] = 0.0f;
+  if (mat->isPacked) {
+    const GLshort *q;
+    const GLbyte  *b;
+    if (mat->isUseTexture) {
+      const VERTEX_TEXUSE_PACKED *v = (const VERTEX_TEXUSE_PACKED *) mat->vertex_q + i;
+      q = v->point;
+      b = v->normal;
+      uv[0] = HalfToFloat (v->uv[0]);
+      uv[1] = HalfToFloat (v->uv[1]);
+    } else {
+      const VERTEX_NOTEX_PACKED *v = (const VERTEX_NOTEX_PACKED *) mat->vertex_q + i;
+      q = v->point;
+      b = v->normal;
+    }
+    // 法線は拡大率を掛けて保存してあるので割り戻す（正規化は呼び出し側）
+    for (int k = 0; k < 3; k++) {
+      p[k] = mat->qcenter[k] + mat->qscale[k] * q[k];
+      n[k] = b[k] / 127.0f / mat->qscale[k];
+    }
+  } else if (mat->isUseTexture) {
+    const VERTEX_TEXUSE *v = mat->vertex_t + i;
+    for (int k = 0; k < 3; k++) {
+      p[k] = v->point[k];
+      n[k] = v->normal[k];
+    }
+    uv[0] = v->uv[0];
+    uv[1] = v->uv[1];
+  } else {
+    const VERTEX_NOTEX *v = mat->vertex_p + i;
+    for (int k = 0; k < 3; k++) {
+      p[k] = v->point[k];
+      n[k] = v->normal[k];
+    }
+  }
+}
+
+/*!
+ * @brief  テクスチャの双線形補間（GL_LINEAR, GL_REPEAT と同じ）
+ *
+ * @param[in]  image  画像（RGBA，1行目が t=0）
+ * @param[in]  size   一辺の大きさ（2のべき乗）
+ * @param[out] rgba   色 [0, 1]
+ */
+static void SampleTexture (const GLubyte *image, int size, float u, float v, float rgba[4])
+{
+  float fu = u * size - 0.5f;
+  float fv = v * size - 0.5f;
+  float bu = floorf (fu);
+  float bv = floorf (fv);
+  float au = fu - bu;
+  float av = fv - bv;
+  int mask = size - 1;
+  int u0 = (int) bu & mask, u1 = (u0 + 1) & mask;
+  int v0 = (int) bv & mask, v1 = (v0 + 1) & mask;
+  const GLubyte *p00 = image + 4 * (v0 * size + u0);
+  const GLubyte *p01 = image + 4 * (v0 * size + u1);
+  const GLubyte *p10 = image + 4 * (v1 * size + u0);
+  const GLubyte *p11 = image + 4 * (v1 * size + u1);
+  for (int k = 0; k < 4; k++) {
+    float top    = p00[k] + (p01[k] - p00[k]) * au;
+    float bottom = p10[k] + (p11[k] - p10[k]) * au;
+    rgba[k] = (top + (bottom - top) * av) * (1.0f / 255.0f);
+  }
+}
+
+/*!
+ * @brief  3頂点の値から画面上の1次式（原点の値, x 方向, y 方向）を作る
+ */
+static void MakePlane (float a0, float a1, float a2, float dx1, float dy1,
+		       float dx2, float dy2, float invArea, float plane[3])
+{
+  plane[0] = a0;
+  plane[1] = ((a1 - a0) * dy2 - (a2 - a0) * dy1) * invArea;
+  plane[2] = ((a2 - a0) * dx1 - (a1 - a0) * dx2) * invArea;
+}
+
+/*!
+ * @brief  コンストラクタ
+ */
+SoftwareRenderer::SoftwareRenderer ()
+{
+  tileSize = 64;
+  lighting = false;
+  light[0] = 0.0f;
+  light[1] = 0.0f;
+  light[2] = 1.0f;
+  ambient  = 0.3f;
+  triangleCount = 0;
+  for (int i = 0; i < 6; i++) frustum[i] = 0.0;
+  width  = height = 0;
+  tilesX = tilesY = 0;
+}
+
+/*!
+ * @brief  視錐台の設定
+ *
+ * GL の描画と同じく，モデル全体が視錐台の外に出る行列は描かない．
+ *
+ * @param[in] left, right, bottom, top, nearDist, farDist  glFrustum と同じ
+ */
+void SoftwareRenderer::SetFrustum (double left, double right, double bottom, double top,
+				   double nearDist, double farDist)
+{
+  frustum[0] = left;
+  frustum[1] = right;
+  frustum[2] = bottom;
+  frustum[3] = top;
+  frustum[4] = nearDist;
+  frustum[5] = farDist;
+  mqoSetFrustum (left, right, bottom, top, nearDist, farDist);
+}
+
+/*!
+ * @brief  材質の頂点配列を画面座標に変換する
+ *
+ * @param[in]  mat       材質
+ * @param[in]  M         モデルビュー行列（列優先）
+ * @param[out] vertices  変換した頂点（頂点配列と同じ順）
+ */
+void SoftwareRenderer::Transform (const MQO_MATERIAL *mat, const float *M,
+				  std::vector<Vertex> &vertices) const
+{
+  // glFrustum の射影行列の0でない要素
+  const double l = frustum[0], r = frustum[1], b = frustum[2], t = frustum[3];
+  const double n = frustum[4], f = frustum[5];
+  const float p00 = (float) (2.0 * n / (r - l)), p02 = (float) ((r + l) / (r - l));
+  const float p11 = (float) (2.0 * n / (t - b)), p12 = (float) ((t + b) / (t - b));
+  const float p22 = (float) (-(f + n) / (f - n)), p23 = (float) (-2.0 * f * n / (f - n));
+  const float nearDist = (float) n;
+
+  vertices.resize (mat->vertnum);
+  for (int i = 0; i < mat->vertnum; i++) {
+    float p[3], nrm[3], uv[2];
+    DecodeVertex (mat, i, p, nrm, uv);
+    float ex = M[0] * p[0] + M[4] * p[1] + M[8]  * p[2] + M[12];
+    float ey = M[1] * p[0] + M[5] * p[1] + M[9]  * p[2] + M[13];
+    float ez = M[2] * p[0] + M[6] * p[1] + M[10] * p[2] + M[14];
+
+    Vertex &o = vertices[i];
+    float w = -ez;
+    o.clipped = !(w >= nearDist);
+    if (o.clipped) continue;
+
+    float invw = 1.0f / w;
+    float xn = (p00 * ex + p02 * ez) * invw;
+    float yn = (p11 * ey + p12 * ez) * invw;
+    float zn = (p22 * ez + p23) * invw;
+    o.x = (xn + 1.0f) * 0.5f * width;
+    o.y = (1.0f - yn) * 0.5f * height;
+    o.z = (zn + 1.0f) * 0.5f;
+    o.invw = invw;
+    o.u = uv[0];
+    o.v = uv[1];
+    o.shade = 1.0f;
+
+    if (lighting) {
+      // 面の向きによらず光が当たる側として扱う（GL の描画は裏面も描く）
+      float nx = M[0] * nrm[0] + M[4] * nrm[1] + M[8]  * nrm[2];
+      float ny = M[1] * nrm[0] + M[5] * nrm[1] + M[9]  * nrm[2];
+      float nz = M[2] * nrm[0] + M[6] * nrm[1] + M[10] * nrm[2];
+      float len = sqrtf (nx * nx + ny * ny + nz * nz);
+      float d = (len > 0.0f) ? fabsf (nx * light[0] + ny * light[1] + nz * light[2]) / len : 1.0f;
+      o.shade = ambient + (1.0f - ambient) * std::min (d, 1.0f);
+    }
+  }
+}
+
+/*!
+ * @brief  三角形の辺関数と補間する値の平面を作る
+ *
+ * 頂点の座標は画素の 1/16 に丸める．隣り合う三角形が共有する辺は
+ * 同じ端点を基準に計算するので，辺関数の値は符号だけが逆になり，
+ * 辺上の画素は上辺・左辺の規則でどちらか一方だけが塗る．
+ *
+ * @return  塗る画素がある時は true
+ */
+bool SoftwareRenderer::Setup (const Vertex &a, const Vertex &b, const Vertex &c, int material,
+			      Triangle &tri) const
+{
+  // 前方クリップ面をまたぐ三角形は切らずに捨てる
+  if (a.clipped || b.clipped || c.clipped) return false;
+
+  const Vertex *v[3] = { &a, &b, &c };
+  float x[3], y[3];
+  for (int k = 0; k < 3; k++) {
+    x[k] = roundf (v[k]->x * SUBPIXEL_SCALE) / SUBPIXEL_SCALE;
+    y[k] = roundf (v[k]->y * SUBPIXEL_SCALE) / SUBPIXEL_SCALE;
+  }
+  float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+  if (!(fabsf (area) > 0.0f) || !std::isfinite (area)) return false;
+  if (area < 0.0f) {
+    // 裏面も描くので，頂点の並びを入れ替えて内側を正にする
+    std::swap (v[1], v[2]);
+    std::swap (x[1], x[2]);
+    std::swap (y[1], y[2]);
+    area = -area;
+  }
+
+  // 画素の中心 (i + 0.5) が入りうる範囲
+  float minx = std::min (x[0], std::min (x[1], x[2]));
+  float maxx = std::max (x[0], std::max (x[1], x[2]));
+  float miny = std::min (y[0], std::min (y[1], y[2]));
+  float maxy = std::max (y[0], std::max (y[1], y[2]));
+  if (maxx < 0.0f || maxy < 0.0f || minx > width || miny > height) return false;
+  tri.minX = std::max ((int) ceilf (minx - 0.5f), 0);
+  tri.maxX = std::min ((int) floorf (maxx - 0.5f), width - 1);
+  tri.minY = std::max ((int) ceilf (miny - 0.5f), 0);
+  tri.maxY = std::min ((int) floorf (maxy - 0.5f), height - 1);
+  if (tri.minX > tri.maxX || tri.minY > tri.maxY) return false;
+
+  for (int k = 0; k < 3; k++) {
+    int i = k, j = (k + 1) % 3;
+    tri.ex[k] = y[i] - y[j];
+    tri.ey[k] = x[j] - x[i];
+    // 端点のうち小さい方を基準にする
+    int s = (x[i] < x[j] || (x[i] == x[j] && y[i] < y[j])) ? i : j;
+    tri.e0[k] = -(tri.ex[k] * x[s] + tri.ey[k] * y[s]);
+    tri.topLeft[k] = (tri.ex[k] > 0.0f || (tri.ex[k] == 0.0f && tri.ey[k] > 0.0f)) ? 1 : 0;
+  }
+
+  float dx1 = x[1] - x[0], dy1 = y[1] - y[0];
+  float dx2 = x[2] - x[0], dy2 = y[2] - y[0];
+  float invArea = 1.0f / area;
+  tri.ox = x[0];
+  tri.oy = y[0];
+  MakePlane (v[0]->z, v[1]->z, v[2]->z, dx1, dy1, dx2, dy2, invArea, tri.z);
+  MakePlane (v[0]->invw, v[1]->invw, v[2]->invw, dx1, dy1, dx2, dy2, invArea, tri.invw);
+  MakePlane (v[0]->u * v[0]->invw, v[1]->u * v[1]->invw, v[2]->u * v[2]->invw,
+	     dx1, dy1, dx2, dy2, invArea, tri.uw);
+  MakePlane (v[0]->v * v[0]->invw, v[1]->v * v[1]->invw, v[2]->v * v[2]->invw,
+	     dx1, dy1, dx2, dy2, invArea, tri.vw);
+  MakePlane (v[0]->shade * v[0]->invw, v[1]->shade * v[1]->invw, v[2]->shade * v[2]->invw,
+	     dx1, dy1, dx2, dy2, invArea, tri.sw);
+  tri.material = material;
+  return true;
+}
+
+/*!
+ * @brief  1つのタイルに振り分けた三角形を描画順に塗る
+ *
+ * @param[in]     tile   タイル番号
+ * @param[in,out] image  描画先（CV_8UC3）
+ */
+void SoftwareRenderer::RasterizeTile (int tile, cv::Mat &image)
+{
+  const int X0 = (tile % tilesX) * tileSize;
+  const int Y0 = (tile / tilesX) * tileSize;
+  const int X1 = std::min (X0 + tileSize, width)  - 1;
+  const int Y1 = std::min (Y0 + tileSize, height) - 1;
+  std::vector<float> zbuf (tileSize);
+  std::vector<unsigned char> covered (tileSize);
+  float *zb = zbuf.data ();
+  unsigned char *cov = covered.data ();
+
+  const std::vector<const Triangle *> &bin = bins[tile];
+  for (size_t k = 0; k < bin.size (); k++) {
+    const Triangle &t = *bin[k];
+    const Material &m = materials[t.material];
+    const int xs = std::max (t.minX, X0), xe = std::min (t.maxX, X1);
+    const int ys = std::max (t.minY, Y0), ye = std::min (t.maxY, Y1);
+    const int n = xe - xs + 1;
+    if (n <= 0) continue;
+
+    const float ex0 = t.ex[0], ex1 = t.ex[1], ex2 = t.ex[2];
+    const int   tl0 = t.topLeft[0], tl1 = t.topLeft[1], tl2 = t.topLeft[2];
+    const float zx  = t.z[1];
+
+    for (int y = ys; y <= ye; y++) {
+      const float py = y + 0.5f;
+      const float b0 = t.ey[0] * py + t.e0[0];
+      const float b1 = t.ey[1] * py + t.e0[1];
+      const float b2 = t.ey[2] * py + t.e0[2];
+      const float zr = t.z[0] + t.z[2] * (py - t.oy);
+      float *drow = depth.ptr<float> (y) + xs;
+
+      // 辺関数と深度の判定（分岐なし）
+      int any = 0;
+#pragma omp simd reduction(|:any)
+      for (int i = 0; i < n; i++) {
+	float px = (float) (xs + i) + 0.5f;
+	float e0 = ex0 * px + b0;
+	float e1 = ex1 * px + b1;
+	float e2 = ex2 * px + b2;
+	float z  = zr + zx * (px - t.ox);
+	int in = ((e0 > 0.0f) | ((e0 == 0.0f) & tl0)) &
+	  ((e1 > 0.0f) | ((e1 == 0.0f) & tl1)) &
+	  ((e2 > 0.0f) | ((e2 == 0.0f) & tl2)) & (z < drow[i]);
+	cov[i] = (unsigned char) in;
+	zb[i]  = z;
+	any |= in;
+      }
+      if (!any) continue;
+
+      // 覆われた画素の色（材質の色×テクスチャ×照明）と半透明合成
+      unsigned char *crow = image.ptr<unsigned char> (y) + 3 * xs;
+      const float dy = py - t.oy;
+      for (int i = 0; i < n; i++) {
+	if (!cov[i]) continue;
+	const float dx = (float) (xs + i) + 0.5f - t.ox;
+	const float w  = 1.0f / (t.invw[0] + t.invw[1] * dx + t.invw[2] * dy);
+	const float s  = (t.sw[0] + t.sw[1] * dx + t.sw[2] * dy) * w;
+	float rgba[4] = { m.color[0], m.color[1], m.color[2], m.color[3] };
+	if (m.texture != NULL) {
+	  float texel[4];
+	  SampleTexture (m.texture, m.texSize,
+			 (t.uw[0] + t.uw[1] * dx + t.uw[2] * dy) * w,
+			 (t.vw[0] + t.vw[1] * dx + t.vw[2] * dy) * w, texel);
+	  for (int c = 0; c < 4; c++) rgba[c] *= texel[c];
+	}
+	const float alpha = std::min (std::max (rgba[3], 0.0f), 1.0f);
+	const float src = 255.0f * alpha * std::min (std::max (s, 0.0f), 1.0f);
+	unsigned char *p = crow + 3 * i;
+	p[0] = (unsigned char) (rgba[2] * src + p[0] * (1.0f - alpha) + 0.5f);
+	p[1] = (unsigned char) (rgba[1] * src + p[1] * (1.0f - alpha) + 0.5f);
+	p[2] = (unsigned char) (rgba[0] * src + p[2] * (1.0f - alpha) + 0.5f);
+	drow[i] = zb[i];
+      }
+    }
+  }
+}
+
+/*!
+ * @brief  モデルを行列ごとに画像の上に描く
+ *
+ * 行列ごとの頂点変換と三角形の準備，タイルの行ごとの振り分け，
+ * タイルごとの塗りつぶしをそれぞれ並列に行う．三角形は行列の順，
+ * その中では描画リスト（不透明な材質が先）の順に塗る．
+ * 詳細度は元のメッシュ（段階0）だけを使う．
+ *
+ * @param[in]     model     モデル
+ * @param[in]     matrices  モデルビュー行列（列優先で16個ずつ）
+ * @param[in]     count     行列の数
+ * @param[in,out] image     カメラ画像（CV_8UC3, BGR）．この上に描く
+ */
+void SoftwareRenderer::Render (MQO_MODEL model, const float *matrices, int count, cv::Mat &image)
+{
+  triangleCount = 0;
+  if (model == NULL || matrices == NULL || count <= 0) return;
+  if (image.empty () || image.type () != CV_8UC3 || frustum[4] <= 0.0) return;
+  if (tileSize < 8) tileSize = 8;
+
+  width  = image.cols;
+  height = image.rows;
+  tilesX = (width  + tileSize - 1) / tileSize;
+  tilesY = (height + tileSize - 1) / tileSize;
+  depth.create (height, width, CV_32F);
+  depth.setTo (cv::Scalar (1.0));
+
+  // 描画リストの材質（テクスチャの画像はここで1度だけ探す）
+  materials.clear ();
+  for (int i = 0; i < model->drawnum; i++) {
+    const MQO_INNER_OBJECT *obj = model->drawlist[i].obj;
+    const MQO_MATERIAL *mat = model->drawlist[i].mat;
+    if (!obj->isVisible || mat->datanum <= 0 || mat->index == NULL) continue;
+    Material m;
+    m.mat = mat;
+    m.texSize = 0;
+    m.texture = mat->isUseTexture ? mqoGetTextureImage (mat->texture_id, &m.texSize) : NULL;
+    for (int k = 0; k < 4; k++) m.color[k] = mat->color[k];
+    materials.push_back (m);
+  }
+
+  // 行列ごとに頂点を変換して三角形を準備する
+  if ((int) instances.size () < count) instances.resize (count);
+  cv::parallel_for_ (cv::Range (0, count), [&](const cv::Range& range) {
+      for (int k = range.start; k < range.end; k++) {
+	Instance &inst = instances[k];
+	inst.triangles.clear ();
+	const float *M = matrices + 16 * k;
+	if (!mqoIsModelVisible (model, M)) continue;
+	for (int j = 0; j < (int) materials.size (); j++) {
+	  const MQO_MATERIAL *mat = materials[j].mat;
+	  Transform (mat, M, inst.vertices);
+	  const Vertex *v = inst.vertices.data ();
+	  const int first = mat->lodoffset[0], num = mat->lodcount[0];
+	  Triangle tri;
+	  for (int i = 0; i + 2 < num; i += 3) {
+	    unsigned int i0, i1, i2;
+	    if (mat->indexType == GL_UNSIGNED_SHORT) {
+	      const GLushort *idx = (const GLushort *) mat->index + first + i;
+	      i0 = idx[0]; i1 = idx[1]; i2 = idx[2];
+	    } else {
+	      const GLuint *idx = (const GLuint *) mat->index + first + i;
+	      i0 = idx[0]; i1 = idx[1]; i2 = idx[2];
+	    }
+	    if (Setup (v[i0], v[i1], v[i2], j, tri)) inst.triangles.push_back (tri);
+	  }
+	}
+      }
+    });
+
+  // タイルへの振り分け（タイルの行ごとに並列，描画順を保つ）
+  bins.resize (tilesX * tilesY);
+  cv::parallel_for_ (cv::Range (0, tilesY), [&](const cv::Range& range) {
+      for (int ty = range.start; ty < range.end; ty++) {
+	const int Y0 = ty * tileSize, Y1 = Y0 + tileSize - 1;
+	for (int tx = 0; tx < tilesX; tx++) bins[ty * tilesX + tx].clear ();
+	for (int k = 0; k < count; k++) {
+	  const std::vector<Triangle> &tris = instances[k].triangles;
+	  for (size_t i = 0; i < tris.size (); i++) {
+	    const Triangle &t = tris[i];
+	    if (t.maxY < Y0 || t.minY > Y1) continue;
+	    for (int tx = t.minX / tileSize; tx <= t.maxX / tileSize; tx++) {
+	      bins[ty * tilesX + tx].push_back (&t);
+	    }
+	  }
+	}
+      }
+    });
+
+  // タイルごとに塗る
+  cv::parallel_for_ (cv::Range (0, tilesX * tilesY), [&](const cv::Range& range) {
+      for (int tile = range.start; tile < range.end; tile++) {
+	RasterizeTile (tile, image);
+      }
+    });
+
+  for (int k = 0; k < count; k++) triangleCount += instances[k].triangles.size ();
+}
@@ -0,0 +1,94 @@
+/*!
+ * @file	software_renderer.h
+ * @brief	Metasequoia モデルの CPU による描画クラス
+ */
+#pragma once
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "GLMetaseq.h"
+
+/*!
+ * @class  Metasequoia モデルの CPU による描画クラス
+ * @brief　GLMetaseq の頂点配列とインデックス配列をそのまま使い，
+ *         カメラ画像（BGR）の上にモデルを深度バッファ付きで描く．
+ *         OpenGL のコンテキストがなくても動くので，画面のない環境での
+ *         合成や描画の処理時間の計測に使う．
+ *
+ *         画面をタイルに分け，三角形をタイルごとに振り分けてから
+ *         タイル単位で並列に塗る．行ごとの辺関数と深度の判定は SIMD で，
+ *         覆われた画素の色の計算だけをスカラーで行う．GL の描画と同じく
+ *         照明なし（材質の色×テクスチャ），常に半透明合成，深度判定は
+ *         GL_LESS で，裏面も描く．テクスチャは mqoInit を GL の
+ *         コンテキストなしで呼んだ時だけ使える（ない時は材質の色で塗る）．
+ */
+class SoftwareRenderer
+{
+ public:
+  // コンストラクタ
+  SoftwareRenderer ();
+
+  // 視錐台の設定（glFrustum と同じ引数．mqoSetFrustum も呼ぶ）
+  void SetFrustum (double left, double right, double bottom, double top,
+		   double nearDist, double farDist);
+
+  // モデルを行列（列優先で16個ずつ）ごとに画像（CV_8UC3）の上に描く
+  void Render (MQO_MODEL model, const float *matrices, int count, cv::Mat &image);
+
+  int   tileSize;       // タイルの一辺 [画素]
+  bool  lighting;       // 頂点ごとの拡散光の照明を行うかどうか（GL の描画にはない）
+  float light[3];       // 光源の方向（視点座標系，正規化済み）
+  float ambient;        // 環境光の割合
+  size_t triangleCount; // 最後の Render で塗った三角形の数
+
+ private:
+  // 画面座標に変換した頂点
+  struct Vertex {
+    float x, y;         // 画像の座標（1行目が上）
+    float z;            // 深度 [0, 1]
+    float invw;         // 1/w
+    float u, v;         // テクスチャ座標
+    float shade;        // 照明の明るさ
+    bool  clipped;      // 前方クリップ面より手前かどうか
+  };
+
+  // 描画する材質（描画リストの順）
+  struct Material {
+    const MQO_MATERIAL *mat;
+    const GLubyte *texture; // テクスチャの画像（RGBA），ない時は NULL
+    int   texSize;
+    float color[4];
+  };
+
+  // 塗る準備をした三角形
+  struct Triangle {
+    int   minX, minY, maxX, maxY; // 画素の範囲（両端を含む）
+    float ex[3], ey[3], e0[3];    // 辺関数 ex*x + ey*y + e0（内側が正）
+    int   topLeft[3];             // 辺上の画素を含むかどうか
+    float ox, oy;                 // 平面の原点（頂点0）
+    float z[3];                   // 深度の平面（原点の値, x 方向, y 方向）
+    float invw[3];                // 1/w の平面
+    float uw[3], vw[3];           // u/w, v/w の平面
+    float sw[3];                  // shade/w の平面
+    int   material;
+  };
+
+  // 行列ごとの作業領域
+  struct Instance {
+    std::vector<Vertex>   vertices;
+    std::vector<Triangle> triangles;
+  };
+
+  void Transform (const MQO_MATERIAL *mat, const float *M, std::vector<Vertex> &vertices) const;
+  bool Setup (const Vertex &a, const Vertex &b, const Vertex &c, int material,
+	      Triangle &tri) const;
+  void RasterizeTile (int tile, cv::Mat &image);
+
+  double frustum[6];    // left, right, bottom, top, near, far
+  int    width, height; // 描画中の画像の大きさ
+  int    tilesX, tilesY;
+  cv::Mat depth;        // 深度バッファ（CV_32F）
+  std::vector<Material> materials;
+  std::vector<Instance> instances;
+  std::vector<std::vector<const Triangle *> > bins; // タイルごとの三角形（描画順）
+};